@@ -0,0 +1,372 @@
+#pragma once
+
+#include "Cursor.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @file ChangePoller.h
+ * @brief Storage 增量轮询接口
+ *
+ * 按消费者记录水位（已见过的最大 rowid，以及已见过的最新 updated_at 和对应 rowid），
+ * 每次轮询只返回水位之后新插入或被修改的行，轮询代价与变化量成正比而非与表大小成正比。
+ *
+ * - 新插入：rowid > maxRowid，走 rowid 的 B 树
+ * - 被修改：(updated_at, rowid) > (updatedAt, updatedRowid) 且 rowid <= maxRowid，
+ *   走构造时自动创建的 updated_at 索引。本次轮询刚作为新插入交付、之后未再修改的行
+ *   只推进修改水位，不再作为 Updated 回调
+ *
+ * 水位保存在同一数据库的 storage_watermark 表中，Commit() 之后才持久化，
+ * 处理失败时不 Commit 即可在下次重新收到（至少一次语义，消费者需幂等）。
+ *
+ * 使用示例：
+ * @code
+ * Storage::ChangePoller<ModelSample> poller(handle, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::updated_at), "indexer");
+ * poller.Poll([](const ModelSample &model, Storage::ChangeKind kind) {
+ *     ...
+ *     return true;
+ * });
+ * poller.Commit();
+ * @endcode
+ *
+ * @note 写入方修改行时须把 updated_at 设为单调不减的值（如当前时间），
+ *       文本时间须为可按字典序比较的固定格式，如 "2026-01-01 00:00:00.000"
+ * @note 新消费者从 rowid 0 开始，并以当前最新的 updated_at 作为初始修改水位，
+ *       已有的行都只作为 Inserted 收到一次
+ * @note 一次插入只收到一次 Inserted。例外是修改阶段达到 limit、修改水位还没越过这些新行时，
+ *       它们会在之后的轮询中再作为 Updated 收到一次；在新插入阶段与修改阶段之间被修改的新行也会作为 Updated 收到
+ */
+
+namespace Storage {
+
+/**
+ * @brief 变化类型
+ */
+enum class ChangeKind {
+    Inserted = 0,  // rowid 大于水位的新行
+    Updated        // 已见过的行，updated_at 晚于水位
+};
+
+/**
+ * @brief 单个消费者在某张表上的水位
+ */
+struct Watermark {
+    int64_t maxRowid = 0;        // 已见过的最大 rowid
+    WCDB::Value updatedAt;       // 已见过的最新 updated_at，NULL 表示从头开始
+    int64_t updatedRowid = 0;    // updatedAt 相同时用于排序的 rowid
+};
+
+// 保存水位的表名
+const std::string TABLE_NAME_WATERMARK = "storage_watermark";
+
+/**
+ * @brief 增量轮询器
+ * @tparam ObjectType 已声明 WCDB ORM 的模型类型
+ * @note 与 Cursor 一样只能在 handle 所属线程使用，存活期间 handle 不能 invalidate
+ */
+template<class ObjectType>
+class ChangePoller {
+public:
+    /**
+     * @brief 创建所需的索引和水位表，并加载该消费者的水位
+     * @param handle 使用的 Handle，生命周期须长于轮询器
+     * @param table 被轮询的表
+     * @param updatedAt 修改时间字段
+     * @param consumer 消费者名称，不同消费者的水位相互独立
+     */
+    ChangePoller(WCDB::Handle& handle, const std::string& table, const WCDB::Field& updatedAt,
+                 const std::string& consumer)
+    : m_handle(handle), m_table(table), m_consumer(consumer), m_resultFields(ObjectType::allFields())
+    {
+        m_valid = CreateSchema(updatedAt) && Prepare(updatedAt) && Load();
+    }
+
+    ~ChangePoller()
+    {
+        for (auto* statement : { m_inserted.get(), m_updated.get(), m_updatedFromStart.get(), m_latest.get(), m_load.get(), m_save.get() }) {
+            if (statement != nullptr) {
+                statement->reset();
+            }
+        }
+    }
+
+    ChangePoller(const ChangePoller&) = delete;
+    ChangePoller& operator=(const ChangePoller&) = delete;
+
+    /**
+     * @brief 初始化是否成功
+     */
+    bool IsValid() const { return m_valid; }
+
+    /**
+     * @brief 取出水位之后的变化并推进内存中的水位
+     * @param onRow 每行回调，对象在回调返回后被复用；返回 false 时停止，水位停在上一行
+     * @param limit 新插入和被修改两类各自最多扫描的行数（修改阶段含跳过的新行），剩余的在下次轮询返回
+     * @return 回调的行数，出错时返回 -1
+     */
+    int64_t Poll(const std::function<bool(const ObjectType&, ChangeKind)>& onRow, int limit = 1000)
+    {
+        if (!m_valid) {
+            return -1;
+        }
+        int64_t delivered = 0;
+        bool stopped = false;
+        // 本次作为新插入交付的行及交付时的 updated_at，修改阶段据此跳过
+        m_deliveredInserts.clear();
+
+        // 新插入的行
+        m_inserted->reset();
+        m_inserted->bindInteger(m_watermark.maxRowid, 1);
+        m_inserted->bindInteger(limit, 2);
+        while (!stopped) {
+            if (!m_inserted->step()) {
+                m_inserted->reset();
+                return -1;
+            }
+            if (m_inserted->done()) {
+                break;
+            }
+            ExtractInto(*m_inserted, m_resultFields, m_current);
+            int64_t rowid = m_inserted->getInteger(m_rowidIndex);
+            if (!onRow(m_current, ChangeKind::Inserted)) {
+                stopped = true;
+                break;
+            }
+            m_watermark.maxRowid = rowid;
+            m_deliveredInserts.emplace(rowid, m_inserted->getValue(m_updatedIndex));
+            ++delivered;
+        }
+        m_inserted->reset();
+
+        // 已见过但被修改的行。?3 绑定推进后的 maxRowid，让修改水位越过刚交付的新行，
+        // 否则它们会在下次轮询作为 Updated 再收到一次
+        if (!stopped) {
+            bool fromStart = m_watermark.updatedAt.isNull();
+            WCDB::PreparedStatement& statement = fromStart ? *m_updatedFromStart : *m_updated;
+            statement.reset();
+            if (!fromStart) {
+                statement.bindValue(m_watermark.updatedAt, 1);
+                statement.bindInteger(m_watermark.updatedRowid, 2);
+            }
+            statement.bindInteger(m_watermark.maxRowid, 3);
+            statement.bindInteger(limit, 4);
+            while (true) {
+                if (!statement.step()) {
+                    statement.reset();
+                    return -1;
+                }
+                if (statement.done()) {
+                    break;
+                }
+                WCDB::Value updated = statement.getValue(m_updatedIndex);
+                int64_t rowid = statement.getInteger(m_rowidIndex);
+                auto inserted = m_deliveredInserts.find(rowid);
+                bool seen = inserted != m_deliveredInserts.end() && inserted->second == updated;
+                if (!seen) {
+                    ExtractInto(statement, m_resultFields, m_current);
+                    if (!onRow(m_current, ChangeKind::Updated)) {
+                        break;
+                    }
+                    ++delivered;
+                }
+                m_watermark.updatedAt = updated;
+                m_watermark.updatedRowid = rowid;
+            }
+            statement.reset();
+        }
+        return delivered;
+    }
+
+    /**
+     * @brief 持久化当前水位
+     * @return 成功返回 true
+     */
+    bool Commit()
+    {
+        if (!m_valid) {
+            return false;
+        }
+        m_save->reset();
+        m_save->bindText(m_consumer, 1);
+        m_save->bindText(m_table, 2);
+        m_save->bindInteger(m_watermark.maxRowid, 3);
+        m_save->bindValue(m_watermark.updatedAt, 4);
+        m_save->bindInteger(m_watermark.updatedRowid, 5);
+        bool succeed = m_save->step();
+        m_save->reset();
+        return succeed;
+    }
+
+    /**
+     * @brief 当前（可能尚未持久化的）水位
+     */
+    const Watermark& GetWatermark() const { return m_watermark; }
+
+    /**
+     * @brief 设置水位，如跳过历史数据。需 Commit() 才会持久化
+     */
+    void SetWatermark(const Watermark& watermark) { m_watermark = watermark; }
+
+    /**
+     * @brief 丢弃未持久化的水位，回到上次 Commit() 的位置
+     */
+    bool Rollback() { return m_valid && Load(); }
+
+private:
+    bool CreateSchema(const WCDB::Field& updatedAt)
+    {
+        WCDB::StatementCreateIndex index;
+        index.createIndex(m_table + "_" + updatedAt.syntax().name.data() + "_poll_index")
+        .ifNotExists()
+        .table(m_table)
+        .indexed(updatedAt);
+        if (!m_handle.execute(index)) {
+            return false;
+        }
+
+        // updated_value 不声明类型，文本或整数时间都按原类型保存
+        WCDB::StatementCreateTable create;
+        create.createTable(TABLE_NAME_WATERMARK)
+        .ifNotExists()
+        .define(WCDB::ColumnDef(WCDB::Column("consumer"), WCDB::ColumnType::Text))
+        .define(WCDB::ColumnDef(WCDB::Column("table_name"), WCDB::ColumnType::Text))
+        .define(WCDB::ColumnDef(WCDB::Column("max_rowid"), WCDB::ColumnType::Integer))
+        .define(WCDB::ColumnDef(WCDB::Column("updated_value")))
+        .define(WCDB::ColumnDef(WCDB::Column("updated_rowid"), WCDB::ColumnType::Integer))
+        .constraint(WCDB::TableConstraint().primaryKey().indexed(WCDB::Column("consumer")).indexed(WCDB::Column("table_name")));
+        return m_handle.execute(create);
+    }
+
+    bool Prepare(const WCDB::Field& updatedAt)
+    {
+        // 结果列为模型的所有字段，再追加 rowid 和 updated_at
+        WCDB::ResultColumns columns;
+        for (const WCDB::Field& field : ObjectType::allFields()) {
+            columns.push_back(field);
+        }
+        m_rowidIndex = (int) columns.size();
+        columns.push_back(WCDB::Column::rowid());
+        m_updatedIndex = (int) columns.size();
+        columns.push_back(updatedAt);
+
+        WCDB::StatementSelect inserted;
+        inserted.select(columns)
+        .from(m_table)
+        .where(WCDB::Column::rowid() > WCDB::BindParameter(1))
+        .order(WCDB::Column::rowid().asOrder(WCDB::Order::ASC))
+        .limit(WCDB::BindParameter(2));
+
+        // updated_at >= ?1 可以直接在索引上做范围扫描，再用 rowid 排除 updated_at 相同且已见过的行
+        WCDB::StatementSelect updated;
+        updated.select(columns)
+        .from(m_table)
+        .where(updatedAt >= WCDB::BindParameter(1)
+               && (updatedAt > WCDB::BindParameter(1) || WCDB::Column::rowid() > WCDB::BindParameter(2))
+               && WCDB::Column::rowid() <= WCDB::BindParameter(3))
+        .orders({ updatedAt.asOrder(WCDB::Order::ASC), WCDB::Column::rowid().asOrder(WCDB::Order::ASC) })
+        .limit(WCDB::BindParameter(4));
+
+        // 水位为 NULL（表中还没有任何 updated_at）时与 NULL 比较恒不成立，单独准备一条语句
+        WCDB::StatementSelect updatedFromStart;
+        updatedFromStart.select(columns)
+        .from(m_table)
+        .where(updatedAt.notNull() && WCDB::Column::rowid() <= WCDB::BindParameter(3))
+        .orders({ updatedAt.asOrder(WCDB::Order::ASC), WCDB::Column::rowid().asOrder(WCDB::Order::ASC) })
+        .limit(WCDB::BindParameter(4));
+
+        // 新消费者的初始水位：当前最新的 (updated_at, rowid)，在此之前的修改都会随新插入一起读到
+        WCDB::StatementSelect latest;
+        latest.select({ updatedAt, WCDB::Column::rowid() })
+        .from(m_table)
+        .where(updatedAt.notNull())
+        .orders({ updatedAt.asOrder(WCDB::Order::DESC), WCDB::Column::rowid().asOrder(WCDB::Order::DESC) })
+        .limit(1);
+
+        WCDB::StatementSelect load;
+        load.select({ WCDB::Column("max_rowid"), WCDB::Column("updated_value"), WCDB::Column("updated_rowid") })
+        .from(TABLE_NAME_WATERMARK)
+        .where(WCDB::Column("consumer") == WCDB::BindParameter(1)
+               && WCDB::Column("table_name") == WCDB::BindParameter(2));
+
+        WCDB::StatementInsert save;
+        save.insertIntoTable(TABLE_NAME_WATERMARK)
+        .orReplace()
+        .columns({ WCDB::Column("consumer"), WCDB::Column("table_name"), WCDB::Column("max_rowid"),
+                   WCDB::Column("updated_value"), WCDB::Column("updated_rowid") })
+        .values(WCDB::BindParameter::bindParameters(5));
+
+        m_inserted = PrepareStatement(inserted);
+        m_updated = PrepareStatement(updated);
+        m_updatedFromStart = PrepareStatement(updatedFromStart);
+        m_latest = PrepareStatement(latest);
+        m_load = PrepareStatement(load);
+        m_save = PrepareStatement(save);
+        return m_inserted && m_updated && m_updatedFromStart && m_latest && m_load && m_save;
+    }
+
+    bool Load()
+    {
+        m_load->reset();
+        m_load->bindText(m_consumer, 1);
+        m_load->bindText(m_table, 2);
+        if (!m_load->step()) {
+            m_load->reset();
+            return false;
+        }
+        m_watermark = Watermark();
+        bool found = !m_load->done();
+        if (found) {
+            m_watermark.maxRowid = m_load->getInteger(0);
+            m_watermark.updatedAt = m_load->getValue(1);
+            m_watermark.updatedRowid = m_load->getInteger(2);
+        }
+        m_load->reset();
+        if (found) {
+            return true;
+        }
+
+        m_latest->reset();
+        if (!m_latest->step()) {
+            m_latest->reset();
+            return false;
+        }
+        if (!m_latest->done()) {
+            m_watermark.updatedAt = m_latest->getValue(0);
+            m_watermark.updatedRowid = m_latest->getInteger(1);
+        }
+        m_latest->reset();
+        return true;
+    }
+
+    std::unique_ptr<WCDB::PreparedStatement> PrepareStatement(const WCDB::Statement& statement)
+    {
+        auto prepared = m_handle.getOrCreatePreparedStatement(statement);
+        if (!prepared.hasValue()) {
+            return nullptr;
+        }
+        return std::unique_ptr<WCDB::PreparedStatement>(
+        new WCDB::PreparedStatement(std::move(prepared.value())));
+    }
+
+    WCDB::Handle& m_handle;
+    std::string m_table;
+    std::string m_consumer;
+    WCDB::ResultFields m_resultFields;
+    std::unique_ptr<WCDB::PreparedStatement> m_inserted;
+    std::unique_ptr<WCDB::PreparedStatement> m_updated;
+    std::unique_ptr<WCDB::PreparedStatement> m_updatedFromStart;
+    std::unique_ptr<WCDB::PreparedStatement> m_latest;
+    std::unique_ptr<WCDB::PreparedStatement> m_load;
+    std::unique_ptr<WCDB::PreparedStatement> m_save;
+    Watermark m_watermark;
+    std::unordered_map<int64_t, WCDB::Value> m_deliveredInserts;
+    ObjectType m_current{};
+    int m_rowidIndex = 0;
+    int m_updatedIndex = 0;
+    bool m_valid = false;
+};
+
+} // namespace Storage
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <cstdint>
+
+/**
+ * @file Checkpoint.h
+ * @brief Storage WAL 检查点调度
+ *
+ * WCDB 的自动检查点在 WAL 达到阈值时立即执行，一次把积累的所有页写回数据库文件，
+ * 与对延迟敏感的写入撞在一起时会拉长提交耗时。CheckpointScheduler 接管检查点：
+ *
+ * - 空闲时执行：后台线程通过 PRAGMA data_version 感知其他连接的提交，
+ *   连续 idleMillis 没有提交后执行 PASSIVE 检查点；一直没有空闲时最多推迟 maxDeferMillis
+ * - I/O 预算：按令牌桶限制检查点写回的字节速率，超出预算时推迟下一次检查点
+ * - 升级：WAL 文件超过 truncateWalBytes，或连续多次 PASSIVE 检查点因读事务未能写完时，
+ *   执行 TRUNCATE 检查点（会短暂阻塞写入），并把 WAL 文件截断为 0
+ * - 指标：检查点次数、耗时、写回的帧数，WAL 文件大小、峰值和增长速率
+ *
+ * 使用示例：
+ * @code
+ * Storage::CheckpointOptions options;
+ * options.maxBytesPerSecond = 8 << 20;
+ * Storage::CheckpointScheduler scheduler(db, options);   // 析构时恢复构造前的自动检查点状态
+ * ...
+ * Storage::CheckpointStats stats = scheduler.GetStats();
+ * @endcode
+ *
+ * 检查点的归属：同一数据库同一时间只由一方负责检查点
+ * - 默认由 WCDB 的自动检查点负责
+ * - ApplyProfile 设置了 walAutocheckpoint 时由 SQLite 按页数阈值负责，WCDB 的自动检查点关闭
+ * - CheckpointScheduler 存在期间由调度器负责。与设置了 walAutocheckpoint 的配置同时使用时，
+ *   SQLite 仍会在阈值处检查点，应把 walAutocheckpoint 设为 0
+ * 关闭 WCDB 自动检查点的组件都通过 DisableAutoCheckpoint / RestoreAutoCheckpoint 登记，
+ * 只有全部归还后才重新开启，任何一方退出都不会替仍在使用的一方打开
+ *
+ * @note 检查点每次写回的页数由 SQLite 决定，无法中途暂停；预算按检查点之间的间隔控制平均速率，
+ *       空闲阈值越小、检查点越频繁，单次写回量越小
+ * @note 需链接 libstorage
+ */
+
+namespace Storage {
+
+/**
+ * @brief 各数据库（按路径）关闭了 WCDB 自动检查点的组件
+ */
+struct AutoCheckpointOwners {
+    std::mutex mutex;
+    std::map<std::string, std::multiset<std::string>> byPath;
+};
+
+inline AutoCheckpointOwners& GetAutoCheckpointOwners()
+{
+    static AutoCheckpointOwners owners;
+    return owners;
+}
+
+/**
+ * @brief 以 owner 的名义关闭数据库的 WCDB 自动检查点
+ * @param owner 组件名称，同一组件可以登记多次，需对应次数的 RestoreAutoCheckpoint
+ */
+inline void DisableAutoCheckpoint(WCDB::Database& database, const std::string& owner)
+{
+    AutoCheckpointOwners& owners = GetAutoCheckpointOwners();
+    std::lock_guard<std::mutex> lock(owners.mutex);
+    const WCDB::StringView& path = database.getPath();
+    owners.byPath[std::string(path.data(), path.length())].insert(owner);
+    database.enableAutoCheckpoint(false);
+}
+
+/**
+ * @brief 归还 owner 之前的登记，没有其他组件登记时重新开启 WCDB 的自动检查点
+ * @note owner 没有登记过时不做任何事，不会打开其他组件关闭的自动检查点
+ */
+inline void RestoreAutoCheckpoint(WCDB::Database& database, const std::string& owner)
+{
+    AutoCheckpointOwners& owners = GetAutoCheckpointOwners();
+    std::lock_guard<std::mutex> lock(owners.mutex);
+    const WCDB::StringView& path = database.getPath();
+    auto entry = owners.byPath.find(std::string(path.data(), path.length()));
+    if (entry == owners.byPath.end()) {
+        return;
+    }
+    auto held = entry->second.find(owner);
+    if (held == entry->second.end()) {
+        return;
+    }
+    entry->second.erase(held);
+    if (entry->second.empty()) {
+        owners.byPath.erase(entry);
+        database.enableAutoCheckpoint(true);
+    }
+}
+
+/**
+ * @brief owner 是否登记过关闭数据库的 WCDB 自动检查点
+ */
+inline bool HoldsAutoCheckpoint(WCDB::Database& database, const std::string& owner)
+{
+    AutoCheckpointOwners& owners = GetAutoCheckpointOwners();
+    std::lock_guard<std::mutex> lock(owners.mutex);
+    const WCDB::StringView& path = database.getPath();
+    auto entry = owners.byPath.find(std::string(path.data(), path.length()));
+    return entry != owners.byPath.end() && entry->second.count(owner) > 0;
+}
+
+/**
+ * @brief 检查点调度选项
+ */
+struct CheckpointOptions {
+    unsigned pollIntervalMillis = 50;           // 检查提交和 WAL 大小的间隔
+    unsigned idleMillis = 200;                  // 连续多久没有提交视为空闲
+    unsigned maxDeferMillis = 5000;             // 有未写回的提交时，最多推迟多久就不再等待空闲
+    uint64_t maxBytesPerSecond = 16ULL << 20;   // 检查点写回速率上限，0 表示不限制
+    int64_t truncateWalBytes = 64LL << 20;      // WAL 文件超过该大小时执行 TRUNCATE 检查点
+    unsigned truncateAfterBusy = 8;             // 连续多少次 PASSIVE 检查点未能写完后执行 TRUNCATE 检查点
+};
+
+/**
+ * @brief 检查点统计
+ */
+struct CheckpointStats {
+    uint64_t passiveCheckpoints = 0;     // PASSIVE 检查点次数
+    uint64_t truncateCheckpoints = 0;    // TRUNCATE 检查点次数
+    uint64_t incomplete = 0;             // 因读事务或锁未能写完全部帧的次数
+    uint64_t failed = 0;                 // 执行出错的次数
+    uint64_t budgetDeferrals = 0;        // 因 I/O 预算不足推迟的次数
+    uint64_t checkpointedFrames = 0;     // 写回数据库文件的帧数（估算）
+    uint64_t appendedFrames = 0;         // 检查点之间 WAL 新增的帧数（估算）
+    double lastDurationMillis = 0;       // 最近一次检查点耗时
+    double maxDurationMillis = 0;        // 最长一次检查点耗时
+    double totalDurationMillis = 0;      // 检查点总耗时
+    int64_t walBytes = 0;                // 当前 WAL 文件大小
+    int64_t peakWalBytes = 0;            // WAL 文件大小峰值
+    double walGrowthBytesPerSecond = 0;  // WAL 写入速率，按检查点之间新增的帧数平滑估算
+    int64_t backlogFrames = 0;           // 最近一次检查点后仍未写回的帧数
+};
+
+/**
+ * @brief WAL 检查点调度器
+ * @note 构造时关闭 WCDB 的自动检查点，析构时停止后台线程并恢复构造前的状态
+ * @note 线程安全
+ */
+class CheckpointScheduler {
+public:
+    /**
+     * @param database 数据库对象，须为 WAL 模式，生命周期须长于 CheckpointScheduler
+     */
+    CheckpointScheduler(WCDB::Database& database, const CheckpointOptions& options = CheckpointOptions());
+
+    ~CheckpointScheduler();
+
+    CheckpointScheduler(const CheckpointScheduler&) = delete;
+    CheckpointScheduler& operator=(const CheckpointScheduler&) = delete;
+
+    /**
+     * @brief 在调用线程立即执行一次检查点，不受空闲和预算限制
+     * @param truncate true 时执行 TRUNCATE 检查点，否则执行 PASSIVE 检查点
+     * @return 写回了全部帧返回 true
+     */
+    bool CheckpointNow(bool truncate = false);
+
+    /**
+     * @brief 停止后台线程，之后不再自动执行检查点
+     */
+    void Stop();
+
+    /**
+     * @brief 获取统计数据
+     */
+    CheckpointStats GetStats() const;
+
+    class Impl;
+
+private:
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Storage
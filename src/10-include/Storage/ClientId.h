@@ -0,0 +1,65 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include "Utility/IdGenerator.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file ClientId.h
+ * @brief Storage 客户端分配主键
+ *
+ * 模型的 ORM 实现使用 WCDB_CPP_PRIMARY(id)（而非 WCDB_CPP_PRIMARY_AUTO_INCREMENT），
+ * id 列成为 INTEGER PRIMARY KEY 即 rowid 别名；插入前由 Utility::IdGenerator 生成 id，
+ * SQLite 不再维护 sqlite_sequence。ID 在插入前已知，可以直接交给 WriteBehindQueue 等异步路径，
+ * 之后的关联写入也不必等待 lastInsertedRowID。
+ *
+ * 使用示例：
+ * @code
+ * // ORM 实现
+ * WCDB_CPP_ORM_IMPLEMENTATION_BEGIN(ModelSampleKeyed);
+ * ...
+ * WCDB_CPP_PRIMARY(id);
+ * WCDB_CPP_ORM_IMPLEMENTATION_END;
+ *
+ * Storage::AssignIds(models, &ModelSampleKeyed::id);
+ * db.insertObjects<ModelSampleKeyed>(models, TABLE_NAME_SAMPLE_KEYED);
+ * @endcode
+ *
+ * @note id 成员须为 64 位整数
+ */
+
+namespace Storage {
+
+/**
+ * @brief 为单个对象分配 ID
+ * @param object 对象，isAutoIncrement 会被置为 false
+ * @param idMember 主键成员指针，如 &ModelSampleKeyed::id
+ * @param generator ID 生成器，默认为进程内共享的生成器
+ * @return 分配的 ID
+ */
+template<class ObjectType>
+int64_t AssignId(ObjectType& object, int64_t ObjectType::*idMember,
+                 Utility::IdGenerator& generator = Utility::IdGenerator::Default())
+{
+    object.*idMember = generator.Next();
+    object.isAutoIncrement = false;
+    return object.*idMember;
+}
+
+/**
+ * @brief 为一批对象分配连续递增的 ID，顺序与数组顺序一致
+ */
+template<class ObjectType>
+void AssignIds(std::vector<ObjectType>& objects, int64_t ObjectType::*idMember,
+               Utility::IdGenerator& generator = Utility::IdGenerator::Default())
+{
+    std::vector<int64_t> ids(objects.size());
+    generator.NextBatch(ids.data(), ids.size());
+    for (size_t i = 0; i < objects.size(); i++) {
+        objects[i].*idMember = ids[i];
+        objects[i].isAutoIncrement = false;
+    }
+}
+
+} // namespace Storage
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file Columnar.h
+ * @brief Storage 列式结果读取
+ *
+ * 统计类查询通常只对几列数值做聚合，先物化 std::vector<ModelSample> 再逐个对象取字段，
+ * 每个对象都带着用不到的字符串，缓存利用率很低。ColumnarCursor 按批把结果写入列数组：
+ *
+ * - 整数列写入连续的 int64_t 数组，浮点列写入连续的 double 数组，可直接交给 Utility::Aggregate
+ * - 文本列写入同一块字符缓冲区，按偏移访问，每行不单独分配内存
+ * - 每批复用同一个 ColumnBatch，容量达到批大小后不再分配
+ *
+ * 使用示例：
+ * @code
+ * Storage::ColumnarCursor cursor(handle,
+ *     Storage::SelectFields(TABLE_NAME_SAMPLE, { WCDB_FIELD(ModelSample::age) }),
+ *     { Storage::ColumnKind::Integer });
+ * while (cursor.NextBatch()) {
+ *     const Storage::ColumnBatch &batch = cursor.Batch();
+ *     auto summary = Utility::Aggregate::Summarize(batch.Integers(0), batch.RowCount());
+ * }
+ * @endcode
+ *
+ * @note NULL 在数值列中记为 0、在文本列中记为空串，并通过 IsNull / NullCount 标记
+ */
+
+namespace Storage {
+
+/**
+ * @brief 列的存储类型，读取时按该类型转换 SQLite 的值
+ */
+enum class ColumnKind {
+    Integer = 0,
+    Double,
+    Text
+};
+
+/**
+ * @brief 一批结果的列式存储
+ */
+class ColumnBatch {
+public:
+    /**
+     * @param kinds 各结果列的存储类型，个数须与查询的结果列一致
+     */
+    explicit ColumnBatch(const std::vector<ColumnKind>& kinds = std::vector<ColumnKind>())
+    {
+        m_columns.resize(kinds.size());
+        for (size_t i = 0; i < kinds.size(); i++) {
+            m_columns[i].kind = kinds[i];
+            if (kinds[i] == ColumnKind::Text) {
+                m_columns[i].offsets.push_back(0);
+            }
+        }
+    }
+
+    size_t RowCount() const { return m_rowCount; }
+
+    size_t ColumnCount() const { return m_columns.size(); }
+
+    ColumnKind Kind(int column) const { return m_columns[column].kind; }
+
+    /**
+     * @brief 整数列的连续数组，长度为 RowCount()；非整数列返回 nullptr
+     */
+    const int64_t* Integers(int column) const
+    {
+        const Column& target = m_columns[column];
+        return target.kind == ColumnKind::Integer ? target.integers.data() : nullptr;
+    }
+
+    /**
+     * @brief 浮点列的连续数组，长度为 RowCount()；非浮点列返回 nullptr
+     */
+    const double* Doubles(int column) const
+    {
+        const Column& target = m_columns[column];
+        return target.kind == ColumnKind::Double ? target.doubles.data() : nullptr;
+    }
+
+    /**
+     * @brief 文本列第 row 行，指向批内缓冲区，下一批或 Clear() 后失效
+     */
+    WCDB::UnsafeStringView Text(int column, size_t row) const
+    {
+        const Column& target = m_columns[column];
+        size_t begin = target.offsets[row];
+        return WCDB::UnsafeStringView(target.arena.data() + begin, target.offsets[row + 1] - begin);
+    }
+
+    bool IsNull(int column, size_t row) const { return m_columns[column].nulls[row] != 0; }
+
+    /**
+     * @brief 该列的 NULL 个数
+     */
+    size_t NullCount(int column) const { return m_columns[column].nullCount; }
+
+    /**
+     * @brief 清空数据，保留已分配的容量
+     */
+    void Clear()
+    {
+        for (Column& column : m_columns) {
+            column.integers.clear();
+            column.doubles.clear();
+            column.arena.clear();
+            column.nulls.clear();
+            column.nullCount = 0;
+            if (column.kind == ColumnKind::Text) {
+                column.offsets.resize(1);
+            }
+        }
+        m_rowCount = 0;
+    }
+
+    /**
+     * @brief 预留 rows 行的空间
+     */
+    void Reserve(size_t rows)
+    {
+        for (Column& column : m_columns) {
+            switch (column.kind) {
+            case ColumnKind::Integer:
+                column.integers.reserve(rows);
+                break;
+            case ColumnKind::Double:
+                column.doubles.reserve(rows);
+                break;
+            case ColumnKind::Text:
+                column.offsets.reserve(rows + 1);
+                break;
+            }
+            column.nulls.reserve(rows);
+        }
+    }
+
+    /**
+     * @brief 把语句的当前行追加到各列
+     */
+    void AppendRow(WCDB::StatementOperation& statement)
+    {
+        int index = 0;
+        for (Column& column : m_columns) {
+            bool isNull = statement.getType(index) == WCDB::ColumnType::Null;
+            column.nulls.push_back(isNull ? 1 : 0);
+            column.nullCount += isNull ? 1 : 0;
+            switch (column.kind) {
+            case ColumnKind::Integer:
+                column.integers.push_back(isNull ? 0 : statement.getInteger(index));
+                break;
+            case ColumnKind::Double:
+                column.doubles.push_back(isNull ? 0 : statement.getDouble(index));
+                break;
+            case ColumnKind::Text:
+                if (!isNull) {
+                    WCDB::UnsafeStringView text = statement.getText(index);
+                    column.arena.insert(column.arena.end(), text.data(), text.data() + text.length());
+                }
+                column.offsets.push_back(column.arena.size());
+                break;
+            }
+            ++index;
+        }
+        ++m_rowCount;
+    }
+
+private:
+    struct Column {
+        ColumnKind kind = ColumnKind::Integer;
+        std::vector<int64_t> integers;
+        std::vector<double> doubles;
+        std::vector<char> arena;       // 文本列的字符数据
+        std::vector<size_t> offsets;   // 文本列第 i 行为 arena[offsets[i], offsets[i + 1])
+        std::vector<uint8_t> nulls;
+        size_t nullCount = 0;
+    };
+
+    std::vector<Column> m_columns;
+    size_t m_rowCount = 0;
+};
+
+/**
+ * @brief 按批读取列式结果的游标
+ * @note 与 Cursor 一样通过 Handle::getOrCreatePreparedStatement 获取语句，使用约束相同
+ */
+class ColumnarCursor {
+public:
+    /**
+     * @param handle 查询使用的 Handle，生命周期须长于游标
+     * @param statement 查询语句
+     * @param kinds 各结果列的存储类型
+     * @param batchSize 每批最多读取的行数
+     */
+    ColumnarCursor(WCDB::Handle& handle, const WCDB::StatementSelect& statement,
+                   const std::vector<ColumnKind>& kinds, size_t batchSize = 4096)
+    : m_batch(kinds), m_batchSize(batchSize > 0 ? batchSize : 1)
+    {
+        auto prepared = handle.getOrCreatePreparedStatement(statement);
+        if (prepared.hasValue()) {
+            m_statement.reset(new WCDB::PreparedStatement(std::move(prepared.value())));
+            m_statement->reset();
+            m_batch.Reserve(m_batchSize);
+        } else {
+            m_failed = true;
+        }
+    }
+
+    ~ColumnarCursor()
+    {
+        if (m_statement) {
+            m_statement->reset();
+        }
+    }
+
+    ColumnarCursor(const ColumnarCursor&) = delete;
+    ColumnarCursor& operator=(const ColumnarCursor&) = delete;
+
+    /**
+     * @brief 读取下一批，覆盖上一批的数据
+     * @return 读到至少一行返回 true；结束或出错返回 false，用 Failed() 区分
+     */
+    bool NextBatch()
+    {
+        m_batch.Clear();
+        if (m_failed || m_done) {
+            return false;
+        }
+        while (m_batch.RowCount() < m_batchSize) {
+            if (!m_statement->step()) {
+                m_failed = true;
+                m_batch.Clear();
+                return false;
+            }
+            if (m_statement->done()) {
+                m_done = true;
+                m_statement->reset();
+                break;
+            }
+            m_batch.AppendRow(*m_statement);
+        }
+        m_position += m_batch.RowCount();
+        return m_batch.RowCount() > 0;
+    }
+
+    /**
+     * @brief 当前批
+     */
+    const ColumnBatch& Batch() const { return m_batch; }
+
+    /**
+     * @brief 已读取的行数
+     */
+    uint64_t Position() const { return m_position; }
+
+    /**
+     * @brief 是否因出错而结束
+     */
+    bool Failed() const { return m_failed; }
+
+private:
+    std::unique_ptr<WCDB::PreparedStatement> m_statement;
+    ColumnBatch m_batch;
+    size_t m_batchSize;
+    uint64_t m_position = 0;
+    bool m_done = false;
+    bool m_failed = false;
+};
+
+/**
+ * @brief 把全部结果读入一个 ColumnBatch
+ * @return 出错时返回空
+ */
+inline WCDB::Optional<ColumnBatch> ReadColumns(WCDB::Handle& handle, const WCDB::StatementSelect& statement,
+                                               const std::vector<ColumnKind>& kinds)
+{
+    auto prepared = handle.getOrCreatePreparedStatement(statement);
+    if (!prepared.hasValue()) {
+        return WCDB::NullOpt;
+    }
+    WCDB::PreparedStatement& query = prepared.value();
+    query.reset();
+    ColumnBatch batch(kinds);
+    bool succeed = true;
+    while (true) {
+        if (!query.step()) {
+            succeed = false;
+            break;
+        }
+        if (query.done()) {
+            break;
+        }
+        batch.AppendRow(query);
+    }
+    query.reset();
+    if (!succeed) {
+        return WCDB::NullOpt;
+    }
+    return batch;
+}
+
+} // namespace Storage
@@ -0,0 +1,307 @@
+#pragma once
+
+#include "StaticBinding.h"
+#include <memory>
+#include <string>
+#include <cstdint>
+
+/**
+ * @file Cursor.h
+ * @brief Storage 流式查询接口
+ *
+ * Database::getAllObjects 会把整个结果集物化为 std::vector。Cursor 逐行 step 预编译语句，
+ * 并把每行写入同一个对象，内存占用与结果集大小无关。
+ * 通用 ORM 路径每行仍会为文本列分配临时内存（见 ExtractInto），指定 StaticFields 时才按字段类型直接读取。
+ *
+ * - Cursor：单条语句从头读到尾，期间一直持有读事务（WAL 快照）
+ * - KeysetCursor：按整数主键分页（WHERE key > ? ORDER BY key LIMIT n），
+ *   每页结束后 reset 语句释放读事务，适合遍历大表时不阻塞 checkpoint
+ *
+ * 使用示例：
+ * @code
+ * WCDB::Handle handle = db.getHandle();
+ * {
+ *     Storage::KeysetCursor<ModelSample> cursor(handle, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id), 500);
+ *     while (cursor.Next()) {
+ *         const ModelSample &model = cursor.Current();
+ *         ...
+ *     }
+ *     if (cursor.Failed()) { ... }
+ * }
+ * handle.invalidate();
+ * @endcode
+ */
+
+namespace Storage {
+
+/**
+ * @brief 只进游标
+ * @tparam ObjectType 已声明 WCDB ORM 的模型类型
+ * @tparam StaticFields 可选的 StaticFieldList，指定时按编译期字段列表读取
+ *
+ * @note 语句通过 Handle::getOrCreatePreparedStatement 获取，同一 Handle 上
+ *       SQL 相同的两个游标会共用一条语句，不能交替使用
+ * @note 游标存活期间 Handle 不能 invalidate；析构时 reset 语句以结束读事务
+ */
+template<class ObjectType, class StaticFields = void>
+class Cursor {
+public:
+    /**
+     * @brief 在 handle 上准备查询
+     * @param handle 查询使用的 Handle，生命周期须长于游标
+     * @param statement 查询语句，结果列须与 resultFields（指定 StaticFields 时为其字段列表）一一对应
+     * @param resultFields 结果列对应的字段
+     */
+    Cursor(WCDB::Handle& handle, const WCDB::StatementSelect& statement,
+           const WCDB::ResultFields& resultFields = Detail::RowCodec<ObjectType, StaticFields>::GetFields())
+    : m_resultFields(resultFields)
+    {
+        auto prepared = handle.getOrCreatePreparedStatement(statement);
+        if (prepared.hasValue()) {
+            m_statement.reset(new WCDB::PreparedStatement(std::move(prepared.value())));
+            m_statement->reset();
+        } else {
+            m_failed = true;
+        }
+    }
+
+    /**
+     * @brief 查询整张表
+     * @param where 过滤条件，可为空
+     * @param orders 排序，可为空
+     */
+    Cursor(WCDB::Handle& handle, const std::string& table,
+           const WCDB::Expression& where = WCDB::Expression(),
+           const WCDB::OrderingTerms& orders = WCDB::OrderingTerms())
+    : Cursor(handle, MakeSelect(table, where, orders))
+    {
+    }
+
+    ~Cursor()
+    {
+        if (m_statement) {
+            m_statement->reset();
+        }
+    }
+
+    Cursor(const Cursor&) = delete;
+    Cursor& operator=(const Cursor&) = delete;
+
+    /**
+     * @brief 前进到下一行
+     * @return 有下一行返回 true；结束或出错返回 false，用 Failed() 区分
+     */
+    bool Next()
+    {
+        if (m_failed || m_done) {
+            return false;
+        }
+        if (!m_statement->step()) {
+            m_failed = true;
+            return false;
+        }
+        if (m_statement->done()) {
+            m_done = true;
+            m_statement->reset();
+            return false;
+        }
+        Detail::RowCodec<ObjectType, StaticFields>::Extract(*m_statement, m_resultFields, m_current);
+        ++m_position;
+        return true;
+    }
+
+    /**
+     * @brief 当前行，下一次 Next() 会被覆盖
+     */
+    const ObjectType& Current() const { return m_current; }
+
+    /**
+     * @brief 当前行的可修改引用，可 std::move 走字段（下一行会重新赋值）
+     */
+    ObjectType& Current() { return m_current; }
+
+    /**
+     * @brief 绑定查询参数，须在第一次 Next() 之前调用
+     * @param index 参数序号，从 1 开始
+     */
+    void Bind(const WCDB::Value& value, int index)
+    {
+        if (m_statement) {
+            m_statement->bindValue(value, index);
+        }
+    }
+
+    /**
+     * @brief 已读取的行数
+     */
+    uint64_t Position() const { return m_position; }
+
+    /**
+     * @brief 是否因出错而结束
+     */
+    bool Failed() const { return m_failed; }
+
+private:
+    static WCDB::StatementSelect MakeSelect(const std::string& table,
+                                           const WCDB::Expression& where,
+                                           const WCDB::OrderingTerms& orders)
+    {
+        WCDB::StatementSelect select;
+        select.select(Detail::RowCodec<ObjectType, StaticFields>::GetFields()).from(table);
+        if (where.syntax().isValid()) {
+            select.where(where);
+        }
+        if (orders.size() > 0) {
+            select.orders(orders);
+        }
+        return select;
+    }
+
+    WCDB::ResultFields m_resultFields;
+    std::unique_ptr<WCDB::PreparedStatement> m_statement;
+    ObjectType m_current{};
+    uint64_t m_position = 0;
+    bool m_done = false;
+    bool m_failed = false;
+};
+
+/**
+ * @brief 按整数主键分页的游标
+ * @tparam ObjectType 已声明 WCDB ORM 的模型类型
+ * @tparam StaticFields 可选的 StaticFieldList，指定时按编译期字段列表读取
+ *
+ * 每页执行 SELECT ... WHERE key > ?1 [AND where] ORDER BY key LIMIT pageSize，
+ * 下一页从上一页最后一行的主键继续，不使用 OFFSET，翻页代价与位置无关。
+ * 页与页之间语句被 reset，不会长时间持有读事务；遍历期间插入的更大主键的行会被读到。
+ */
+template<class ObjectType, class StaticFields = void>
+class KeysetCursor {
+public:
+    /**
+     * @param handle 查询使用的 Handle，生命周期须长于游标
+     * @param table 表名
+     * @param key 整数主键字段（或带索引的唯一整数列）
+     * @param pageSize 每页行数
+     * @param where 附加过滤条件，可为空
+     * @param afterKey 从大于该值的主键开始
+     * @param resultFields 需要读取的字段，默认为全部字段；未选择的字段保持默认值。
+     *                     指定 StaticFields 时须与其字段列表一致
+     */
+    KeysetCursor(WCDB::Handle& handle, const std::string& table, const WCDB::Field& key,
+                 int pageSize = 1000, const WCDB::Expression& where = WCDB::Expression(),
+                 int64_t afterKey = INT64_MIN,
+                 const WCDB::ResultFields& resultFields = Detail::RowCodec<ObjectType, StaticFields>::GetFields())
+    : m_resultFields(resultFields), m_pageSize(pageSize > 0 ? pageSize : 1), m_lastKey(afterKey)
+    {
+        // 主键追加在结果列末尾，翻页只依赖它，与是否投影无关
+        WCDB::ResultColumns columns;
+        for (const WCDB::ResultField& field : m_resultFields) {
+            columns.push_back(field);
+        }
+        m_keyIndex = (int) columns.size();
+        columns.push_back(key);
+
+        WCDB::Expression condition = key > WCDB::BindParameter(1);
+        if (where.syntax().isValid()) {
+            condition = condition && where;
+        }
+        WCDB::StatementSelect select;
+        select.select(columns).from(table).where(condition).order(key.asOrder(WCDB::Order::ASC)).limit(m_pageSize);
+
+        auto prepared = handle.getOrCreatePreparedStatement(select);
+        if (prepared.hasValue()) {
+            m_statement.reset(new WCDB::PreparedStatement(std::move(prepared.value())));
+            BeginPage();
+        } else {
+            m_failed = true;
+        }
+    }
+
+    ~KeysetCursor()
+    {
+        if (m_statement) {
+            m_statement->reset();
+        }
+    }
+
+    KeysetCursor(const KeysetCursor&) = delete;
+    KeysetCursor& operator=(const KeysetCursor&) = delete;
+
+    /**
+     * @brief 前进到下一行，必要时自动翻页
+     * @return 有下一行返回 true；结束或出错返回 false，用 Failed() 区分
+     */
+    bool Next()
+    {
+        if (m_failed || m_done) {
+            return false;
+        }
+        if (m_rowsInPage == m_pageSize) {
+            BeginPage();
+        }
+        if (!m_statement->step()) {
+            m_failed = true;
+            return false;
+        }
+        if (m_statement->done()) {
+            // 本页不足 pageSize 行时已到末尾；恰好满页时会多查一次空页
+            m_done = true;
+            m_statement->reset();
+            return false;
+        }
+        Detail::RowCodec<ObjectType, StaticFields>::Extract(*m_statement, m_resultFields, m_current);
+        m_lastKey = m_statement->getInteger(m_keyIndex);
+        ++m_rowsInPage;
+        ++m_position;
+        return true;
+    }
+
+    /**
+     * @brief 当前行，下一次 Next() 会被覆盖
+     */
+    const ObjectType& Current() const { return m_current; }
+    ObjectType& Current() { return m_current; }
+
+    /**
+     * @brief 最后读取行的主键，可保存下来作为下次的 afterKey 断点续读
+     */
+    int64_t LastKey() const { return m_lastKey; }
+
+    /**
+     * @brief 已读取的行数
+     */
+    uint64_t Position() const { return m_position; }
+
+    /**
+     * @brief 已执行的分页查询次数
+     */
+    uint64_t Pages() const { return m_pages; }
+
+    /**
+     * @brief 是否因出错而结束
+     */
+    bool Failed() const { return m_failed; }
+
+private:
+    void BeginPage()
+    {
+        m_statement->reset();
+        m_statement->bindInteger(m_lastKey, 1);
+        m_rowsInPage = 0;
+        ++m_pages;
+    }
+
+    WCDB::ResultFields m_resultFields;
+    std::unique_ptr<WCDB::PreparedStatement> m_statement;
+    ObjectType m_current{};
+    int m_pageSize;
+    int m_rowsInPage = 0;
+    int m_keyIndex = 0;
+    int64_t m_lastKey;
+    uint64_t m_position = 0;
+    uint64_t m_pages = 0;
+    bool m_done = false;
+    bool m_failed = false;
+};
+
+} // namespace Storage
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "StaticBinding.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @file InternedString.h
+ * @brief Storage 低基数字符串驻留
+ *
+ * city / state / country 这类列只有几百个不同取值，按 TEXT 存储时每行都重复保存完整字符串，
+ * 读取时每个对象各分配一份 std::string。InternedString 把这类字段换成：
+ *
+ * - 磁盘上：INTEGER 编码，指向字典表（code INTEGER PRIMARY KEY, value TEXT UNIQUE）的一行
+ * - 内存中：指向进程内字典条目的句柄，条目创建后不再修改或释放，复制句柄不分配内存
+ *
+ * 字典表与进程内的双向缓存（字符串 -> 条目，编码 -> 条目）由 StringDictionary 维护。
+ * WCDB ORM 按整数列读写 InternedString，读取时通过 StringDictionary::Shared() 把编码解析为条目。
+ *
+ * 使用示例：
+ * @code
+ * // 模型字段
+ * Storage::InternedString city;
+ *
+ * Storage::StringDictionary &dictionary = Storage::StringDictionary::Shared();
+ * dictionary.Attach(db);                       // 建表并预加载全部条目
+ * model.city = dictionary.Intern("Beijing").value();   // 新值写入字典表，已有值直接命中缓存
+ * db.insertObjects<ModelSampleInterned>(models, TABLE_NAME_SAMPLE_INTERNED);
+ *
+ * // 按值查询时先换成编码，查询条件比较整数
+ * auto beijing = dictionary.Find("Beijing");
+ * if (beijing.hasValue()) {
+ *     db.getAllObjects<ModelSampleInterned>(TABLE_NAME_SAMPLE_INTERNED,
+ *         WCDB_FIELD(ModelSampleInterned::city) == beijing.value().Code());
+ * }
+ * @endcode
+ *
+ * @note 编码是字典表的 rowid，只在同一个数据库内有意义；一个进程内的 InternedString 字段共用
+ *       StringDictionary::Shared() 及其附着的字典表
+ * @note 编码 0 表示未设置，对应空句柄
+ */
+
+namespace Storage {
+
+const std::string TABLE_NAME_INTERNED_STRING = "interned_string";
+
+namespace Detail {
+
+/**
+ * @brief 字典条目，创建后不再修改，地址在进程内保持不变
+ */
+struct InternEntry {
+    int64_t code = 0;
+    std::string value;
+};
+
+} // namespace Detail
+
+/**
+ * @brief 驻留字符串句柄
+ *
+ * 只保存编码和条目指针，复制、比较都不涉及字符串本身。
+ * 由 StringDictionary::Intern / Find / Resolve 创建；从整数构造时通过共享字典解析。
+ */
+class InternedString {
+public:
+    InternedString() = default;
+
+    /**
+     * @brief 从编码构造，通过 StringDictionary::Shared() 解析，供 ORM 读取整数列时使用
+     * @note 编码不在字典中时保留编码，Str() 为空串
+     */
+    explicit InternedString(int64_t code);
+
+    /**
+     * @brief ORM 写入整数列时使用
+     */
+    explicit operator int64_t() const { return m_code; }
+
+    /**
+     * @brief 字典表中的编码，空句柄为 0
+     */
+    int64_t Code() const { return m_code; }
+
+    /**
+     * @brief 字符串值，空句柄或未解析的编码返回空串
+     */
+    const std::string& Str() const
+    {
+        static const std::string s_empty;
+        return m_entry != nullptr ? m_entry->value : s_empty;
+    }
+
+    /**
+     * @brief 字符串值的视图
+     */
+    WCDB::UnsafeStringView View() const
+    {
+        const std::string& value = Str();
+        return WCDB::UnsafeStringView(value.data(), value.size());
+    }
+
+    /**
+     * @brief 是否为空句柄
+     */
+    bool Empty() const { return m_code == 0; }
+
+    /**
+     * @brief 编码已解析为字典条目
+     */
+    bool Resolved() const { return m_entry != nullptr; }
+
+    bool operator==(const InternedString& other) const { return m_code == other.m_code; }
+    bool operator!=(const InternedString& other) const { return m_code != other.m_code; }
+    bool operator==(const std::string& value) const { return Str() == value; }
+    bool operator!=(const std::string& value) const { return Str() != value; }
+
+private:
+    friend class StringDictionary;
+
+    explicit InternedString(const Detail::InternEntry* entry)
+    : m_entry(entry), m_code(entry != nullptr ? entry->code : 0)
+    {
+    }
+
+    const Detail::InternEntry* m_entry = nullptr;
+    int64_t m_code = 0;
+};
+
+/**
+ * @brief 字符串字典：字典表 + 进程内双向缓存
+ *
+ * @note 线程安全。缓存未命中时访问数据库，访问期间不持有锁
+ */
+class StringDictionary {
+public:
+    StringDictionary() = default;
+
+    StringDictionary(const StringDictionary&) = delete;
+    StringDictionary& operator=(const StringDictionary&) = delete;
+
+    /**
+     * @brief 进程内共享的字典，InternedString 从编码构造时使用
+     */
+    static StringDictionary& Shared()
+    {
+        static StringDictionary s_dictionary;
+        return s_dictionary;
+    }
+
+    /**
+     * @brief 附着到数据库：不存在时创建字典表，并把全部条目加载到缓存
+     * @param database 数据库
+     * @param table 字典表名
+     * @return 成功返回 true；缓存中已有的编码与表中内容冲突时返回 false
+     * @note 重新附着到另一个数据库前须调用 Clear()，否则两个库的编码会混在一起
+     */
+    bool Attach(const WCDB::Database& database, const std::string& table = TABLE_NAME_INTERNED_STRING)
+    {
+        std::shared_ptr<WCDB::Database> attached = std::make_shared<WCDB::Database>(database);
+        WCDB::StatementCreateTable create;
+        create.createTable(table).ifNotExists()
+        .define(WCDB::ColumnDef(CodeColumn(), WCDB::ColumnType::Integer).constraint(WCDB::ColumnConstraint().primaryKey()))
+        .define(WCDB::ColumnDef(ValueColumn(), WCDB::ColumnType::Text)
+                .constraint(WCDB::ColumnConstraint().notNull())
+                .constraint(WCDB::ColumnConstraint().unique()));
+        if (!attached->execute(create)) {
+            return false;
+        }
+        auto rows = attached->getAllRowsFromStatement(
+        WCDB::StatementSelect().select({ CodeColumn(), ValueColumn() }).from(table));
+        if (!rows.hasValue()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const WCDB::OneRowValue& row : rows.value()) {
+            if (row.size() < 2 || Insert(row[0].intValue(), row[1].textValue()) == nullptr) {
+                return false;
+            }
+        }
+        m_database = std::move(attached);
+        m_table = table;
+        return true;
+    }
+
+    /**
+     * @brief 取得字符串对应的句柄，不在字典中时写入字典表
+     * @return 未附着数据库或写入失败时返回空
+     */
+    WCDB::Optional<InternedString> Intern(const std::string& value)
+    {
+        const Detail::InternEntry* entry = FindEntry(value);
+        if (entry != nullptr) {
+            return InternedString(entry);
+        }
+        std::shared_ptr<WCDB::Database> database;
+        std::string table;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            database = m_database;
+            table = m_table;
+        }
+        if (database == nullptr) {
+            return WCDB::NullOpt;
+        }
+        // 其他连接或进程可能同时写入同一个值，INSERT OR IGNORE 后再按值查出编码
+        WCDB::StatementInsert insert;
+        insert.insertIntoTable(table).orIgnore().columns({ ValueColumn() }).values({ WCDB::LiteralValue(value) });
+        if (!database->execute(insert)) {
+            return WCDB::NullOpt;
+        }
+        auto code = database->getValueFromStatement(
+        WCDB::StatementSelect().select(CodeColumn()).from(table).where(ValueColumn() == value));
+        if (!code.hasValue() || code.value().isNull()) {
+            return WCDB::NullOpt;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entry = Insert(code.value().intValue(), value);
+        if (entry == nullptr) {
+            return WCDB::NullOpt;
+        }
+        return InternedString(entry);
+    }
+
+    /**
+     * @brief 只查缓存，不访问数据库
+     * @return 不在缓存中时返回空
+     */
+    WCDB::Optional<InternedString> Find(const std::string& value) const
+    {
+        const Detail::InternEntry* entry = FindEntry(value);
+        if (entry == nullptr) {
+            return WCDB::NullOpt;
+        }
+        return InternedString(entry);
+    }
+
+    /**
+     * @brief 把编码解析为句柄，缓存未命中时查询字典表（如其他连接新写入的值）
+     * @return 编码为 0 时返回空句柄；找不到时返回空
+     */
+    WCDB::Optional<InternedString> Resolve(int64_t code)
+    {
+        if (code == 0) {
+            return InternedString();
+        }
+        std::shared_ptr<WCDB::Database> database;
+        std::string table;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto iter = m_byCode.find(code);
+            if (iter != m_byCode.end()) {
+                return InternedString(iter->second);
+            }
+            database = m_database;
+            table = m_table;
+        }
+        if (database == nullptr) {
+            return WCDB::NullOpt;
+        }
+        auto value = database->getValueFromStatement(
+        WCDB::StatementSelect().select(ValueColumn()).from(table).where(CodeColumn() == code));
+        if (!value.hasValue() || value.value().isNull()) {
+            return WCDB::NullOpt;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Detail::InternEntry* entry = Insert(code, value.value().textValue());
+        if (entry == nullptr) {
+            return WCDB::NullOpt;
+        }
+        return InternedString(entry);
+    }
+
+    /**
+     * @brief 缓存中的条目数
+     */
+    size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_byCode.size();
+    }
+
+    /**
+     * @brief 解除附着并清空索引
+     * @note 条目本身不释放，已发出的句柄仍然有效，但之后不再能通过编码或字符串找到它们
+     */
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_byValue.clear();
+        m_byCode.clear();
+        m_database.reset();
+        m_table.clear();
+    }
+
+private:
+    static WCDB::Column CodeColumn() { return WCDB::Column("code"); }
+    static WCDB::Column ValueColumn() { return WCDB::Column("value"); }
+
+    const Detail::InternEntry* FindEntry(const std::string& value) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto iter = m_byValue.find(value);
+        return iter != m_byValue.end() ? iter->second : nullptr;
+    }
+
+    // 调用方须持有 m_mutex。已存在时返回原条目；编码或字符串与已有条目冲突时返回 nullptr
+    const Detail::InternEntry* Insert(int64_t code, const WCDB::UnsafeStringView& value)
+    {
+        std::string key(value.data(), value.length());
+        auto byCode = m_byCode.find(code);
+        if (byCode != m_byCode.end()) {
+            return byCode->second->value == key ? byCode->second : nullptr;
+        }
+        if (m_byValue.find(key) != m_byValue.end()) {
+            return nullptr;
+        }
+        m_entries.emplace_back();
+        Detail::InternEntry* entry = &m_entries.back();
+        entry->code = code;
+        entry->value = key;
+        m_byValue.emplace(std::move(key), entry);
+        m_byCode.emplace(code, entry);
+        return entry;
+    }
+
+    mutable std::mutex m_mutex;
+    std::deque<Detail::InternEntry> m_entries;   // 只追加，保证条目地址不变
+    std::unordered_map<std::string, const Detail::InternEntry*> m_byValue;
+    std::unordered_map<int64_t, const Detail::InternEntry*> m_byCode;
+    std::shared_ptr<WCDB::Database> m_database;   // 在锁外访问数据库时复制一份引用
+    std::string m_table;
+};
+
+inline InternedString::InternedString(int64_t code)
+: m_code(code)
+{
+    auto resolved = StringDictionary::Shared().Resolve(code);
+    if (resolved.hasValue()) {
+        m_entry = resolved.value().m_entry;
+    }
+}
+
+template<>
+struct ColumnReader<InternedString> {
+    static void Read(WCDB::StatementOperation& statement, int index, InternedString& value)
+    {
+        value = InternedString(statement.getInteger(index));
+    }
+};
+
+template<>
+struct ColumnBinder<InternedString> {
+    static void Bind(WCDB::StatementOperation& statement, const InternedString& value, int index)
+    {
+        statement.bindInteger(value.Code(), index);
+    }
+};
+
+} // namespace Storage
+
+namespace WCDB {
+
+// ORM 把 InternedString 字段声明为 INTEGER 列，读写的是字典编码
+template<>
+struct ColumnIsIntegerType<Storage::InternedString> : public std::true_type {
+public:
+    static ColumnTypeInfo<ColumnType::Integer>::UnderlyingType
+    asUnderlyingType(const Storage::InternedString& value)
+    {
+        return value.Code();
+    }
+};
+
+} // namespace WCDB
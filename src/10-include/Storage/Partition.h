@@ -0,0 +1,404 @@
+#pragma once
+
+#include "Timestamp.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file Partition.h
+ * @brief Storage 按时间分区的表
+ *
+ * 遥测类的表只增不减，用 DELETE ... WHERE created_at < X 清理旧数据时要长时间持有写锁，
+ * 删除的每一行都写入 WAL，删除后还要 VACUUM 才能回收空间。PartitionedTable 按天或按月把同一个
+ * 模型写入不同的表（如 sample_2026_10），清理时直接 DROP 整张表：
+ *
+ * - 写入：按时间字段把对象路由到所属分区，分区表不存在时通过 createTable<ObjectType> 创建，
+ *   ORM 中声明的索引随之在每个分区上创建
+ * - 查询：Query 按时间范围只访问相关分区并依次拼接结果；也可以用 EnableView 维护一个
+ *   UNION ALL 视图，供需要跨分区写任意 SQL 的场合使用
+ * - 清理：DropBefore 删除整个分区都早于截止时间的表
+ *
+ * 使用示例：
+ * @code
+ * Storage::PartitionedTable<ModelSample> samples(db, TABLE_NAME_SAMPLE, &ModelSample::created_at,
+ *     WCDB_FIELD(ModelSample::created_at), Storage::PartitionGranularity::Month);
+ * samples.InsertBatch(models);                                  // 写入 sample_2026_09、sample_2026_10 ...
+ * auto lastDay = samples.Query(now - 86400000, now);            // 只查询涉及的分区
+ * samples.DropBefore(now - 90LL * 86400000);                    // 保留 90 天
+ * @endcode
+ *
+ * @note 时间字段为 Unix 毫秒（UTC），分区边界按 UTC 计算
+ * @note DROP TABLE 释放的页进入空闲列表，由后续写入复用，不需要 VACUUM
+ */
+
+namespace Storage {
+
+/**
+ * @brief 分区粒度
+ */
+enum class PartitionGranularity {
+    Day = 0,   // 表名后缀 _YYYY_MM_DD
+    Month      // 表名后缀 _YYYY_MM
+};
+
+/**
+ * @brief 分区的时间范围 [begin, end) 与表名
+ */
+struct PartitionInfo {
+    std::string table;
+    int64_t begin = 0;
+    int64_t end = 0;
+};
+
+namespace Detail {
+
+const int64_t kMillisPerDay = 86400000;
+
+inline int64_t FloorDays(int64_t millis)
+{
+    return millis >= 0 ? millis / kMillisPerDay : -((-millis + kMillisPerDay - 1) / kMillisPerDay);
+}
+
+} // namespace Detail
+
+/**
+ * @brief 计算时间点所在的分区
+ * @param base 表名前缀，如 "sample"
+ */
+inline PartitionInfo PartitionOf(const std::string& base, int64_t millis, PartitionGranularity granularity)
+{
+    int64_t days = Detail::FloorDays(millis);
+    int64_t year;
+    unsigned month;
+    unsigned day;
+    Detail::CivilFromDays(days, year, month, day);
+
+    PartitionInfo info;
+    char suffix[32];
+    if (granularity == PartitionGranularity::Day) {
+        snprintf(suffix, sizeof(suffix), "_%04lld_%02u_%02u", (long long) year, month, day);
+        info.begin = days * Detail::kMillisPerDay;
+        info.end = info.begin + Detail::kMillisPerDay;
+    } else {
+        snprintf(suffix, sizeof(suffix), "_%04lld_%02u", (long long) year, month);
+        info.begin = Detail::DaysFromCivil(year, month, 1) * Detail::kMillisPerDay;
+        info.end = (month == 12 ? Detail::DaysFromCivil(year + 1, 1, 1) : Detail::DaysFromCivil(year, month + 1, 1))
+                   * Detail::kMillisPerDay;
+    }
+    info.table = base + suffix;
+    return info;
+}
+
+/**
+ * @brief 从表名解析分区
+ * @return 表名不是 base 在该粒度下的分区名时返回空
+ */
+inline WCDB::Optional<PartitionInfo> ParsePartition(const std::string& base, const std::string& table,
+                                                    PartitionGranularity granularity)
+{
+    if (table.size() <= base.size() + 1 || table.compare(0, base.size(), base) != 0 || table[base.size()] != '_') {
+        return WCDB::NullOpt;
+    }
+    const char* suffix = table.c_str() + base.size();
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 1;
+    int consumed = 0;
+    if (granularity == PartitionGranularity::Day) {
+        if (sscanf(suffix, "_%4d_%2u_%2u%n", &year, &month, &day, &consumed) != 3) {
+            return WCDB::NullOpt;
+        }
+    } else if (sscanf(suffix, "_%4d_%2u%n", &year, &month, &consumed) != 2) {
+        return WCDB::NullOpt;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return WCDB::NullOpt;
+    }
+    // 重新生成表名比较，排除 sample_2026_1、sample_2026_10_extra 之类的名字
+    PartitionInfo info
+    = PartitionOf(base, Detail::DaysFromCivil(year, month, day) * Detail::kMillisPerDay, granularity);
+    if (info.table != table) {
+        return WCDB::NullOpt;
+    }
+    return info;
+}
+
+/**
+ * @brief 按时间分区的模型表
+ * @tparam ObjectType 已声明 WCDB ORM 的模型类型，时间字段为 int64_t 毫秒
+ * @note 线程安全，与 WCDB::Database 相同
+ */
+template<class ObjectType>
+class PartitionedTable {
+public:
+    /**
+     * @param database 数据库
+     * @param base 表名前缀，分区表名为 base_YYYY_MM 或 base_YYYY_MM_DD
+     * @param timeMember 分区依据的时间成员，如 &ModelSample::created_at
+     * @param timeField 同一成员的字段，如 WCDB_FIELD(ModelSample::created_at)，用于查询条件
+     * @param granularity 分区粒度
+     */
+    PartitionedTable(const WCDB::Database& database, const std::string& base, int64_t ObjectType::*timeMember,
+                     const WCDB::Field& timeField, PartitionGranularity granularity = PartitionGranularity::Day)
+    : m_database(database), m_base(base), m_timeMember(timeMember), m_timeField(timeField), m_granularity(granularity)
+    {
+    }
+
+    PartitionedTable(const PartitionedTable&) = delete;
+    PartitionedTable& operator=(const PartitionedTable&) = delete;
+
+    const std::string& Base() const { return m_base; }
+
+    /**
+     * @brief 对象所属的分区
+     */
+    PartitionInfo PartitionFor(const ObjectType& object) const
+    {
+        return PartitionOf(m_base, object.*m_timeMember, m_granularity);
+    }
+
+    /**
+     * @brief 插入一个对象，所属分区不存在时先建表
+     */
+    bool Insert(const ObjectType& object)
+    {
+        PartitionInfo partition = PartitionFor(object);
+        if (!EnsurePartition(partition.table)) {
+            return false;
+        }
+        return m_database.insertObject<ObjectType>(object, partition.table);
+    }
+
+    /**
+     * @brief 在一个事务中批量插入，对象按所属分区分组写入
+     * @return 全部成功返回 true，任一失败则整体回滚
+     */
+    bool InsertBatch(const std::vector<ObjectType>& objects)
+    {
+        if (objects.empty()) {
+            return true;
+        }
+        std::map<std::string, std::vector<size_t>> groups;
+        for (size_t i = 0; i < objects.size(); i++) {
+            groups[PartitionFor(objects[i]).table].push_back(i);
+        }
+        for (const auto& group : groups) {
+            if (!EnsurePartition(group.first)) {
+                return false;
+            }
+        }
+        return m_database.runTransaction([&](WCDB::Handle& handle) {
+            if (groups.size() == 1) {
+                return handle.insertObjects<ObjectType>(objects, groups.begin()->first);
+            }
+            for (const auto& group : groups) {
+                WCDB::ValueArray<ObjectType> batch;
+                batch.reserve(group.second.size());
+                for (size_t index : group.second) {
+                    batch.push_back(objects[index]);
+                }
+                if (!handle.insertObjects<ObjectType>(batch, group.first)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    /**
+     * @brief 数据库中已有的分区，按时间升序
+     * @return 读取表清单失败时返回空
+     */
+    WCDB::Optional<std::vector<PartitionInfo>> ListPartitions()
+    {
+        auto names = m_database.getOneColumnFromStatement(WCDB::StatementSelect()
+                                                          .select(WCDB::Column("name"))
+                                                          .from("sqlite_master")
+                                                          .where(WCDB::Column("type") == "table"));
+        if (!names.hasValue()) {
+            return WCDB::NullOpt;
+        }
+        std::vector<PartitionInfo> partitions;
+        for (const WCDB::Value& name : names.value()) {
+            auto partition = ParsePartition(m_base, name.textValue(), m_granularity);
+            if (partition.hasValue()) {
+                partitions.push_back(partition.value());
+            }
+        }
+        std::sort(partitions.begin(), partitions.end(),
+                  [](const PartitionInfo& a, const PartitionInfo& b) { return a.begin < b.begin; });
+        return partitions;
+    }
+
+    /**
+     * @brief 与 [from, to) 有交集的已有分区，按时间升序
+     */
+    WCDB::Optional<std::vector<PartitionInfo>> PartitionsInRange(int64_t from, int64_t to)
+    {
+        auto partitions = ListPartitions();
+        if (!partitions.hasValue()) {
+            return WCDB::NullOpt;
+        }
+        std::vector<PartitionInfo> overlapped;
+        for (const PartitionInfo& partition : partitions.value()) {
+            if (partition.begin < to && partition.end > from) {
+                overlapped.push_back(partition);
+            }
+        }
+        return overlapped;
+    }
+
+    /**
+     * @brief 查询时间在 [from, to) 内的对象，依次访问涉及的分区
+     * @param condition 附加的查询条件，与时间范围取 AND
+     * @return 按时间升序；任一分区查询失败时返回空
+     */
+    WCDB::OptionalValueArray<ObjectType>
+    Query(int64_t from, int64_t to, const WCDB::Expression& condition = WCDB::Expression())
+    {
+        auto partitions = PartitionsInRange(from, to);
+        if (!partitions.hasValue()) {
+            return WCDB::NullOpt;
+        }
+        WCDB::Expression where = TimeRange(m_timeField, from, to);
+        if (condition.syntax().isValid()) {
+            where = where && condition;
+        }
+        WCDB::ValueArray<ObjectType> results;
+        for (const PartitionInfo& partition : partitions.value()) {
+            auto objects = m_database.getAllObjects<ObjectType>(partition.table, where, m_timeField.asOrder(WCDB::Order::ASC));
+            if (!objects.hasValue()) {
+                return WCDB::NullOpt;
+            }
+            results.insert(results.end(), std::make_move_iterator(objects.value().begin()),
+                           std::make_move_iterator(objects.value().end()));
+        }
+        return results;
+    }
+
+    /**
+     * @brief 删除结束时间不晚于 cutoff 的分区，即其中所有行都早于 cutoff
+     * @return 删除的分区数；出错时返回空，已删除的分区不恢复，但视图仍会按剩余分区重建
+     */
+    WCDB::Optional<size_t> DropBefore(int64_t cutoff)
+    {
+        auto partitions = ListPartitions();
+        if (!partitions.hasValue()) {
+            return WCDB::NullOpt;
+        }
+        size_t dropped = 0;
+        bool succeed = true;
+        for (const PartitionInfo& partition : partitions.value()) {
+            if (partition.end > cutoff) {
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_created.erase(partition.table);
+            }
+            if (!m_database.dropTable(partition.table)) {
+                succeed = false;
+                break;
+            }
+            ++dropped;
+        }
+        // 中途失败时前面的分区已经删除，视图不重建就会引用不存在的表
+        if (dropped > 0 && !RefreshView()) {
+            return WCDB::NullOpt;
+        }
+        if (!succeed) {
+            return WCDB::NullOpt;
+        }
+        return dropped;
+    }
+
+    /**
+     * @brief 维护一个 UNION ALL 所有分区的视图，之后新建或删除分区时自动重建
+     * @param view 视图名，不能与分区表名冲突，如 "sample_all"
+     * @note SQLite 默认限制复合查询最多 500 项，按天分区时应配合 DropBefore 控制分区数
+     */
+    bool EnableView(const std::string& view)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_view = view;
+        }
+        return RefreshView();
+    }
+
+    /**
+     * @brief 按当前分区重建视图；未启用视图时直接返回 true
+     */
+    bool RefreshView()
+    {
+        std::string view;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            view = m_view;
+        }
+        if (view.empty()) {
+            return true;
+        }
+        auto partitions = ListPartitions();
+        if (!partitions.hasValue()) {
+            return false;
+        }
+        return m_database.runTransaction([&](WCDB::Handle& handle) {
+            if (!handle.execute(WCDB::StatementDropView().dropView(view).ifExists())) {
+                return false;
+            }
+            if (partitions.value().empty()) {
+                return true;
+            }
+            WCDB::StatementSelect select;
+            bool first = true;
+            for (const PartitionInfo& partition : partitions.value()) {
+                if (!first) {
+                    select.unionAll();
+                }
+                select.select(ObjectType::allFields()).from(partition.table);
+                first = false;
+            }
+            return handle.execute(WCDB::StatementCreateView().createView(view).as(select));
+        });
+    }
+
+private:
+    bool EnsurePartition(const std::string& table)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_created.count(table) > 0) {
+                return true;
+            }
+        }
+        // createTable 对已存在的表只补齐缺少的列和索引，并发建同一个分区也是安全的
+        if (!m_database.createTable<ObjectType>(table)) {
+            return false;
+        }
+        bool refresh = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            refresh = m_created.insert(table).second && !m_view.empty();
+        }
+        return !refresh || RefreshView();
+    }
+
+    WCDB::Database m_database;
+    std::string m_base;
+    int64_t ObjectType::*m_timeMember;
+    WCDB::Field m_timeField;
+    PartitionGranularity m_granularity;
+
+    std::mutex m_mutex;
+    std::set<std::string> m_created;   // 本进程内已确认存在的分区
+    std::string m_view;
+};
+
+} // namespace Storage
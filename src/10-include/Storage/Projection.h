@@ -0,0 +1,195 @@
+#pragma once
+
+#include "Cursor.h"
+#include <string>
+#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file Projection.h
+ * @brief Storage 列投影查询接口
+ *
+ * getAllObjects 总是读取并拷贝所有列。多数读路径只需要其中两三列，
+ * 这里提供两种只读取指定列的方式：
+ *
+ * - 部分填充的对象：SelectFields 生成只包含指定列的查询，交给 Cursor / KeysetCursor，
+ *   未选择的字段保持默认值
+ * - 轻量元组：TupleCursor<Types...> 按列顺序直接读成 std::tuple，不经过 ORM 访问器
+ *
+ * 使用示例：
+ * @code
+ * WCDB::ResultFields fields = { WCDB_FIELD(ModelSample::id), WCDB_FIELD(ModelSample::name) };
+ * Storage::Cursor<ModelSample> cursor(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, fields), fields);
+ *
+ * Storage::TupleCursor<int64_t, std::string> names(handle,
+ *     Storage::SelectFields(TABLE_NAME_SAMPLE, { WCDB_FIELD(ModelSample::id), WCDB_FIELD(ModelSample::name) }));
+ * while (names.Next()) {
+ *     int64_t id = std::get<0>(names.Current());
+ *     const std::string &name = std::get<1>(names.Current());
+ * }
+ * @endcode
+ */
+
+namespace Storage {
+
+/**
+ * @brief 生成只查询指定列的语句
+ * @param table 表名
+ * @param resultColumns 需要的列
+ * @param where 过滤条件，可为空
+ * @param orders 排序，可为空
+ * @param limit 行数上限，可为空
+ */
+inline WCDB::StatementSelect SelectFields(const std::string& table,
+                                          const WCDB::ResultColumns& resultColumns,
+                                          const WCDB::Expression& where = WCDB::Expression(),
+                                          const WCDB::OrderingTerms& orders = WCDB::OrderingTerms(),
+                                          const WCDB::Expression& limit = WCDB::Expression())
+{
+    WCDB::StatementSelect select;
+    select.select(resultColumns).from(table);
+    if (where.syntax().isValid()) {
+        select.where(where);
+    }
+    if (orders.size() > 0) {
+        select.orders(orders);
+    }
+    if (limit.syntax().isValid()) {
+        select.limit(limit);
+    }
+    return select;
+}
+
+namespace Detail {
+
+template<typename Tuple, size_t Index, size_t Count>
+struct TupleReader {
+    static void Read(WCDB::StatementOperation& statement, Tuple& tuple)
+    {
+        using ValueType = typename std::tuple_element<Index, Tuple>::type;
+        ColumnReader<ValueType>::Read(statement, (int) Index, std::get<Index>(tuple));
+        TupleReader<Tuple, Index + 1, Count>::Read(statement, tuple);
+    }
+};
+
+template<typename Tuple, size_t Count>
+struct TupleReader<Tuple, Count, Count> {
+    static void Read(WCDB::StatementOperation&, Tuple&) {}
+};
+
+} // namespace Detail
+
+/**
+ * @brief 把当前行的前 sizeof...(Types) 列依次读入 tuple
+ */
+template<typename... Types>
+void ExtractTuple(WCDB::StatementOperation& statement, std::tuple<Types...>& tuple)
+{
+    Detail::TupleReader<std::tuple<Types...>, 0, sizeof...(Types)>::Read(statement, tuple);
+}
+
+/**
+ * @brief 按列顺序把结果读成 std::tuple 的只进游标
+ * @tparam Types 各列的 C++ 类型，个数须与查询的结果列一致。NULL 读为 0 或空字符串
+ * @note 与 Cursor 一样复用同一个 tuple，使用约束相同
+ */
+template<typename... Types>
+class TupleCursor {
+public:
+    using TupleType = std::tuple<Types...>;
+
+    /**
+     * @param handle 查询使用的 Handle，生命周期须长于游标
+     * @param statement 查询语句
+     */
+    TupleCursor(WCDB::Handle& handle, const WCDB::StatementSelect& statement)
+    {
+        auto prepared = handle.getOrCreatePreparedStatement(statement);
+        if (prepared.hasValue()) {
+            m_statement.reset(new WCDB::PreparedStatement(std::move(prepared.value())));
+            m_statement->reset();
+        } else {
+            m_failed = true;
+        }
+    }
+
+    ~TupleCursor()
+    {
+        if (m_statement) {
+            m_statement->reset();
+        }
+    }
+
+    TupleCursor(const TupleCursor&) = delete;
+    TupleCursor& operator=(const TupleCursor&) = delete;
+
+    /**
+     * @brief 前进到下一行
+     * @return 有下一行返回 true；结束或出错返回 false，用 Failed() 区分
+     */
+    bool Next()
+    {
+        if (m_failed || m_done) {
+            return false;
+        }
+        if (!m_statement->step()) {
+            m_failed = true;
+            return false;
+        }
+        if (m_statement->done()) {
+            m_done = true;
+            m_statement->reset();
+            return false;
+        }
+        ExtractTuple(*m_statement, m_current);
+        ++m_position;
+        return true;
+    }
+
+    /**
+     * @brief 当前行，下一次 Next() 会被覆盖
+     */
+    const TupleType& Current() const { return m_current; }
+    TupleType& Current() { return m_current; }
+
+    /**
+     * @brief 已读取的行数
+     */
+    uint64_t Position() const { return m_position; }
+
+    /**
+     * @brief 是否因出错而结束
+     */
+    bool Failed() const { return m_failed; }
+
+private:
+    std::unique_ptr<WCDB::PreparedStatement> m_statement;
+    TupleType m_current{};
+    uint64_t m_position = 0;
+    bool m_done = false;
+    bool m_failed = false;
+};
+
+/**
+ * @brief 读取全部结果为元组数组
+ * @return 出错时返回空
+ * @note 会物化全部结果，行数不可控时请使用 TupleCursor
+ */
+template<typename... Types>
+WCDB::Optional<std::vector<std::tuple<Types...>>>
+GetAllTuples(WCDB::Handle& handle, const WCDB::StatementSelect& statement)
+{
+    TupleCursor<Types...> cursor(handle, statement);
+    std::vector<std::tuple<Types...>> rows;
+    while (cursor.Next()) {
+        rows.push_back(cursor.Current());
+    }
+    if (cursor.Failed()) {
+        return WCDB::NullOpt;
+    }
+    return rows;
+}
+
+} // namespace Storage
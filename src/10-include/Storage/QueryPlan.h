@@ -0,0 +1,287 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ * @file QueryPlan.h
+ * @brief Storage 查询计划检查
+ *
+ * 索引通过 WCDB ORM 的 WCDB_CPP_INDEX 等宏与字段一起声明，createTable 时自动创建：
+ * @code
+ * WCDB_CPP_ORM_IMPLEMENTATION_BEGIN(ModelSample);
+ * ...
+ * WCDB_CPP_INDEX("_name_index", name);
+ * WCDB_CPP_INDEX("_city_created_at_index", city);        // 同一后缀的多个字段组成联合索引
+ * WCDB_CPP_INDEX("_city_created_at_index", created_at);
+ * WCDB_CPP_ORM_IMPLEMENTATION_END;
+ * @endcode
+ *
+ * 索引是否真的被用到只能看执行计划。QueryPlanChecker 登记热点查询，在启动或测试时对每条查询执行
+ * EXPLAIN QUERY PLAN，标出全表扫描（SCAN table，包括按索引顺序遍历整个索引）和临时 B 树（USE TEMP B-TREE）：
+ * @code
+ * Storage::QueryPlanChecker checker;
+ * checker.Register("sample by name", WCDB::StatementSelect().select(ModelSample::allFields())
+ *     .from(TABLE_NAME_SAMPLE).where(WCDB_FIELD(ModelSample::name) == WCDB::BindParameter(1)));
+ * for (const Storage::PlanReport &report : checker.Check(handle)) {
+ *     if (!report.Ok()) { SPDLOG_WARN("{}", report.Describe()); }
+ * }
+ * @endcode
+ *
+ * @note 带 BindParameter 的语句可以直接检查，执行计划按参数未知估算
+ */
+
+namespace Storage {
+
+/**
+ * @brief 执行计划中的一步，对应 EXPLAIN QUERY PLAN 的一行
+ */
+struct PlanStep {
+    int id = 0;
+    int parent = 0;
+    std::string detail;   // 如 "SEARCH sample USING INDEX sample_name_index (name=?)"
+};
+
+/**
+ * @brief 单条查询的检查结果
+ */
+struct PlanReport {
+    std::string name;                     // 登记时的名称
+    std::string sql;                      // 被检查的 SQL
+    std::vector<PlanStep> steps;
+    std::vector<std::string> fullScans;   // 全表扫描的步骤
+    std::vector<std::string> tempBTrees;  // 使用临时 B 树排序或去重的步骤
+    bool failed = false;                  // EXPLAIN 执行失败，如表或列不存在
+    bool allowFullScan = false;
+    bool allowTempBTree = false;
+
+    /**
+     * @brief 没有未被允许的全表扫描和临时 B 树，且 EXPLAIN 执行成功
+     */
+    bool Ok() const
+    {
+        return !failed && (allowFullScan || fullScans.empty()) && (allowTempBTree || tempBTrees.empty());
+    }
+
+    /**
+     * @brief 可读的描述：名称、SQL、问题和按层级缩进的执行计划
+     */
+    std::string Describe() const
+    {
+        std::string text = name + (Ok() ? " [OK]" : " [SLOW]") + "\n  " + sql + "\n";
+        if (failed) {
+            text += "  EXPLAIN failed\n";
+        }
+        if (!allowFullScan) {
+            for (const std::string& detail : fullScans) {
+                text += "  full scan: " + detail + "\n";
+            }
+        }
+        if (!allowTempBTree) {
+            for (const std::string& detail : tempBTrees) {
+                text += "  temp b-tree: " + detail + "\n";
+            }
+        }
+        for (const PlanStep& step : steps) {
+            text += std::string(2 + 2 * Depth(step), ' ') + "|-- " + step.detail + "\n";
+        }
+        return text;
+    }
+
+private:
+    int Depth(const PlanStep& step) const
+    {
+        int depth = 0;
+        int parent = step.parent;
+        // steps 数量有限，以其大小作为上限防止异常数据导致死循环
+        while (parent != 0 && depth < (int) steps.size()) {
+            bool found = false;
+            for (const PlanStep& other : steps) {
+                if (other.id == parent) {
+                    parent = other.parent;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                break;
+            }
+            ++depth;
+        }
+        return depth;
+    }
+};
+
+namespace Detail {
+
+// EXPLAIN QUERY PLAN 的结果列为 id, parent, notused, detail
+inline std::vector<PlanStep> ParsePlan(const WCDB::MultiRowsValue& rows)
+{
+    std::vector<PlanStep> steps;
+    for (const WCDB::OneRowValue& row : rows) {
+        if (row.size() < 4) {
+            continue;
+        }
+        PlanStep step;
+        step.id = (int) row[0].intValue();
+        step.parent = (int) row[1].intValue();
+        step.detail = row[3].textValue();
+        steps.push_back(std::move(step));
+    }
+    return steps;
+}
+
+// "SCAN <name> ..." 中的表名，3.36 之前的 SQLite 输出 "SCAN TABLE <name>"
+inline std::string ScanTarget(const std::string& detail)
+{
+    size_t begin = 5;
+    if (detail.compare(begin, 6, "TABLE ") == 0) {
+        begin += 6;
+    }
+    size_t end = detail.find(' ', begin);
+    return detail.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+// "MATERIALIZE <name>" / "CO-ROUTINE <name>" 引入的 CTE 或子查询名称
+inline std::vector<std::string> DerivedTables(const std::vector<PlanStep>& steps)
+{
+    std::vector<std::string> names;
+    for (const PlanStep& step : steps) {
+        for (const char* prefix : { "MATERIALIZE ", "CO-ROUTINE " }) {
+            size_t length = std::char_traits<char>::length(prefix);
+            if (step.detail.compare(0, length, prefix) == 0) {
+                size_t end = step.detail.find(' ', length);
+                names.push_back(step.detail.substr(length, end == std::string::npos ? std::string::npos : end - length));
+            }
+        }
+    }
+    return names;
+}
+
+} // namespace Detail
+
+/**
+ * @brief 执行 EXPLAIN QUERY PLAN
+ * @return 执行失败时返回空
+ */
+inline WCDB::Optional<std::vector<PlanStep>> ExplainQueryPlan(WCDB::Handle& handle, const WCDB::Statement& statement)
+{
+    auto rows = handle.getAllRowsFromStatement(WCDB::StatementExplain().explainQueryPlan(statement));
+    if (!rows.hasValue()) {
+        return WCDB::NullOpt;
+    }
+    return Detail::ParsePlan(rows.value());
+}
+
+/**
+ * @brief 从执行计划中找出全表扫描和临时 B 树
+ * @note 全表扫描指所有 "SCAN <table>" 步骤。SCAN ... USING [COVERING] INDEX 同样遍历整个索引，
+ *       代价与表大小成正比，也算全表扫描；只有子查询、CTE 和常量行的扫描不算。
+ *       确实需要遍历的查询用 PlanCheckOptions::allowFullScan 放行
+ */
+inline void AnalyzePlan(PlanReport& report)
+{
+    report.fullScans.clear();
+    report.tempBTrees.clear();
+    std::vector<std::string> derived = Detail::DerivedTables(report.steps);
+    for (const PlanStep& step : report.steps) {
+        const std::string& detail = step.detail;
+        if (detail.compare(0, 5, "SCAN ") == 0 && detail.find("SUBQUERY") == std::string::npos
+            && detail.find("(subquery") == std::string::npos && detail.find("CONSTANT ROW") == std::string::npos
+            && std::find(derived.begin(), derived.end(), Detail::ScanTarget(detail)) == derived.end()) {
+            report.fullScans.push_back(detail);
+        }
+        if (detail.find("USE TEMP B-TREE") != std::string::npos) {
+            report.tempBTrees.push_back(detail);
+        }
+    }
+}
+
+/**
+ * @brief 单条查询的检查选项
+ */
+struct PlanCheckOptions {
+    bool allowFullScan = false;    // 小表或确实需要遍历全表（或整个索引）的查询
+    bool allowTempBTree = false;   // 结果集很小、排序代价可以接受的查询
+};
+
+/**
+ * @brief 热点查询的执行计划检查器
+ */
+class QueryPlanChecker {
+public:
+    /**
+     * @brief 登记一条查询
+     * @param name 便于定位的名称
+     * @param statement 查询语句，可以带 BindParameter
+     */
+    void Register(const std::string& name, const WCDB::Statement& statement, const PlanCheckOptions& options = PlanCheckOptions())
+    {
+        Entry entry;
+        entry.name = name;
+        entry.sql = statement.getDescription();
+        entry.explain.explainQueryPlan(statement);
+        entry.options = options;
+        m_entries.push_back(std::move(entry));
+    }
+
+    /**
+     * @brief 已登记的查询数
+     */
+    size_t Size() const { return m_entries.size(); }
+
+    /**
+     * @brief 检查所有登记的查询
+     * @param handle 执行 EXPLAIN 的 Handle，相关的表和索引需已创建
+     * @return 每条查询一个结果，顺序与登记顺序一致
+     */
+    std::vector<PlanReport> Check(WCDB::Handle& handle) const
+    {
+        std::vector<PlanReport> reports;
+        reports.reserve(m_entries.size());
+        for (const Entry& entry : m_entries) {
+            PlanReport report;
+            report.name = entry.name;
+            report.sql = entry.sql;
+            report.allowFullScan = entry.options.allowFullScan;
+            report.allowTempBTree = entry.options.allowTempBTree;
+            auto rows = handle.getAllRowsFromStatement(entry.explain);
+            if (rows.hasValue()) {
+                report.steps = Detail::ParsePlan(rows.value());
+                AnalyzePlan(report);
+            } else {
+                report.failed = true;
+            }
+            reports.push_back(std::move(report));
+        }
+        return reports;
+    }
+
+    /**
+     * @brief 检查所有登记的查询，只返回有问题的
+     */
+    std::vector<PlanReport> Problems(WCDB::Handle& handle) const
+    {
+        std::vector<PlanReport> problems;
+        for (PlanReport& report : Check(handle)) {
+            if (!report.Ok()) {
+                problems.push_back(std::move(report));
+            }
+        }
+        return problems;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string sql;
+        WCDB::StatementExplain explain;
+        PlanCheckOptions options;
+    };
+
+    std::vector<Entry> m_entries;
+};
+
+} // namespace Storage
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <memory>
+#include <cstdint>
+
+/**
+ * @file Reclaim.h
+ * @brief Storage 空闲时增量回收空闲页
+ *
+ * 按保留期删除数据后，被释放的页进入 freelist，数据库文件保持峰值大小；Database::vacuum 会重写整个文件，
+ * 期间阻塞所有读写。SpaceReclaimer 使用 auto_vacuum = INCREMENTAL：
+ *
+ * - 跟踪：定期读取 page_count / freelist_count，给出空闲页比例和可回收字节数
+ * - 分片回收：连续 idleMillis 没有提交、且空闲页超过阈值时，每次 incremental_vacuum 回收 pagesPerSlice 页，
+ *   片与片之间暂停 sliceGapMillis；发现新的提交立即停止本轮，让出写锁
+ * - 文件大小：每片把空闲页移到文件末尾并截掉，文件大小随删除量回落，不需要整库 VACUUM。
+ *   WAL 模式下截断与移动的页一样先写入 WAL，数据库文件要等下一次检查点（WCDB 的自动检查点或
+ *   CheckpointScheduler）写回后才变小，期间 WAL 文件还会增长回收的页数
+ *
+ * 使用示例：
+ * @code
+ * WCDB::Database db("./test.db");
+ * Storage::SpaceReclaimer reclaimer(db);       // 新库在建表之前创建，auto_vacuum 直接生效
+ * if (!reclaimer.IsIncremental()) {
+ *     reclaimer.ConvertToIncremental();         // 已有的库需要一次整库 VACUUM，在维护窗口调用
+ * }
+ * ...
+ * Storage::ReclaimStats stats = reclaimer.GetStats();   // stats.reclaimableBytes
+ * @endcode
+ *
+ * @note 需链接 libstorage
+ */
+
+namespace Storage {
+
+/**
+ * @brief 回收选项
+ */
+struct ReclaimOptions {
+    unsigned pollIntervalMillis = 200;     // 检查提交和空闲页的间隔
+    unsigned idleMillis = 500;             // 连续多久没有提交视为空闲
+    int pagesPerSlice = 256;               // 每片回收的页数
+    unsigned sliceGapMillis = 10;          // 片与片之间的暂停
+    unsigned maxSlicesPerWindow = 64;      // 每个空闲窗口最多回收的片数
+    double minFreelistRatio = 0.02;        // 空闲页占总页数的比例低于该值时不回收
+    int64_t minFreeBytes = 1LL << 20;      // 空闲页总字节数低于该值时不回收
+};
+
+/**
+ * @brief 回收统计
+ */
+struct ReclaimStats {
+    bool incremental = false;        // 数据库是否处于 auto_vacuum = INCREMENTAL
+    int64_t pageSize = 0;
+    int64_t pageCount = 0;           // 数据库文件的页数
+    int64_t freelistCount = 0;       // 空闲页数
+    double freelistRatio = 0;        // 空闲页占总页数的比例
+    int64_t reclaimableBytes = 0;    // 可回收的字节数，即空闲页总大小
+    uint64_t windows = 0;            // 执行过回收的空闲窗口数
+    uint64_t slices = 0;             // 已执行的片数
+    uint64_t reclaimedPages = 0;     // 已回收的页数
+    uint64_t interrupted = 0;        // 因新的提交提前结束的窗口数
+    uint64_t failed = 0;             // 执行出错的片数
+    double lastSliceMillis = 0;      // 最近一片的耗时
+    double maxSliceMillis = 0;       // 最长一片的耗时，即回收对写入的最长阻塞
+};
+
+/**
+ * @brief 空闲页回收器
+ * @note 构造时为数据库开启 auto_vacuum = INCREMENTAL，析构时停止后台线程
+ * @note 线程安全
+ */
+class SpaceReclaimer {
+public:
+    /**
+     * @param database 数据库对象，生命周期须长于 SpaceReclaimer
+     */
+    SpaceReclaimer(WCDB::Database& database, const ReclaimOptions& options = ReclaimOptions());
+
+    ~SpaceReclaimer();
+
+    SpaceReclaimer(const SpaceReclaimer&) = delete;
+    SpaceReclaimer& operator=(const SpaceReclaimer&) = delete;
+
+    /**
+     * @brief 数据库是否已处于 auto_vacuum = INCREMENTAL，否则后台不会回收
+     */
+    bool IsIncremental() const;
+
+    /**
+     * @brief 对已有的非增量数据库执行一次整库 VACUUM，使 auto_vacuum 设置生效
+     * @note 会阻塞读写直到完成，只在维护窗口调用
+     */
+    bool ConvertToIncremental();
+
+    /**
+     * @brief 重新读取页数和空闲页数
+     */
+    bool Refresh();
+
+    /**
+     * @brief 在调用线程立即回收，不等待空闲
+     * @param pages 回收的页数，0 表示全部空闲页
+     * @return 实际回收的页数，出错时返回空
+     */
+    WCDB::Optional<int64_t> ReclaimNow(int pages = 0);
+
+    /**
+     * @brief 停止后台线程，之后不再自动回收
+     */
+    void Stop();
+
+    /**
+     * @brief 获取统计数据
+     */
+    ReclaimStats GetStats() const;
+
+    class Impl;
+
+private:
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Storage
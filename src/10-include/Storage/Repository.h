@@ -0,0 +1,269 @@
+#pragma once
+
+#include "StaticBinding.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @file Repository.h
+ * @brief Storage 类型化数据访问层
+ *
+ * Database::insertObjects / getFirstObject 等接口每次调用都会重新构造语句、
+ * 重新 prepare 并逐列查找绑定信息。Repository 在构造时为某张表准备好
+ * insert / update / select / delete 语句，并在持有的 Handle 生命周期内复用，
+ * 每次调用只 reset 并重新绑定参数。
+ *
+ * 使用示例：
+ * @code
+ * Storage::Repository<ModelSample> repo(db, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id));
+ * ModelSample model;
+ * model.isAutoIncrement = true;
+ * repo.Insert(model);                       // *model.lastInsertedRowID 为新行的 rowid
+ * auto found = repo.Get(*model.lastInsertedRowID);
+ * repo.Remove(*model.lastInsertedRowID);
+ * @endcode
+ */
+
+namespace Storage {
+
+/**
+ * @brief 单表的类型化仓储
+ * @tparam ObjectType 已声明 WCDB ORM 的模型类型
+ * @tparam StaticFields 可选的 StaticFieldList，指定时按编译期字段列表绑定和读取
+ *
+ * @note 内部持有一个 Handle（即一个 SQLite 连接）以及其上的预编译语句，
+ *       与 WCDB::Handle 一样只能在创建它的线程中使用。需要跨线程时每个线程各建一个实例。
+ * @note 主键须为整数列
+ */
+template<class ObjectType, class StaticFields = void>
+class Repository {
+    using Codec = Detail::RowCodec<ObjectType, StaticFields>;
+
+public:
+    /**
+     * @brief 构造并预编译该表的语句，表需已存在
+     * @param database 数据库对象，生命周期须长于 Repository
+     * @param table 表名
+     * @param primaryKey 主键字段，如 WCDB_FIELD(ModelSample::id)
+     */
+    Repository(WCDB::Database& database, const std::string& table, const WCDB::Field& primaryKey)
+    : m_handle(database.getHandle())
+    , m_table(table)
+    , m_fields(Codec::GetFields())
+    , m_resultFields(m_fields)
+    {
+        const WCDB::UnsafeStringView keyName = primaryKey.syntax().name;
+        int index = 1;
+        for (const WCDB::Field& field : m_fields) {
+            const WCDB::ColumnDef* def
+            = field.syntax().getTableBinding()->getColumnDef(field.syntax().name);
+            if (def != nullptr && def->syntax().isAutoIncrement()) {
+                m_autoIncrements.push_back(index);
+            }
+            if (field.syntax().name == keyName) {
+                m_keyIndex = index;
+            }
+            ++index;
+        }
+
+        WCDB::StatementInsert insert;
+        insert.insertIntoTable(m_table).columns(m_fields).values(
+        WCDB::BindParameter::bindParameters(m_fields.size()));
+
+        WCDB::StatementUpdate update;
+        // 与 insert 共用参数布局：所有字段依次绑定，主键参数随后被 key 覆盖；
+        // WHERE 使用独立的参数，更新主键列本身也可以
+        update.update(m_table);
+        index = 1;
+        for (const WCDB::Field& field : m_fields) {
+            update.set(field).to(WCDB::BindParameter(index++));
+        }
+        update.where(primaryKey == WCDB::BindParameter(index));
+
+        WCDB::StatementSelect select;
+        select.select(m_resultFields).from(m_table).where(primaryKey == WCDB::BindParameter(1)).limit(1);
+
+        WCDB::StatementDelete remove;
+        remove.deleteFrom(m_table).where(primaryKey == WCDB::BindParameter(1));
+
+        m_insert = Prepare(insert);
+        m_update = Prepare(update);
+        m_select = Prepare(select);
+        m_delete = Prepare(remove);
+    }
+
+    ~Repository()
+    {
+        // PreparedStatement 只是 Handle 内部语句的引用，先释放引用再回收 Handle
+        m_insert.reset();
+        m_update.reset();
+        m_select.reset();
+        m_delete.reset();
+        m_handle.invalidate();
+    }
+
+    Repository(const Repository&) = delete;
+    Repository& operator=(const Repository&) = delete;
+
+    /**
+     * @brief 所有语句是否都已预编译成功（表不存在时为 false）
+     */
+    bool IsValid() const
+    {
+        return m_insert && m_update && m_select && m_delete;
+    }
+
+    /**
+     * @brief 插入一个对象
+     * @param object 待插入对象。isAutoIncrement 为 true 时自增列绑定 NULL，
+     *               成功后 *object.lastInsertedRowID 为新行的 rowid
+     * @return 成功返回 true
+     */
+    bool Insert(const ObjectType& object)
+    {
+        if (!m_insert) {
+            return false;
+        }
+        m_insert->reset();
+        Codec::Bind(*m_insert, object, m_fields);
+        if (object.isAutoIncrement) {
+            for (int index : m_autoIncrements) {
+                m_insert->bindNull(index);
+            }
+        }
+        if (!m_insert->step()) {
+            return false;
+        }
+        *object.lastInsertedRowID = m_handle.getLastInsertedRowID();
+        return true;
+    }
+
+    /**
+     * @brief 在一个事务中批量插入，复用同一条预编译语句
+     * @return 全部成功返回 true，任一失败则整体回滚
+     * @note 已处于事务中时并入外层事务
+     */
+    bool InsertBatch(const std::vector<ObjectType>& objects)
+    {
+        if (objects.empty()) {
+            return true;
+        }
+        return RunTransaction([&]() {
+            for (const ObjectType& object : objects) {
+                if (!Insert(object)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    /**
+     * @brief 按主键更新所有列
+     * @param object 对象，其主键列会被写为 key
+     * @param key 主键值
+     * @return 执行成功返回 true（主键不存在也视为成功，可通过 Changes() 判断）
+     */
+    bool Update(const ObjectType& object, int64_t key)
+    {
+        if (!m_update) {
+            return false;
+        }
+        m_update->reset();
+        Codec::Bind(*m_update, object, m_fields);
+        if (m_keyIndex > 0) {
+            m_update->bindInteger(key, m_keyIndex);
+        }
+        m_update->bindInteger(key, (int) m_fields.size() + 1);
+        return m_update->step();
+    }
+
+    /**
+     * @brief 按主键查询
+     * @return 找到时返回对象；不存在或出错时返回空
+     */
+    WCDB::Optional<ObjectType> Get(int64_t key)
+    {
+        if (!m_select) {
+            return WCDB::NullOpt;
+        }
+        m_select->reset();
+        m_select->bindInteger(key, 1);
+        if (!m_select->step() || m_select->done()) {
+            return WCDB::NullOpt;
+        }
+        ObjectType object;
+        Codec::Extract(*m_select, m_resultFields, object);
+        return object;
+    }
+
+    /**
+     * @brief 按主键删除
+     * @return 执行成功返回 true（主键不存在也视为成功，可通过 Changes() 判断）
+     */
+    bool Remove(int64_t key)
+    {
+        if (!m_delete) {
+            return false;
+        }
+        m_delete->reset();
+        m_delete->bindInteger(key, 1);
+        return m_delete->step();
+    }
+
+    /**
+     * @brief 最近一次 insert / update / delete 影响的行数
+     */
+    int Changes()
+    {
+        return m_handle.getChanges();
+    }
+
+    /**
+     * @brief 在当前 Handle 上运行事务，回调返回 false 时回滚
+     */
+    bool RunTransaction(const std::function<bool()>& inTransaction)
+    {
+        return m_handle.runTransaction([&](WCDB::Handle&) { return inTransaction(); });
+    }
+
+    /**
+     * @brief 内部持有的 Handle，可在同一连接上执行其他语句
+     */
+    WCDB::Handle& GetHandle()
+    {
+        return m_handle;
+    }
+
+    const std::string& GetTable() const
+    {
+        return m_table;
+    }
+
+private:
+    std::unique_ptr<WCDB::PreparedStatement> Prepare(const WCDB::Statement& statement)
+    {
+        auto prepared = m_handle.getOrCreatePreparedStatement(statement);
+        if (!prepared.hasValue()) {
+            return nullptr;
+        }
+        return std::unique_ptr<WCDB::PreparedStatement>(
+        new WCDB::PreparedStatement(std::move(prepared.value())));
+    }
+
+    WCDB::Handle m_handle;
+    std::string m_table;
+    WCDB::Fields m_fields;
+    WCDB::ResultFields m_resultFields;
+    std::vector<int> m_autoIncrements;   // 自增列的参数序号
+    int m_keyIndex = 0;                  // 主键列的参数序号，字段列表不含主键时为 0
+    std::unique_ptr<WCDB::PreparedStatement> m_insert;
+    std::unique_ptr<WCDB::PreparedStatement> m_update;
+    std::unique_ptr<WCDB::PreparedStatement> m_select;
+    std::unique_ptr<WCDB::PreparedStatement> m_delete;
+};
+
+} // namespace Storage
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file Rollup.h
+ * @brief Storage 降采样汇总表
+ *
+ * 看板按周查询时，每次请求都对原始行做聚合，耗时随原始行数线性增长。RollupEngine 为一张原始表维护
+ * 多个粒度（默认 1 分钟、15 分钟、1 小时）的汇总表，每个桶保存 count / sum / min / max / last：
+ *
+ * - 增量维护：Refresh 只重算上次汇总之后的桶。粗粒度由相邻的细粒度汇总表合并而来，不再读原始表
+ * - 写入：InsertObjects 通过 ORM 写入原始表并标记受影响的时间；其他途径写入的行按时间顺序到达时
+ *   Refresh 会自动接上，迟到的行用 MarkDirty 标记
+ * - 查询：Query 选择桶宽能整除请求分辨率的最粗粒度，读取的行数只与时间范围和分辨率有关；
+ *   没有能整除的粒度时（如 20 分钟）直接聚合原始表
+ *
+ * 使用示例：
+ * @code
+ * Storage::RollupSource source;
+ * source.table = TABLE_NAME_SAMPLE;
+ * source.timeColumn = "created_at";
+ * source.valueColumn = "age";
+ * source.keyColumn = "city";                      // 可为空，表示不分组
+ * Storage::RollupEngine rollup(db, source);
+ *
+ * rollup.InsertObjects(models, &ModelSample::created_at);
+ * rollup.Refresh();                               // 定期或写入后调用
+ * auto hourly = rollup.Query("Beijing", now - 7 * 86400000LL, now, 3600 * 1000);   // 读取 1 小时汇总表
+ * @endcode
+ *
+ * @note 时间列为 Unix 毫秒，值列为数值；分组列按文本比较
+ * @note 原始表时间列上应有索引，Refresh 按时间范围读取新增的行
+ * @note 需链接 libstorage
+ */
+
+namespace Storage {
+
+/**
+ * @brief 汇总的原始表
+ */
+struct RollupSource {
+    std::string table;         // 原始表名
+    std::string timeColumn;    // 时间列，Unix 毫秒
+    std::string valueColumn;   // 被汇总的数值列
+    std::string keyColumn;     // 分组列，为空时所有行属于同一组
+};
+
+/**
+ * @brief 汇总选项
+ */
+struct RollupOptions {
+    std::string name;                                          // 汇总表名前缀，为空时使用 "<原始表名>_rollup"
+    std::vector<int64_t> levels = { 60000, 900000, 3600000 };  // 各级桶宽（毫秒），升序且每级为前一级的整数倍
+};
+
+/**
+ * @brief 一个汇总桶 [start, start + width)
+ */
+struct RollupBucket {
+    std::string key;
+    int64_t start = 0;
+    int64_t width = 0;
+    uint64_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+    int64_t lastTime = 0;    // 桶内最后一个点的时间
+    double lastValue = 0;    // 桶内最后一个点的值
+
+    double Average() const { return count > 0 ? sum / count : 0; }
+};
+
+/**
+ * @brief 降采样汇总引擎
+ * @note 线程安全，Refresh 在一个事务中完成，查询看到的汇总表始终一致
+ */
+class RollupEngine {
+public:
+    /**
+     * @brief 创建各级汇总表（已存在时直接使用）
+     * @param database 数据库对象，生命周期须长于 RollupEngine
+     */
+    RollupEngine(WCDB::Database& database, const RollupSource& source, const RollupOptions& options = RollupOptions());
+
+    ~RollupEngine();
+
+    RollupEngine(const RollupEngine&) = delete;
+    RollupEngine& operator=(const RollupEngine&) = delete;
+
+    /**
+     * @brief 汇总表是否创建成功、级别配置是否合法
+     */
+    bool IsValid() const;
+
+    /**
+     * @brief 各级桶宽（毫秒）
+     */
+    const std::vector<int64_t>& Levels() const;
+
+    /**
+     * @brief 某一级汇总表的表名，如 sample_rollup_15m
+     */
+    std::string LevelTable(size_t level) const;
+
+    /**
+     * @brief 标记 time 之后的桶需要重算，用于迟到或被修改的原始行
+     */
+    void MarkDirty(int64_t time);
+
+    /**
+     * @brief 通过 ORM 写入原始表，并标记受影响的最早时间
+     */
+    template<class ObjectType>
+    bool InsertObjects(const std::vector<ObjectType>& objects, int64_t ObjectType::*timeMember)
+    {
+        if (objects.empty()) {
+            return true;
+        }
+        if (!Database().insertObjects<ObjectType>(objects, Source().table)) {
+            return false;
+        }
+        int64_t earliest = objects.front().*timeMember;
+        for (const ObjectType& object : objects) {
+            earliest = std::min(earliest, object.*timeMember);
+        }
+        MarkDirty(earliest);
+        return true;
+    }
+
+    /**
+     * @brief 重算上次汇总之后以及被标记的桶
+     * @return 成功返回 true；失败时汇总表保持原样，标记保留到下次
+     */
+    bool Refresh();
+
+    /**
+     * @brief 桶宽能整除分辨率的最粗一级
+     * @return 级别下标；没有能整除的级别时返回 -1，表示需要读原始表
+     */
+    int LevelFor(int64_t resolution) const;
+
+    /**
+     * @brief 按分辨率查询 [from, to) 的汇总
+     * @param key 分组值，没有分组列时传空串
+     * @param resolution 结果桶宽（毫秒）；大于所选级别的桶宽时在内存中合并
+     * @return 按时间升序的桶，起止按桶边界对齐；出错时返回空
+     * @note from 向下、to 向上对齐到 resolution 的整数倍，首尾的桶也是完整的
+     * @note 只包含已 Refresh 的数据；没有能整除分辨率的级别时直接聚合原始表
+     */
+    WCDB::Optional<std::vector<RollupBucket>> Query(const std::string& key, int64_t from, int64_t to, int64_t resolution);
+
+    /**
+     * @brief 上次 Refresh 读取的行数（原始行与下级汇总行之和）
+     */
+    uint64_t LastRefreshRows() const;
+
+    class Impl;
+
+private:
+    WCDB::Database& Database();
+    const RollupSource& Source() const;
+
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Storage
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "StaticBinding.h"
+#include <memory>
+#include <cstdint>
+
+/**
+ * @file RowView.h
+ * @brief Storage 零拷贝行视图
+ *
+ * Cursor 每读一行都要把所有文本列拷贝进对象的 std::string。只做扫描和聚合时，
+ * 可以用 RowCursor 直接读取 SQLite 语句内部的列数据：
+ *
+ * - 整数和浮点列直接返回值
+ * - 文本列返回指向语句内部缓冲区的 UnsafeStringView，不分配内存
+ * - 需要保留某一行时，再用 Materialize 生成独立的对象
+ *
+ * 使用示例：
+ * @code
+ * WCDB::ResultFields fields = { WCDB_FIELD(ModelSample::age), WCDB_FIELD(ModelSample::city) };
+ * Storage::RowCursor rows(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, fields));
+ * while (rows.Next()) {
+ *     const Storage::RowView &row = rows.Current();
+ *     if (row.GetText(1) == "City 1") {
+ *         ageSum += row.GetInteger(0);
+ *     }
+ * }
+ * @endcode
+ *
+ * @note 视图中的文本只在下一次 Next() 之前有效，需要保留时拷贝成 std::string 或调用 Materialize
+ */
+
+namespace Storage {
+
+/**
+ * @brief 当前行的只读视图，列序号从 0 开始
+ * @note 不拥有数据，有效期到语句下一次 step 或 reset 为止
+ */
+class RowView {
+public:
+    explicit RowView(WCDB::StatementOperation& statement)
+    : m_statement(&statement)
+    {
+    }
+
+    /**
+     * @brief 结果列数
+     */
+    int ColumnCount() const { return m_statement->getNumberOfColumns(); }
+
+    /**
+     * @brief 该列是否为 NULL
+     */
+    bool IsNull(int index) const { return m_statement->getType(index) == WCDB::ColumnType::Null; }
+
+    /**
+     * @brief 整数列，NULL 读为 0
+     */
+    int64_t GetInteger(int index) const { return m_statement->getInteger(index); }
+
+    /**
+     * @brief 浮点列，NULL 读为 0
+     */
+    double GetDouble(int index) const { return m_statement->getDouble(index); }
+
+    /**
+     * @brief 文本列，指向语句内部缓冲区，NULL 读为空串
+     */
+    WCDB::UnsafeStringView GetText(int index) const { return m_statement->getText(index); }
+
+    /**
+     * @brief 按 resultFields 的顺序把当前行写入已有对象
+     * @tparam StaticFields 可选的 StaticFieldList，指定时结果列须与其字段列表一致
+     */
+    template<class ObjectType, class StaticFields = void>
+    void MaterializeInto(const WCDB::ResultFields& resultFields, ObjectType& object) const
+    {
+        Detail::RowCodec<ObjectType, StaticFields>::Extract(*m_statement, resultFields, object);
+    }
+
+    /**
+     * @brief 把当前行生成独立的对象，结果列须与 resultFields 一一对应
+     */
+    template<class ObjectType, class StaticFields = void>
+    ObjectType Materialize(const WCDB::ResultFields& resultFields
+                           = Detail::RowCodec<ObjectType, StaticFields>::GetFields()) const
+    {
+        ObjectType object;
+        MaterializeInto<ObjectType, StaticFields>(resultFields, object);
+        return object;
+    }
+
+private:
+    WCDB::StatementOperation* m_statement;
+};
+
+/**
+ * @brief 以行视图方式遍历结果的只进游标
+ * @note 与 Cursor 一样通过 Handle::getOrCreatePreparedStatement 获取语句，使用约束相同
+ */
+class RowCursor {
+public:
+    /**
+     * @param handle 查询使用的 Handle，生命周期须长于游标
+     * @param statement 查询语句
+     */
+    RowCursor(WCDB::Handle& handle, const WCDB::StatementSelect& statement)
+    {
+        auto prepared = handle.getOrCreatePreparedStatement(statement);
+        if (prepared.hasValue()) {
+            m_statement.reset(new WCDB::PreparedStatement(std::move(prepared.value())));
+            m_statement->reset();
+        } else {
+            m_failed = true;
+        }
+    }
+
+    ~RowCursor()
+    {
+        if (m_statement) {
+            m_statement->reset();
+        }
+    }
+
+    RowCursor(const RowCursor&) = delete;
+    RowCursor& operator=(const RowCursor&) = delete;
+
+    /**
+     * @brief 前进到下一行，之前取得的文本视图随之失效
+     * @return 有下一行返回 true；结束或出错返回 false，用 Failed() 区分
+     */
+    bool Next()
+    {
+        if (m_failed || m_done) {
+            return false;
+        }
+        if (!m_statement->step()) {
+            m_failed = true;
+            return false;
+        }
+        if (m_statement->done()) {
+            m_done = true;
+            m_statement->reset();
+            return false;
+        }
+        ++m_position;
+        return true;
+    }
+
+    /**
+     * @brief 当前行的视图，仅在 Next() 返回 true 之后可用
+     */
+    RowView Current() const { return RowView(*m_statement); }
+
+    /**
+     * @brief 已读取的行数
+     */
+    uint64_t Position() const { return m_position; }
+
+    /**
+     * @brief 是否因出错而结束
+     */
+    bool Failed() const { return m_failed; }
+
+private:
+    std::unique_ptr<WCDB::PreparedStatement> m_statement;
+    uint64_t m_position = 0;
+    bool m_done = false;
+    bool m_failed = false;
+};
+
+} // namespace Storage
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file SqlTrace.h
+ * @brief Storage SQL 性能追踪
+ *
+ * 通过 Database::globalTracePerformance / tracePerformance 接收每条语句（或事务）的耗时和页读写数，
+ * 按语句指纹汇总：
+ *
+ * - 指纹：字面量替换为 ?，连续的 ? 列表合并，空白压缩为一个空格，同一模板不同参数的语句归为一类
+ * - 汇总：调用次数、累计和最大耗时、延迟直方图、读写页数，在线程本地累加，写入路径不加锁，
+ *   只有获取快照时才汇总各线程
+ * - 慢查询：耗时超过阈值的语句按指纹写入 spdlog 警告日志，每秒条数受限，超出的只计数
+ * - 导出：快照按累计耗时降序，可导出为 JSON
+ *
+ * 使用示例：
+ * @code
+ * Storage::SqlTraceOptions options;
+ * options.slowQueryMicros = 50 * 1000;
+ * Storage::StartSqlTrace(options);                 // 在所有数据库操作之前调用
+ * ...
+ * std::string json = Storage::GetSqlTraceSnapshot().ToJson(2);
+ * Storage::LogSqlTrace(10);                        // 输出累计耗时最高的 10 类语句
+ * @endcode
+ *
+ * @note WCDB 的性能回调不提供结果行数，以读写页数衡量每类语句的工作量
+ * @note 需链接 libstorage
+ */
+
+namespace Storage {
+
+// 延迟直方图桶数。第 0 个桶为 [0, 2) 微秒，第 i 个桶为 [2^i, 2^(i+1)) 微秒，最后一个桶包含所有更大的值
+constexpr size_t kSqlLatencyBuckets = 24;
+
+// 每个线程最多单独统计的指纹数，超出后的调用只计入 droppedCalls
+constexpr size_t kSqlFingerprintsPerThread = 256;
+
+/**
+ * @brief 追踪选项
+ */
+struct SqlTraceOptions {
+    uint64_t slowQueryMicros = 100 * 1000;   // 慢查询阈值（微秒），0 表示不输出慢查询日志
+    unsigned slowLogsPerSecond = 10;         // 每秒最多输出的慢查询日志条数
+    size_t maxFingerprintLength = 512;       // 指纹文本的最大长度，超出部分截断
+};
+
+/**
+ * @brief 一类语句的统计数据
+ */
+struct SqlTraceEntry {
+    std::string fingerprint;
+    uint64_t calls = 0;
+    uint64_t slowCalls = 0;      // 超过慢查询阈值的调用次数
+    uint64_t totalNanos = 0;
+    uint64_t maxNanos = 0;
+    uint64_t pagesRead = 0;      // 表、索引、溢出页的读取数之和
+    uint64_t pagesWritten = 0;   // 表、索引、溢出页的写入数之和
+    std::array<uint64_t, kSqlLatencyBuckets> latencyHistogram{};
+
+    /**
+     * @brief 按直方图估算延迟分位数
+     * @param percentile 分位数，取值 (0, 1]
+     * @return 所在桶的上界（微秒），没有数据时返回 0
+     */
+    uint64_t LatencyPercentileMicros(double percentile) const;
+};
+
+/**
+ * @brief 追踪快照，按累计耗时降序
+ */
+struct SqlTraceSnapshot {
+    std::vector<SqlTraceEntry> entries;
+    uint64_t droppedCalls = 0;         // 线程指纹表已满而未单独统计的调用数
+    uint64_t suppressedSlowLogs = 0;   // 超出速率限制而未输出的慢查询日志数
+
+    /**
+     * @brief 导出为 JSON 字符串
+     * @param indent 缩进空格数，-1 表示紧凑格式
+     */
+    std::string ToJson(int indent = -1) const;
+};
+
+/**
+ * @brief 计算语句指纹
+ */
+std::string FingerprintSql(const WCDB::UnsafeStringView& sql, size_t maxLength = 512);
+
+/**
+ * @brief 通过 Database::globalTracePerformance 追踪所有数据库
+ * @note 会替换之前注册的全局性能回调；重复调用只更新选项
+ */
+void StartSqlTrace(const SqlTraceOptions& options = SqlTraceOptions());
+
+/**
+ * @brief 通过 Database::tracePerformance 只追踪一个数据库，与全局追踪共用统计
+ */
+void AttachSqlTrace(WCDB::Database& database, const SqlTraceOptions& options = SqlTraceOptions());
+
+/**
+ * @brief 注销全局性能回调并停止记录；通过 AttachSqlTrace 注册的回调也不再记录
+ */
+void StopSqlTrace();
+
+/**
+ * @brief 是否正在记录
+ */
+bool IsSqlTraceEnabled();
+
+/**
+ * @brief 记录一次语句执行，供性能回调或自定义的钩子调用
+ */
+void RecordSql(const WCDB::UnsafeStringView& sql, uint64_t nanos, uint64_t pagesRead, uint64_t pagesWritten);
+
+/**
+ * @brief 获取自进程启动（或上次 ResetSqlTrace）以来的快照
+ */
+SqlTraceSnapshot GetSqlTraceSnapshot();
+
+/**
+ * @brief 重置统计，之后的快照只包含重置后的数据
+ */
+void ResetSqlTrace();
+
+/**
+ * @brief 通过 spdlog 默认 logger 输出累计耗时最高的 top 类语句
+ */
+void LogSqlTrace(size_t top = 10);
+
+} // namespace Storage
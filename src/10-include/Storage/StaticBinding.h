@@ -0,0 +1,215 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <initializer_list>
+#include <string>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file StaticBinding.h
+ * @brief Storage 编译期字段绑定
+ *
+ * WCDB 的 ORM 对每行的每一列都要经过 Field -> BaseAccessor 的虚函数和按列类型的 switch 来绑定/读取。
+ * 对高频表，可以用 STORAGE_FIELD 按 ORM 声明的顺序再列一次字段，生成编译期展开的绑定和读取函数：
+ * 每列直接调用对应类型的 bindInteger / bindText / getInteger / getText，没有访问器虚调用和逐行查找。
+ *
+ * 使用示例：
+ * @code
+ * using ModelSampleFields = Storage::StaticFieldList<
+ *     STORAGE_FIELD(ModelSample, id),
+ *     STORAGE_FIELD(ModelSample, name),
+ *     ...>;
+ *
+ * Storage::Repository<ModelSample, ModelSampleFields> repo(db, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id));
+ * Storage::Cursor<ModelSample, ModelSampleFields> cursor(handle, TABLE_NAME_SAMPLE);
+ * @endcode
+ *
+ * @note 字段类型支持整数、浮点和 std::string。NULL 读为 0 或空字符串
+ * @note 字段列表决定 SQL 中列的顺序，可以只列出部分字段（相当于固定的列投影）
+ */
+
+// 声明一个编译期字段，className::member 须已用 WCDB_CPP_SYNTHESIZE 声明
+#define STORAGE_FIELD(className, member)                                                         \
+    Storage::StaticField<decltype(&className::member), &className::member>
+
+namespace Storage {
+
+/**
+ * @brief 从当前行读取一列到 C++ 值，支持整数、浮点和 std::string
+ */
+template<typename T, typename Enable = void>
+struct ColumnReader;
+
+template<typename T>
+struct ColumnReader<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    static void Read(WCDB::StatementOperation& statement, int index, T& value)
+    {
+        value = static_cast<T>(statement.getInteger(index));
+    }
+};
+
+template<typename T>
+struct ColumnReader<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static void Read(WCDB::StatementOperation& statement, int index, T& value)
+    {
+        value = static_cast<T>(statement.getDouble(index));
+    }
+};
+
+template<>
+struct ColumnReader<std::string> {
+    // 直接从 sqlite3_column_text 的缓冲区赋值，容量足够时不重新分配
+    static void Read(WCDB::StatementOperation& statement, int index, std::string& value)
+    {
+        WCDB::UnsafeStringView text = statement.getText(index);
+        value.assign(text.data(), text.length());
+    }
+};
+
+/**
+ * @brief 把 C++ 值绑定到参数，支持整数、浮点和 std::string
+ */
+template<typename T, typename Enable = void>
+struct ColumnBinder;
+
+template<typename T>
+struct ColumnBinder<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    static void Bind(WCDB::StatementOperation& statement, const T& value, int index)
+    {
+        statement.bindInteger(static_cast<int64_t>(value), index);
+    }
+};
+
+template<typename T>
+struct ColumnBinder<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static void Bind(WCDB::StatementOperation& statement, const T& value, int index)
+    {
+        statement.bindDouble(static_cast<double>(value), index);
+    }
+};
+
+template<>
+struct ColumnBinder<std::string> {
+    static void Bind(WCDB::StatementOperation& statement, const std::string& value, int index)
+    {
+        statement.bindText(WCDB::UnsafeStringView(value.data(), value.size()), index);
+    }
+};
+
+/**
+ * @brief 编译期字段，通过 STORAGE_FIELD 声明
+ */
+template<typename MemberPointer, MemberPointer Pointer>
+struct StaticField;
+
+template<class ORMType, typename ValueType, ValueType ORMType::*Pointer>
+struct StaticField<ValueType ORMType::*, Pointer> {
+    using ObjectType = ORMType;
+
+    static void Bind(WCDB::StatementOperation& statement, const ORMType& object, int index)
+    {
+        ColumnBinder<ValueType>::Bind(statement, object.*Pointer, index);
+    }
+
+    static void Extract(WCDB::StatementOperation& statement, int index, ORMType& object)
+    {
+        ColumnReader<ValueType>::Read(statement, index, object.*Pointer);
+    }
+
+    static WCDB::Field GetField() { return WCDB::Field(Pointer); }
+};
+
+/**
+ * @brief 编译期字段列表，绑定和读取都在编译期展开
+ */
+template<typename... Fields>
+struct StaticFieldList {
+    static constexpr size_t kCount = sizeof...(Fields);
+
+    /**
+     * @brief 按字段顺序绑定到参数 first, first + 1, ...
+     */
+    template<class ObjectType>
+    static void BindAll(WCDB::StatementOperation& statement, const ObjectType& object, int first = 1)
+    {
+        int index = first;
+        (void) std::initializer_list<int>{ (Fields::Bind(statement, object, index++), 0)... };
+    }
+
+    /**
+     * @brief 按字段顺序读取结果列 first, first + 1, ...
+     */
+    template<class ObjectType>
+    static void ExtractAll(WCDB::StatementOperation& statement, ObjectType& object, int first = 0)
+    {
+        int index = first;
+        (void) std::initializer_list<int>{ (Fields::Extract(statement, index++, object), 0)... };
+    }
+
+    /**
+     * @brief 对应的 WCDB 字段，用于生成 SQL
+     */
+    static WCDB::Fields GetFields()
+    {
+        return WCDB::Fields{ Fields::GetField()... };
+    }
+};
+
+/**
+ * @brief 把当前行按 resultFields 的顺序写入已有对象（通用 ORM 路径）
+ * @note 每列都先构造一个 WCDB::Value 再经访问器写入，文本和 BLOB 列每行都会复制到堆上，
+ *       复用对象只省掉对象本身的构造。WCDB 不公开 ResultField 的访问器，无法像 extractOneObject
+ *       那样按列类型直接读取；热点查询应使用 StaticFieldList，按字段类型直接 getInteger / getText
+ */
+template<class ObjectType>
+void ExtractInto(WCDB::StatementOperation& statement, const WCDB::ResultFields& resultFields, ObjectType& object)
+{
+    int index = 0;
+    for (const WCDB::ResultField& field : resultFields) {
+        field.setValue(object, statement.getValue(index));
+        ++index;
+    }
+}
+
+namespace Detail {
+
+/**
+ * @brief 行编解码：StaticFields 为 StaticFieldList 时走编译期路径，为 void 时走 WCDB 通用 ORM 路径
+ */
+template<class ObjectType, class StaticFields>
+struct RowCodec {
+    static WCDB::Fields GetFields() { return StaticFields::GetFields(); }
+
+    static void Bind(WCDB::StatementOperation& statement, const ObjectType& object, const WCDB::Fields&)
+    {
+        StaticFields::BindAll(statement, object);
+    }
+
+    static void Extract(WCDB::StatementOperation& statement, const WCDB::ResultFields&, ObjectType& object)
+    {
+        StaticFields::ExtractAll(statement, object);
+    }
+};
+
+template<class ObjectType>
+struct RowCodec<ObjectType, void> {
+    static WCDB::Fields GetFields() { return ObjectType::allFields(); }
+
+    static void Bind(WCDB::StatementOperation& statement, const ObjectType& object, const WCDB::Fields& fields)
+    {
+        int index = 1;
+        for (const WCDB::Field& field : fields) {
+            statement.bindObject(object, field, index++);
+        }
+    }
+
+    static void Extract(WCDB::StatementOperation& statement, const WCDB::ResultFields& resultFields, ObjectType& object)
+    {
+        ExtractInto(statement, resultFields, object);
+    }
+};
+
+} // namespace Detail
+
+} // namespace Storage
@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * @file Storage.h
+ * @brief Storage 主头文件，包含基于 WCDB 的所有数据访问模块
+ *
+ * 使用示例：
+ * @code
+ * #include <Storage/Storage.h>
+ *
+ * // 按存储介质注册 pragma 配置，在建表之前调用
+ * Storage::ApplyProfile(db, "embedded-flash");
+ *
+ * // 复用预编译语句的单表仓储
+ * Storage::Repository<ModelSample> repo(db, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id));
+ * repo.InsertBatch(models);
+ * auto model = repo.Get(1);
+ *
+ * // 按主键分页遍历，内存占用与表大小无关
+ * Storage::KeysetCursor<ModelSample> cursor(repo.GetHandle(), TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id));
+ * while (cursor.Next()) { ... cursor.Current() ... }
+ *
+ * // 只取上次轮询之后新增或修改的行
+ * Storage::ChangePoller<ModelSample> poller(repo.GetHandle(), TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::updated_at), "consumer");
+ * poller.Poll([](const ModelSample &model, Storage::ChangeKind kind) { ...; return true; });
+ * poller.Commit();
+ *
+ * // 只读取需要的列
+ * Storage::TupleCursor<int64_t, std::string> names(repo.GetHandle(),
+ *     Storage::SelectFields(TABLE_NAME_SAMPLE, { WCDB_FIELD(ModelSample::id), WCDB_FIELD(ModelSample::name) }));
+ *
+ * // 多线程写入合并为 group commit（需链接 libstorage）
+ * Storage::WriteBehindQueue queue(db);
+ * queue.InsertObject(model, TABLE_NAME_SAMPLE, [](bool committed) { ... });
+ *
+ * // 插入前分配时间有序的 64 位主键（需链接 libutility）
+ * Storage::AssignIds(keyedModels, &ModelSampleKeyed::id);
+ *
+ * // 高频表用编译期字段列表绑定和读取，绕过 ORM 访问器
+ * using ModelSampleFields = Storage::StaticFieldList<STORAGE_FIELD(ModelSample, id), STORAGE_FIELD(ModelSample, name), ...>;
+ * Storage::Repository<ModelSample, ModelSampleFields> fastRepo(db, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id));
+ *
+ * // 扫描聚合时直接读取语句内部的列数据，不为每行分配内存
+ * Storage::RowCursor rows(repo.GetHandle(), Storage::SelectFields(TABLE_NAME_SAMPLE, { WCDB_FIELD(ModelSample::age) }));
+ * while (rows.Next()) { ageSum += rows.Current().GetInteger(0); }
+ *
+ * // 数值列按批读成连续数组，交给 Utility::Aggregate 做向量化聚合（需链接 libutility）
+ * Storage::ColumnarCursor columns(repo.GetHandle(), Storage::SelectFields(TABLE_NAME_SAMPLE, { WCDB_FIELD(ModelSample::age) }),
+ *                                 { Storage::ColumnKind::Integer });
+ *
+ * // 启动或测试时检查热点查询是否命中索引
+ * Storage::QueryPlanChecker checker;
+ * checker.Register("sample by name", selectByName);
+ * for (const Storage::PlanReport &report : checker.Problems(repo.GetHandle())) { ... report.Describe() ... }
+ *
+ * // 时间字段保存为整数毫秒，按半开区间查询
+ * model.created_at = Storage::NowMillis();
+ * auto lastHour = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE,
+ *     Storage::TimeRange(WCDB_FIELD(ModelSample::created_at), now - 3600 * 1000, now));
+ *
+ * // 低基数字符串列保存为字典编码，内存中为共享的只读句柄
+ * Storage::StringDictionary::Shared().Attach(db);
+ * interned.city = Storage::StringDictionary::Shared().Intern("Beijing").value();
+ *
+ * // 遥测表按天或按月分区，清理时整表删除
+ * Storage::PartitionedTable<ModelSample> partitions(db, TABLE_NAME_SAMPLE, &ModelSample::created_at,
+ *     WCDB_FIELD(ModelSample::created_at), Storage::PartitionGranularity::Day);
+ * partitions.InsertBatch(models);
+ * partitions.DropBefore(Storage::NowMillis() - 30LL * 86400000);
+ *
+ * // 高频采样按序列压缩成块存储（需链接 libstorage 和 libutility）
+ * Storage::TimeSeriesStore series(db);
+ * series.Append("cpu.temp", Storage::NowMillis(), 45.5);
+ * auto lastHour = series.Query("cpu.temp", now - 3600 * 1000, now);
+ *
+ * // 看板查询读取增量维护的 1m / 15m / 1h 汇总表（需链接 libstorage）
+ * Storage::RollupEngine rollup(db, source);
+ * rollup.InsertObjects(models, &ModelSample::created_at);
+ * rollup.Refresh();
+ * auto hourly = rollup.Query("Beijing", now - 7 * 86400000LL, now, 3600 * 1000);
+ *
+ * // 接管 WAL 检查点，在写入间隙执行并限制写回速率（需链接 libstorage）
+ * Storage::CheckpointScheduler checkpoints(db);
+ *
+ * // 删除后在空闲时分片回收空闲页，文件大小随之回落（需链接 libstorage）
+ * Storage::SpaceReclaimer reclaimer(db);
+ *
+ * // 按语句指纹汇总耗时并输出慢查询日志，快照可导出为 JSON（需链接 libstorage）
+ * Storage::StartSqlTrace();
+ * std::string json = Storage::GetSqlTraceSnapshot().ToJson();
+ * @endcode
+ */
+
+#include "Tuning.h"
+#include "StaticBinding.h"
+#include "Repository.h"
+#include "Cursor.h"
+#include "ChangePoller.h"
+#include "Projection.h"
+#include "RowView.h"
+#include "Columnar.h"
+#include "QueryPlan.h"
+#include "Timestamp.h"
+#include "InternedString.h"
+#include "Partition.h"
+#include "WriteBehind.h"
+#include "TimeSeries.h"
+#include "Rollup.h"
+#include "Checkpoint.h"
+#include "Reclaim.h"
+#include "SqlTrace.h"
+#include "ClientId.h"
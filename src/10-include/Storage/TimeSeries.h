@@ -0,0 +1,145 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include "Utility/Aggregate.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file TimeSeries.h
+ * @brief Storage 压缩列式时序存储
+ *
+ * 每秒一个采样点按一行一个对象存储时，每行连同 rowid、索引项约占几十字节，几个月的数据就会占满小容量闪存。
+ * TimeSeriesStore 按序列在内存中缓冲采样点，攒满一块后封块：
+ *
+ * - 编码：时间戳按差分的差分（delta-of-delta）写成 zigzag 变长整数，等间隔采样时几乎全为 0；
+ *   数值与前一个值按位异或后按字节拆成 8 个平面，变化缓慢的数据高位平面几乎全为 0
+ * - 压缩：编码结果交给 Utility::Compression::Compress，每块作为一行 BLOB 写入块表
+ * - 元数据：每块同时保存时间范围和 count / min / max / sum，
+ *   Query 只解压与查询范围重叠的块，Summarize 对完全落在范围内的块直接使用元数据
+ *
+ * 使用示例：
+ * @code
+ * Storage::TimeSeriesStore store(db);
+ * store.Append("cpu.temp", Storage::NowMillis(), 45.5);
+ * auto lastHour = store.Query("cpu.temp", now - 3600 * 1000, now);
+ * auto summary = store.Summarize("cpu.temp", now - 86400000, now);
+ * store.Flush();                               // 退出前把未满的块写入数据库
+ * store.DropBefore(now - 90LL * 86400000);     // 删除早于 90 天的块
+ * @endcode
+ *
+ * @note 需链接 libstorage 和 libutility
+ * @note 未封块的采样点只在内存中，进程异常退出时丢失；需要更强的持久性时缩小 pointsPerBlock 或定期 Flush
+ */
+
+namespace Storage {
+
+/**
+ * @brief 时序采样点
+ */
+struct TimeSeriesPoint {
+    int64_t timestamp = 0;   // Unix 毫秒
+    double value = 0;
+};
+
+/**
+ * @brief 时序存储选项
+ */
+struct TimeSeriesOptions {
+    std::string table = "timeseries_block";   // 块表名
+    size_t pointsPerBlock = 3600;              // 每块的采样点数，每秒一点时为一小时
+    int compressionLevel = 3;                  // 压缩级别，见 Utility::Compression::Compress
+};
+
+/**
+ * @brief 时序存储统计
+ */
+struct TimeSeriesStats {
+    uint64_t appendedPoints = 0;    // 已接收的采样点数
+    uint64_t sealedPoints = 0;      // 已封块写入的采样点数
+    uint64_t sealedBlocks = 0;      // 已写入的块数
+    uint64_t encodedBytes = 0;      // 已写入块编码后、压缩前的字节数
+    uint64_t storedBytes = 0;       // 已写入块压缩后的字节数
+    uint64_t failedBlocks = 0;      // 压缩或写入失败的块数
+    size_t bufferedPoints = 0;      // 当前未封块的采样点数
+};
+
+/**
+ * @brief 压缩列式时序存储
+ * @note 线程安全
+ */
+class TimeSeriesStore {
+public:
+    /**
+     * @brief 创建块表和索引（已存在时直接使用）
+     * @param database 数据库对象，生命周期须长于 TimeSeriesStore
+     */
+    TimeSeriesStore(WCDB::Database& database, const TimeSeriesOptions& options = TimeSeriesOptions());
+
+    /**
+     * @brief 把未满的块写入数据库
+     */
+    ~TimeSeriesStore();
+
+    TimeSeriesStore(const TimeSeriesStore&) = delete;
+    TimeSeriesStore& operator=(const TimeSeriesStore&) = delete;
+
+    /**
+     * @brief 块表是否已创建成功
+     */
+    bool IsValid() const;
+
+    /**
+     * @brief 追加一个采样点，缓冲区攒满 pointsPerBlock 个点时封块写入
+     * @return 封块写入失败时返回 false，该块的采样点保留在缓冲区中，下次封块时重试
+     */
+    bool Append(const std::string& series, int64_t timestamp, double value);
+
+    /**
+     * @brief 追加一批采样点
+     */
+    bool AppendBatch(const std::string& series, const std::vector<TimeSeriesPoint>& points);
+
+    /**
+     * @brief 把所有序列未满的块写入数据库
+     * @return 全部写入成功返回 true
+     */
+    bool Flush();
+
+    /**
+     * @brief 查询 [from, to) 内的采样点，包括尚未封块的点
+     * @return 按时间升序；读取或解压失败时返回空
+     */
+    WCDB::Optional<std::vector<TimeSeriesPoint>> Query(const std::string& series, int64_t from, int64_t to);
+
+    /**
+     * @brief 统计 [from, to) 内采样值的 count / sum / min / max
+     * @note 完全落在范围内的块只读元数据，不解压
+     */
+    WCDB::Optional<Utility::Aggregate::Summary<double>> Summarize(const std::string& series, int64_t from, int64_t to);
+
+    /**
+     * @brief 删除所有序列中最后一个点早于 cutoff 的块
+     * @return 删除的块数，出错时返回空
+     */
+    WCDB::Optional<size_t> DropBefore(int64_t cutoff);
+
+    /**
+     * @brief 有数据的序列名，包括只在缓冲区中的序列
+     */
+    WCDB::Optional<std::vector<std::string>> ListSeries();
+
+    /**
+     * @brief 获取统计数据
+     */
+    TimeSeriesStats GetStats() const;
+
+    class Impl;
+
+private:
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Storage
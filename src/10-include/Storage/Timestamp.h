@@ -0,0 +1,307 @@
+#pragma once
+
+#include "ChangePoller.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file Timestamp.h
+ * @brief Storage 整数时间戳
+ *
+ * 时间字段统一保存为 INTEGER 的 Unix 毫秒（UTC），模型中声明为 int64_t：
+ * 比较和排序是整数比较，索引更小，每行占 1~8 字节而不是 19 字节以上的文本。
+ *
+ * - NowMillis / ToMillis / FromMillis：与 std::chrono 互转
+ * - FormatTimestamp / ParseTimestamp：与 "YYYY-MM-DD HH:MM:SS.sss" 文本互转，用于日志和旧数据
+ * - TimeRange / TimeRangeParameters：半开区间 [from, to) 的查询条件，可走时间字段上的索引
+ * - MigrateTextTimestamps：把旧表中的文本时间列迁移为整数毫秒
+ *
+ * 使用示例：
+ * @code
+ * model.created_at = Storage::NowMillis();
+ * auto lastHour = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE,
+ *     Storage::TimeRange(WCDB_FIELD(ModelSample::created_at), now - 3600 * 1000, now));
+ *
+ * // 启动时、createTable 之前执行一次，已是整数列时直接返回
+ * Storage::MigrateTextTimestamps<ModelSample>(handle, TABLE_NAME_SAMPLE, { "created_at", "updated_at" });
+ * @endcode
+ */
+
+namespace Storage {
+
+/**
+ * @brief 当前时间的 Unix 毫秒
+ */
+inline int64_t NowMillis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+inline int64_t ToMillis(const std::chrono::system_clock::time_point& timePoint)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(timePoint.time_since_epoch()).count();
+}
+
+inline std::chrono::system_clock::time_point FromMillis(int64_t millis)
+{
+    return std::chrono::system_clock::time_point(
+    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(millis)));
+}
+
+namespace Detail {
+
+// 公历日期与 1970-01-01 起的天数互转（Howard Hinnant 的 days_from_civil 算法），不依赖 timegm / gmtime_r
+inline int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day)
+{
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = (unsigned) (year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t) dayOfEra - 719468;
+}
+
+inline void CivilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day)
+{
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = (unsigned) (days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = (int64_t) yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+} // namespace Detail
+
+/**
+ * @brief 格式化为 UTC 文本 "YYYY-MM-DD HH:MM:SS.sss"
+ * @param withMillis 为 false 时省略毫秒部分
+ */
+inline std::string FormatTimestamp(int64_t millis, bool withMillis = true)
+{
+    const int64_t msPerDay = 86400000;
+    int64_t days = millis >= 0 ? millis / msPerDay : -((-millis + msPerDay - 1) / msPerDay);
+    int64_t rest = millis - days * msPerDay;
+    int64_t year;
+    unsigned month;
+    unsigned day;
+    Detail::CivilFromDays(days, year, month, day);
+
+    char buffer[40];
+    int hour = (int) (rest / 3600000);
+    int minute = (int) (rest / 60000 % 60);
+    int second = (int) (rest / 1000 % 60);
+    if (withMillis) {
+        snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u %02d:%02d:%02d.%03d", (long long) year, month, day,
+                 hour, minute, second, (int) (rest % 1000));
+    } else {
+        snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u %02d:%02d:%02d", (long long) year, month, day,
+                 hour, minute, second);
+    }
+    return buffer;
+}
+
+/**
+ * @brief 解析 UTC 文本时间
+ *
+ * 支持 "YYYY-MM-DD"、"YYYY-MM-DD HH:MM"、"YYYY-MM-DD HH:MM:SS" 和 "YYYY-MM-DD HH:MM:SS.sss"，
+ * 日期与时间之间可用 'T' 分隔，末尾可带 'Z'。与 SQLite julianday() 接受的常用格式一致
+ * @return 格式不正确时返回空
+ */
+inline WCDB::Optional<int64_t> ParseTimestamp(const std::string& text)
+{
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    unsigned hour = 0;
+    unsigned minute = 0;
+    unsigned second = 0;
+    int consumed = 0;
+    if (sscanf(text.c_str(), "%4d-%2u-%2u%n", &year, &month, &day, &consumed) != 3 || consumed != 10) {
+        return WCDB::NullOpt;
+    }
+    size_t pos = 10;
+    if (pos < text.size() && (text[pos] == ' ' || text[pos] == 'T')) {
+        int timeConsumed = 0;
+        if (sscanf(text.c_str() + pos + 1, "%2u:%2u%n", &hour, &minute, &timeConsumed) != 2 || timeConsumed != 5) {
+            return WCDB::NullOpt;
+        }
+        pos += 6;
+        if (pos < text.size() && text[pos] == ':') {
+            if (sscanf(text.c_str() + pos + 1, "%2u%n", &second, &timeConsumed) != 1 || timeConsumed != 2) {
+                return WCDB::NullOpt;
+            }
+            pos += 3;
+        }
+    }
+    int64_t millis = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        // 只取前三位小数，更多位数截断
+        int64_t scale = 100;
+        ++pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            millis += (text[pos] - '0') * scale;
+            scale /= 10;
+            ++pos;
+        }
+    }
+    if (pos < text.size() && text[pos] == 'Z') {
+        ++pos;
+    }
+    if (pos != text.size() || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59
+        || second > 59) {
+        return WCDB::NullOpt;
+    }
+    int64_t days = Detail::DaysFromCivil(year, month, day);
+    return ((days * 24 + hour) * 60 + minute) * 60000 + second * 1000 + millis;
+}
+
+/**
+ * @brief 半开区间 field >= from AND field < to
+ */
+inline WCDB::Expression TimeRange(const WCDB::Field& field, int64_t from, int64_t to)
+{
+    return field >= from && field < to;
+}
+
+/**
+ * @brief 参数化的半开区间 field >= ?first AND field < ?(first + 1)，用于预编译复用
+ */
+inline WCDB::Expression TimeRangeParameters(const WCDB::Field& field, int first = 1)
+{
+    return field >= WCDB::BindParameter(first) && field < WCDB::BindParameter(first + 1);
+}
+
+/**
+ * @brief SQL 中把时间列转换为 Unix 毫秒的表达式
+ *
+ * 整数和浮点原样取整；文本按 julianday() 解析，无法解析或为 NULL 时结果为 NULL
+ */
+inline WCDB::Expression TextToMillis(const WCDB::Expression& column)
+{
+    WCDB::Expression type = WCDB::CoreFunction::typeof_(column);
+    WCDB::Expression julian = WCDB::Expression::function("julianday").invoke().argument(column);
+    // 2440587.5 为 1970-01-01 00:00:00 UTC 的儒略日
+    return WCDB::Expression::case_()
+    .when(type == "integer" || type == "real")
+    .then(WCDB::Expression::cast(column).as(WCDB::ColumnType::Integer))
+    .else_(WCDB::Expression::cast(WCDB::CoreFunction::round((julian - 2440587.5) * 86400000.0))
+           .as(WCDB::ColumnType::Integer));
+}
+
+/**
+ * @brief 把旧表中的文本时间列迁移为 INTEGER 毫秒
+ *
+ * SQLite 不能修改列类型，且 TEXT 亲和性的列会把写入的整数转回文本，因此需要重建表：
+ * 在一个事务中删除旧索引、把旧表改名、按当前 ORM 定义建新表（含索引）、转换并复制数据、删除旧表。
+ * 同时把 ChangePoller 水位表中该表的文本水位转换为毫秒。
+ *
+ * @tparam ObjectType 新的模型类型，时间字段已声明为整数
+ * @param handle 执行迁移的 Handle
+ * @param table 表名
+ * @param columns 需要迁移的时间列
+ * @return 迁移成功、表不存在或各列已是 INTEGER 时返回 true
+ * @note 须在 createTable 之前调用；两个模型都有的列原样复制，新增的列取默认值
+ */
+template<class ObjectType>
+bool MigrateTextTimestamps(WCDB::Handle& handle, const std::string& table, const std::vector<std::string>& columns)
+{
+    WCDB::StatementPragma tableInfo;
+    tableInfo.pragma(WCDB::Pragma::tableInfo()).with(table);
+    auto info = handle.getAllRowsFromStatement(tableInfo);
+    if (!info.hasValue()) {
+        return false;
+    }
+    // table_info 的结果列为 cid, name, type, notnull, dflt_value, pk
+    std::vector<std::string> existing;
+    bool needed = false;
+    for (const WCDB::OneRowValue& row : info.value()) {
+        std::string name = row[1].textValue();
+        std::string type = row[2].textValue();
+        existing.push_back(name);
+        for (const std::string& column : columns) {
+            if (column == name && type != "INTEGER" && type != "integer") {
+                needed = true;
+            }
+        }
+    }
+    if (!needed) {
+        return true;
+    }
+
+    return handle.runTransaction([&](WCDB::Handle& inTransaction) {
+        // 索引名与表绑定而不随表改名，先删除旧索引，新表建表时按 ORM 定义重建
+        WCDB::StatementSelect indexes;
+        indexes.select(WCDB::Column("name"))
+        .from("sqlite_master")
+        .where(WCDB::Column("type") == "index" && WCDB::Column("tbl_name") == table
+               && WCDB::Column("sql").notNull());
+        auto names = inTransaction.getAllRowsFromStatement(indexes);
+        if (!names.hasValue()) {
+            return false;
+        }
+        for (const WCDB::OneRowValue& row : names.value()) {
+            if (!inTransaction.dropIndex(row[0].textValue())) {
+                return false;
+            }
+        }
+
+        const std::string backup = table + "_text_timestamp_backup";
+        if (!inTransaction.dropTable(backup)
+            || !inTransaction.execute(WCDB::StatementAlterTable().alterTable(table).renameToTable(backup))
+            || !inTransaction.template createTable<ObjectType>(table)) {
+            return false;
+        }
+
+        WCDB::Columns targets;
+        WCDB::ResultColumns sources;
+        for (const WCDB::Field& field : ObjectType::allFields()) {
+            std::string name = field.syntax().name.data();
+            bool copied = false;
+            for (const std::string& column : existing) {
+                copied = copied || column == name;
+            }
+            if (!copied) {
+                continue;
+            }
+            bool converted = false;
+            for (const std::string& column : columns) {
+                converted = converted || column == name;
+            }
+            targets.push_back(WCDB::Column(name));
+            sources.push_back(converted ? WCDB::ResultColumn(TextToMillis(WCDB::Column(name)))
+                                        : WCDB::ResultColumn(WCDB::Column(name)));
+        }
+        WCDB::StatementInsert copy;
+        copy.insertIntoTable(table).columns(targets).values(WCDB::StatementSelect().select(sources).from(backup));
+        if (!inTransaction.execute(copy) || !inTransaction.dropTable(backup)) {
+            return false;
+        }
+
+        auto hasWatermark = inTransaction.tableExists(TABLE_NAME_WATERMARK);
+        if (!hasWatermark.hasValue()) {
+            return false;
+        }
+        if (hasWatermark.value()) {
+            WCDB::Column value("updated_value");
+            WCDB::StatementUpdate watermark;
+            watermark.update(TABLE_NAME_WATERMARK)
+            .set(value)
+            .to(TextToMillis(value))
+            .where(WCDB::Column("table_name") == table && WCDB::CoreFunction::typeof_(value) == "text");
+            if (!inTransaction.execute(watermark)) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+} // namespace Storage
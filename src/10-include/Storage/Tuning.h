@@ -0,0 +1,279 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include "Checkpoint.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file Tuning.h
+ * @brief Storage 按存储介质调优的 pragma 配置
+ *
+ * WCDB::Database 默认使用 SQLite 的通用参数。TuningProfile 把与硬件相关的 pragma 归成一组，
+ * 通过 Database::setConfig 注册，数据库的每个句柄在下次使用前都会执行：
+ *
+ * - "embedded-flash"：小容量闪存。页大小与擦除块对齐，页缓存小，synchronous = NORMAL 减少 fsync，
+ *   临时表放内存，WAL 攒到较大再回写，减少闪存写入次数
+ * - "ram-disk"：内存盘或 tmpfs。fsync 没有意义，synchronous = OFF，mmap 和页缓存都较大
+ * - "bulk-import"：一次性导入。synchronous = OFF、大页缓存、大页、WAL 攒得更多，导入结束后应切回其他配置
+ * - "default"：不修改任何参数，用作对比基线
+ *
+ * 使用示例：
+ * @code
+ * WCDB::Database db("./test.db");
+ * Storage::ApplyProfile(db, "embedded-flash");    // 在建表之前调用，page_size 才对新文件生效
+ *
+ * Storage::TuningProfile custom = Storage::FindProfile("ram-disk").value();
+ * custom.cacheSizeKiB = 16 * 1024;
+ * Storage::ApplyProfile(db, custom);               // 替换之前的配置
+ * @endcode
+ *
+ * @note page_size 只对尚未写入任何页的新数据库文件生效，已有文件需 VACUUM 且不在 WAL 模式下才会改变
+ * @note synchronous = OFF 时掉电可能损坏数据库，只应用于内存盘或可以重新导入的数据
+ * @note 检查点的归属见 Checkpoint.h。ApplyProfile 只会关闭 WCDB 的自动检查点，不会打开它
+ */
+
+namespace Storage {
+
+const std::string TUNING_CONFIG_NAME = "storage_tuning";
+
+/**
+ * @brief PRAGMA synchronous 的取值
+ */
+enum class SyncMode : int {
+    Off = 0,      // 不 fsync
+    Normal = 1,   // WAL 模式下只在检查点时 fsync，掉电可能丢失最后的事务但不会损坏
+    Full = 2,     // 每次提交 fsync
+    Extra = 3,
+};
+
+/**
+ * @brief PRAGMA temp_store 的取值
+ */
+enum class TempStoreMode : int {
+    Default = 0,
+    File = 1,
+    Memory = 2,
+};
+
+/**
+ * @brief 一组调优参数，未设置的项保持数据库原有的值
+ */
+struct TuningProfile {
+    std::string name;
+    WCDB::Optional<int64_t> pageSize;            // 页大小（字节），512~65536 的 2 的幂
+    WCDB::Optional<int64_t> mmapSize;            // 内存映射读取的上限（字节），0 表示关闭
+    WCDB::Optional<int64_t> cacheSizeKiB;        // 每个句柄的页缓存预算（KiB）
+    WCDB::Optional<int64_t> walAutocheckpoint;   // WAL 达到多少页时检查点，0 表示不检查点；设置后关闭 WCDB 的自动检查点
+    WCDB::Optional<SyncMode> synchronous;
+    WCDB::Optional<TempStoreMode> tempStore;
+};
+
+/**
+ * @brief 内置配置的名字
+ */
+inline std::vector<std::string> ProfileNames()
+{
+    return { "default", "embedded-flash", "ram-disk", "bulk-import" };
+}
+
+/**
+ * @brief 按名字查找内置配置
+ * @return 未知的名字返回空
+ */
+inline WCDB::Optional<TuningProfile> FindProfile(const std::string& name)
+{
+    TuningProfile profile;
+    profile.name = name;
+    if (name == "default") {
+        return profile;
+    }
+    if (name == "embedded-flash") {
+        profile.pageSize = 4096;
+        profile.mmapSize = 16LL << 20;
+        profile.cacheSizeKiB = 2048;
+        profile.walAutocheckpoint = 4000;
+        profile.synchronous = SyncMode::Normal;
+        profile.tempStore = TempStoreMode::Memory;
+        return profile;
+    }
+    if (name == "ram-disk") {
+        profile.pageSize = 4096;
+        profile.mmapSize = 256LL << 20;
+        profile.cacheSizeKiB = 64 * 1024;
+        profile.synchronous = SyncMode::Off;
+        profile.tempStore = TempStoreMode::Memory;
+        return profile;
+    }
+    if (name == "bulk-import") {
+        profile.pageSize = 8192;
+        profile.mmapSize = 256LL << 20;
+        profile.cacheSizeKiB = 256 * 1024;
+        profile.walAutocheckpoint = 16000;
+        profile.synchronous = SyncMode::Off;
+        profile.tempStore = TempStoreMode::Memory;
+        return profile;
+    }
+    return WCDB::NullOpt;
+}
+
+/**
+ * @brief 配置对应的 pragma 语句，按执行顺序排列
+ * @note page_size 排在最前，须在任何读写之前执行
+ */
+inline std::vector<WCDB::StatementPragma> ProfilePragmas(const TuningProfile& profile)
+{
+    std::vector<WCDB::StatementPragma> pragmas;
+    if (profile.pageSize.hasValue()) {
+        pragmas.push_back(WCDB::StatementPragma().pragma(WCDB::Pragma::pageSize()).to(profile.pageSize.value()));
+    }
+    if (profile.mmapSize.hasValue()) {
+        pragmas.push_back(WCDB::StatementPragma().pragma(WCDB::Pragma::mmapSize()).to(profile.mmapSize.value()));
+    }
+    if (profile.cacheSizeKiB.hasValue()) {
+        // 负数表示按 KiB 计算，与页大小无关
+        pragmas.push_back(WCDB::StatementPragma().pragma(WCDB::Pragma::cacheSize()).to(-profile.cacheSizeKiB.value()));
+    }
+    if (profile.walAutocheckpoint.hasValue()) {
+        pragmas.push_back(WCDB::StatementPragma().pragma(WCDB::Pragma::walAutocheckpoint())
+                          .to(profile.walAutocheckpoint.value()));
+    }
+    if (profile.synchronous.hasValue()) {
+        pragmas.push_back(WCDB::StatementPragma().pragma(WCDB::Pragma::synchronous())
+                          .to((int64_t) profile.synchronous.value()));
+    }
+    if (profile.tempStore.hasValue()) {
+        pragmas.push_back(WCDB::StatementPragma().pragma(WCDB::Pragma::tempStore())
+                          .to((int64_t) profile.tempStore.value()));
+    }
+    return pragmas;
+}
+
+/**
+ * @brief 检查参数范围
+ */
+inline bool IsValidProfile(const TuningProfile& profile)
+{
+    if (profile.pageSize.hasValue()) {
+        int64_t size = profile.pageSize.value();
+        if (size < 512 || size > 65536 || (size & (size - 1)) != 0) {
+            return false;
+        }
+    }
+    return (!profile.mmapSize.hasValue() || profile.mmapSize.value() >= 0)
+           && (!profile.cacheSizeKiB.hasValue() || profile.cacheSizeKiB.value() > 0)
+           && (!profile.walAutocheckpoint.hasValue() || profile.walAutocheckpoint.value() >= 0);
+}
+
+/**
+ * @brief 为数据库注册调优配置，替换之前通过 ApplyProfile 注册的配置
+ * @return 参数不合法或数据库无法打开时返回 false
+ * @note 正在执行语句的句柄在下次使用前才会应用新配置
+ */
+inline bool ApplyProfile(WCDB::Database& database, const TuningProfile& profile)
+{
+    if (!IsValidProfile(profile)) {
+        return false;
+    }
+    std::vector<WCDB::StatementPragma> pragmas = ProfilePragmas(profile);
+    // 改用 SQLite 的检查点阈值时关闭 WCDB 的后台检查点，两者会互相覆盖 WAL 钩子。
+    // 不设置时保持原状，以免打开 CheckpointScheduler 等其他组件关闭的自动检查点
+    if (profile.walAutocheckpoint.hasValue() && !HoldsAutoCheckpoint(database, TUNING_CONFIG_NAME)) {
+        DisableAutoCheckpoint(database, TUNING_CONFIG_NAME);
+    }
+    database.setConfig(
+    TUNING_CONFIG_NAME,
+    [pragmas](WCDB::Handle& handle) {
+        for (const WCDB::StatementPragma& pragma : pragmas) {
+            if (!handle.execute(pragma)) {
+                return false;
+            }
+        }
+        return true;
+    },
+    [](WCDB::Handle& handle) {
+        // 移除配置时恢复 SQLite 的默认值
+        return handle.execute(WCDB::StatementPragma().pragma(WCDB::Pragma::mmapSize()).to(0))
+               && handle.execute(WCDB::StatementPragma().pragma(WCDB::Pragma::cacheSize()).to(-2000))
+               && handle.execute(WCDB::StatementPragma().pragma(WCDB::Pragma::synchronous()).to((int64_t) SyncMode::Full))
+               && handle.execute(WCDB::StatementPragma().pragma(WCDB::Pragma::tempStore()).to((int64_t) TempStoreMode::Default));
+    });
+    return database.canOpen();
+}
+
+/**
+ * @brief 按名字注册内置配置
+ * @return 未知的名字返回 false
+ */
+inline bool ApplyProfile(WCDB::Database& database, const std::string& name)
+{
+    WCDB::Optional<TuningProfile> profile = FindProfile(name);
+    return profile.hasValue() && ApplyProfile(database, profile.value());
+}
+
+/**
+ * @brief 移除调优配置，归还调优配置对 WCDB 自动检查点的关闭
+ * @note 没有其他组件关闭自动检查点时才会重新开启
+ */
+inline void RemoveProfile(WCDB::Database& database)
+{
+    database.removeConfig(TUNING_CONFIG_NAME);
+    RestoreAutoCheckpoint(database, TUNING_CONFIG_NAME);
+}
+
+/**
+ * @brief 读取句柄当前生效的参数，用于确认配置是否生效
+ * @return 读取失败的项为空
+ */
+inline TuningProfile ReadTuning(WCDB::Handle& handle)
+{
+    TuningProfile effective;
+    effective.name = "effective";
+    auto read = [&handle](const WCDB::Pragma& pragma) -> WCDB::Optional<int64_t> {
+        auto value = handle.getValueFromStatement(WCDB::StatementPragma().pragma(pragma));
+        if (!value.hasValue()) {
+            return WCDB::NullOpt;
+        }
+        return value.value().intValue();
+    };
+    effective.pageSize = read(WCDB::Pragma::pageSize());
+    effective.mmapSize = read(WCDB::Pragma::mmapSize());
+    WCDB::Optional<int64_t> cacheSize = read(WCDB::Pragma::cacheSize());
+    if (cacheSize.hasValue() && effective.pageSize.hasValue()) {
+        effective.cacheSizeKiB = cacheSize.value() < 0 ? -cacheSize.value()
+                                                       : cacheSize.value() * effective.pageSize.value() / 1024;
+    }
+    effective.walAutocheckpoint = read(WCDB::Pragma::walAutocheckpoint());
+    WCDB::Optional<int64_t> synchronous = read(WCDB::Pragma::synchronous());
+    if (synchronous.hasValue()) {
+        effective.synchronous = (SyncMode) synchronous.value();
+    }
+    WCDB::Optional<int64_t> tempStore = read(WCDB::Pragma::tempStore());
+    if (tempStore.hasValue()) {
+        effective.tempStore = (TempStoreMode) tempStore.value();
+    }
+    return effective;
+}
+
+/**
+ * @brief 参数的单行描述，用于日志
+ */
+inline std::string DescribeTuning(const TuningProfile& profile)
+{
+    auto item = [](const char* key, const WCDB::Optional<int64_t>& value) {
+        return std::string(key) + "=" + (value.hasValue() ? std::to_string(value.value()) : std::string("-"));
+    };
+    std::string text = profile.name + ":";
+    text += " " + item("page_size", profile.pageSize);
+    text += " " + item("mmap_size", profile.mmapSize);
+    text += " " + item("cache_kib", profile.cacheSizeKiB);
+    text += " " + item("wal_autocheckpoint", profile.walAutocheckpoint);
+    text += " synchronous=" + (profile.synchronous.hasValue() ? std::to_string((int) profile.synchronous.value())
+                                                              : std::string("-"));
+    text += " temp_store=" + (profile.tempStore.hasValue() ? std::to_string((int) profile.tempStore.value())
+                                                           : std::string("-"));
+    return text;
+}
+
+} // namespace Storage
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file WriteBehind.h
+ * @brief Storage 异步写入队列（group commit）
+ *
+ * 多个线程逐条写入时，每条写入都是一个独立事务和一次 fsync。WriteBehindQueue 接收写操作后立即返回，
+ * 由专用写线程把一个刷新窗口内积累的操作合并到同一个事务中提交，提交后再回调通知持久化结果。
+ *
+ * 使用示例：
+ * @code
+ * Storage::WriteBehindOptions options;
+ * options.flushIntervalMillis = 10;
+ * Storage::WriteBehindQueue queue(db, options);
+ *
+ * // 各生产者线程
+ * queue.InsertObject(model, TABLE_NAME_SAMPLE, [](bool committed) { ... });
+ *
+ * // 需要确认之前的写入都已提交时
+ * queue.Flush();
+ * @endcode
+ */
+
+namespace Storage {
+
+/**
+ * @brief 队列满时的处理方式
+ */
+enum class OverflowPolicy {
+    Block = 0,  // 阻塞提交线程直到有空位（或超时）
+    Reject      // 立即返回 false
+};
+
+/**
+ * @brief 写入队列选项
+ */
+struct WriteBehindOptions {
+    size_t capacity = 4096;               // 等待提交的操作数上限，超出后按 overflow 处理
+    unsigned flushIntervalMillis = 10;    // 刷新窗口：第一条操作入队后最多等待多久提交
+    size_t maxBatch = 1000;               // 单个事务最多包含的操作数，积累到该数量立即提交
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    unsigned submitTimeoutMillis = 0;     // Block 模式下的最长等待时间，0 表示一直等待
+};
+
+/**
+ * @brief 写入队列统计
+ */
+struct WriteBehindStats {
+    uint64_t submitted = 0;      // 已接收的操作数
+    uint64_t committed = 0;      // 已提交成功的操作数
+    uint64_t failed = 0;         // 执行失败的操作数
+    uint64_t rejected = 0;       // 队列满而被拒绝的操作数
+    uint64_t transactions = 0;   // 已提交的事务数
+    uint64_t retries = 0;        // 批量事务失败后逐条重试的次数
+    size_t pending = 0;          // 当前等待提交的操作数
+    size_t maxPending = 0;       // 等待提交的操作数峰值
+};
+
+/**
+ * @brief 异步写入队列
+ *
+ * - 提交：生产者只在入队时短暂持有锁，写线程一次取走整批，竞争很低
+ * - 合并：第一条操作入队后等待 flushIntervalMillis，或积累到 maxBatch 条，把整批放进一个事务
+ * - 失败隔离：批量事务失败时回滚，再把该批操作逐条单独提交，只有出错的操作回调 false
+ * - 背压：等待提交的操作达到 capacity 后，按 overflow 阻塞或拒绝
+ *
+ * @note 回调在写线程中、事务提交之后调用，回调内不要执行耗时操作，也不要调用 Flush()
+ * @note 提交后数据是否落盘取决于 PRAGMA synchronous 设置
+ */
+class WriteBehindQueue {
+public:
+    // 写操作，在写线程的事务中执行，返回 false 表示失败
+    using Operation = std::function<bool(WCDB::Handle&)>;
+    // 持久化回调，committed 为 true 表示所在事务已提交
+    using DurableCallback = std::function<void(bool committed)>;
+
+    /**
+     * @brief 创建队列并启动写线程
+     * @param database 数据库对象，生命周期须长于队列
+     */
+    WriteBehindQueue(WCDB::Database& database, const WriteBehindOptions& options = WriteBehindOptions());
+
+    /**
+     * @brief 提交剩余操作后停止写线程
+     */
+    ~WriteBehindQueue();
+
+    WriteBehindQueue(const WriteBehindQueue&) = delete;
+    WriteBehindQueue& operator=(const WriteBehindQueue&) = delete;
+
+    /**
+     * @brief 提交一个写操作
+     * @param operation 写操作
+     * @param onDurable 提交或失败后的回调，可为空
+     * @return 已入队返回 true；队列满被拒绝、等待超时或队列已停止返回 false（此时不会回调）
+     */
+    bool Submit(Operation operation, DurableCallback onDurable = nullptr);
+
+    /**
+     * @brief 插入一个对象，对应 Database::insertObjects
+     */
+    template<class ObjectType>
+    bool InsertObject(const ObjectType& object, const std::string& table, DurableCallback onDurable = nullptr)
+    {
+        return Submit([object, table](WCDB::Handle& handle) {
+            return handle.insertObjects<ObjectType>(object, table);
+        }, std::move(onDurable));
+    }
+
+    /**
+     * @brief 插入或替换一个对象，对应 Database::insertOrReplaceObjects
+     */
+    template<class ObjectType>
+    bool InsertOrReplaceObject(const ObjectType& object, const std::string& table, DurableCallback onDurable = nullptr)
+    {
+        return Submit([object, table](WCDB::Handle& handle) {
+            return handle.insertOrReplaceObjects<ObjectType>(object, table);
+        }, std::move(onDurable));
+    }
+
+    /**
+     * @brief 更新对象，对应 Database::updateObject
+     */
+    template<class ObjectType>
+    bool UpdateObject(const ObjectType& object, const WCDB::Fields& fields, const std::string& table,
+                      const WCDB::Expression& where, DurableCallback onDurable = nullptr)
+    {
+        return Submit([object, fields, table, where](WCDB::Handle& handle) {
+            return handle.updateObject<ObjectType>(object, fields, table, where);
+        }, std::move(onDurable));
+    }
+
+    /**
+     * @brief 删除，对应 Database::deleteObjects
+     */
+    bool DeleteObjects(const std::string& table, const WCDB::Expression& where, DurableCallback onDurable = nullptr);
+
+    /**
+     * @brief 阻塞直到调用前提交的所有操作都已提交（或失败）
+     * @return 期间没有操作失败返回 true
+     */
+    bool Flush();
+
+    /**
+     * @brief 停止接收新操作，提交剩余操作后停止写线程。可重复调用
+     */
+    void Stop();
+
+    /**
+     * @brief 获取统计数据
+     */
+    WriteBehindStats GetStats() const;
+
+    class Impl;
+
+private:
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Storage
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file Aggregate.h
+ * @brief Utility 连续数组上的向量化聚合
+ *
+ * 对 int64_t / double 连续数组一次遍历求和、最小值、最大值和区间计数。
+ * 运行时选择实现：x86-64 上 CPU 支持 AVX2 时使用 AVX2，aarch64 上使用 NEON，其余情况使用标量实现。
+ *
+ * 使用示例：
+ * @code
+ * std::vector<int64_t> ages = ...;
+ * Utility::Aggregate::Summary<int64_t> summary = Utility::Aggregate::Summarize(ages.data(), ages.size());
+ * size_t adults = Utility::Aggregate::CountInRange(ages.data(), ages.size(), 18, INT64_MAX);
+ * @endcode
+ *
+ * @note int64_t 求和按二进制补码回绕，不检测溢出
+ * @note double 求和的累加顺序与逐个相加不同，结果可能有舍入差异；不处理 NaN
+ */
+
+namespace Utility::Aggregate {
+
+/**
+ * @brief 聚合结果，count 为 0 时 sum / min / max 均为 0
+ */
+template<typename T>
+struct Summary {
+    T sum = 0;
+    T min = 0;
+    T max = 0;
+    size_t count = 0;
+};
+
+/**
+ * @brief 一次遍历求和、最小值、最大值和元素个数
+ */
+Summary<int64_t> Summarize(const int64_t* data, size_t count);
+Summary<double> Summarize(const double* data, size_t count);
+
+/**
+ * @brief 求和
+ */
+int64_t Sum(const int64_t* data, size_t count);
+double Sum(const double* data, size_t count);
+
+/**
+ * @brief 最小值，count 为 0 时返回 0
+ */
+int64_t Min(const int64_t* data, size_t count);
+double Min(const double* data, size_t count);
+
+/**
+ * @brief 最大值，count 为 0 时返回 0
+ */
+int64_t Max(const int64_t* data, size_t count);
+double Max(const double* data, size_t count);
+
+/**
+ * @brief 统计落在闭区间 [low, high] 内的元素个数
+ */
+size_t CountInRange(const int64_t* data, size_t count, int64_t low, int64_t high);
+size_t CountInRange(const double* data, size_t count, double low, double high);
+
+/**
+ * @brief 当前使用的实现："avx2"、"neon" 或 "scalar"
+ */
+const char* Backend();
+
+} // namespace Utility::Aggregate
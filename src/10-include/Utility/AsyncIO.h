@@ -0,0 +1,154 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @file AsyncIO.h
+ * @brief Utility 异步文件 I/O 接口
+ *
+ * Linux 下优先使用 io_uring，内核不支持（或被 seccomp 禁用）时回退到
+ * 基于线程池的 pread/pwrite 实现。两种后端的语义保持一致：
+ * 请求通过 Submit 批量提交，完成回调只在调用 Reap/Drain 的线程中执行，不一定是提交请求的线程。
+ */
+
+namespace Utility::AsyncIO {
+
+/**
+ * @brief I/O 后端类型
+ */
+enum class Backend {
+    Auto = 0,     // 优先 io_uring，不可用时回退到线程池
+    IoUring,      // 仅使用 io_uring，不可用时 Engine 无效
+    ThreadPool    // 仅使用线程池
+};
+
+/**
+ * @brief 请求操作类型
+ */
+enum class Operation {
+    Read = 0,
+    Write,
+    Fsync,
+    Fdatasync
+};
+
+/**
+ * @brief 请求完成回调
+ * @param result 成功时为读写的字节数（Fsync/Fdatasync 为 0），失败时为 -errno。
+ *               链上前一个请求失败或读写不完整时，后续请求得到 -ECANCELED
+ */
+using Completion = std::function<void(int64_t result)>;
+
+/**
+ * @brief 单个 I/O 请求
+ */
+struct Request {
+    Operation operation = Operation::Write;
+    int fd = -1;
+    void* buffer = nullptr;    // 读写缓冲区，完成回调执行前必须保持有效
+    size_t length = 0;
+    uint64_t offset = 0;
+    int bufferIndex = -1;      // RegisterBuffers 注册的缓冲区下标，-1 表示未注册
+    bool linkNext = false;     // 为 true 时下一个请求在本请求完整成功后才执行（如 write + fsync）
+    Completion onComplete;
+};
+
+/**
+ * @brief 注册缓冲区描述
+ */
+struct Buffer {
+    void* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief 引擎创建选项
+ */
+struct Options {
+    Backend backend = Backend::Auto;
+    unsigned queueDepth = 64;      // io_uring 提交队列深度
+    unsigned workerThreads = 2;    // 线程池后端的工作线程数
+};
+
+/**
+ * @brief 异步文件 I/O 引擎
+ * @note Submit、Reap、Drain 都可以在多个线程中调用，一个引擎可以被多个使用方共享（如并发的 CompressFile）。
+ *       每个完成回调只执行一次，由恰好取到它的 Reap/Drain 调用方执行，因此回调可能运行在其他使用方的线程中，
+ *       使用方应通过自己的状态（而不是 Reap 的返回值）判断请求是否完成
+ */
+class Engine {
+public:
+    explicit Engine(const Options& options = Options());
+    ~Engine();
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    /**
+     * @brief 引擎是否可用
+     * @return 指定 Backend::IoUring 但内核不支持时返回 false
+     */
+    bool IsValid() const;
+
+    /**
+     * @brief 获取实际使用的后端
+     */
+    Backend GetBackend() const;
+
+    /**
+     * @brief 注册固定缓冲区，之后的请求可以通过 bufferIndex 引用，省去每次 I/O 的页面映射
+     * @param buffers 缓冲区列表，会替换之前注册的缓冲区
+     * @return 注册成功返回 true。线程池后端总是成功（仅作记录）
+     * @note 调用前应确保没有引用旧缓冲区的请求在执行
+     */
+    bool RegisterBuffers(const std::vector<Buffer>& buffers);
+
+    /**
+     * @brief 取消注册固定缓冲区
+     */
+    void UnregisterBuffers();
+
+    /**
+     * @brief 批量提交请求
+     * @param requests 请求列表，通过 linkNext 连接的请求保证按顺序执行
+     * @return 实际提交的请求数 n：前 n 个请求会执行并得到完成回调，其余请求没有提交，回调也不会执行。
+     *         参数非法（如链长度超过队列深度、bufferIndex 越界）时返回 0；内核拒绝提交时可能只提交一部分，
+     *         链被截断时已提交的部分照常执行
+     */
+    size_t Submit(std::vector<Request> requests);
+
+    /**
+     * @brief 提交单个请求
+     * @return 提交成功返回 true，失败时回调不会执行
+     */
+    bool Submit(Request request);
+
+    /**
+     * @brief 收集已完成的请求并执行完成回调
+     * @param minComplete 至少等待完成的请求数，0 表示不阻塞
+     * @return 本次执行的完成回调数量。没有在途请求时立即返回
+     */
+    size_t Reap(size_t minComplete = 0);
+
+    /**
+     * @brief 等待所有在途请求完成并执行完成回调
+     * @note 其他线程同时在 Reap 时，返回时由其他线程取到的回调可能仍在执行
+     */
+    void Drain();
+
+    /**
+     * @brief 获取已提交但尚未完成的请求数
+     */
+    size_t InFlight() const;
+
+    class Impl;
+
+private:
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Utility::AsyncIO
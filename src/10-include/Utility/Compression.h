@@ -1,13 +1,20 @@
 #pragma once
 
 #include <vector>
+#include <string>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 
 /**
  * @file Compression.h
  * @brief Utility 压缩和解压缩功能接口
  */
 
+namespace Utility::AsyncIO {
+class Engine;
+} // namespace Utility::AsyncIO
+
 namespace Utility::Compression {
 
 /**
@@ -21,7 +28,8 @@ enum class Algorithm {
  * @brief 压缩数据
  * @param data 待压缩的数据
  * @param algorithm 压缩算法，默认为 Zstd
- * @param level 压缩级别 (1-22)，默认值为 3。级别越高压缩率越高但速度越慢
+ * @param level 压缩级别 (1-22)，默认值为 3。级别越高压缩率越高但速度越慢；
+ *              负数级别（-1 ~ -131072）为快速模式，适合写入时先低成本压缩、空闲时再重压缩
  * @return 压缩后的数据。如果压缩失败，返回空向量
  */
 std::vector<char> Compress(const std::vector<char>& data, 
@@ -50,5 +58,108 @@ std::vector<char> Decompress(const std::vector<char>& compressed,
 std::vector<char> DecompressAuto(const std::vector<char>& compressed,
                                  Algorithm algorithm = Algorithm::Zstd);
 
+/**
+ * @brief 解压数据的前缀，产生足够的数据后立即停止解码
+ * @param compressed 压缩的数据
+ * @param maxBytes 需要的最大字节数
+ * @param algorithm 压缩算法，默认为 Zstd
+ * @return 解压后数据的前 maxBytes 字节（原始数据更短时返回全部）。如果解压失败或数据在达到
+ *         maxBytes 之前被截断，返回空向量
+ * @note 适合只需读取头部（如 OTA 包中的 manifest、归档日志的头）的场景，耗时只与 maxBytes 有关，
+ *       与原始数据总大小无关
+ */
+std::vector<char> DecompressPrefix(const std::vector<char>& compressed,
+                                   size_t maxBytes,
+                                   Algorithm algorithm = Algorithm::Zstd);
+
+/**
+ * @brief 流式解压数据块回调
+ * @param data 本次解压出的数据
+ * @param size 数据长度
+ * @return 返回 false 表示已获得足够的数据，立即停止解压
+ */
+using ChunkCallback = std::function<bool(const char* data, size_t size)>;
+
+/**
+ * @brief 流式解压，按块回调解压结果，可在任意块之后提前停止
+ * @param compressed 压缩的数据
+ * @param onChunk 数据块回调
+ * @param algorithm 压缩算法，默认为 Zstd
+ * @return 数据完整解压或被回调提前停止时返回 true；解压失败或数据被截断时返回 false
+ */
+bool DecompressStream(const std::vector<char>& compressed,
+                      const ChunkCallback& onChunk,
+                      Algorithm algorithm = Algorithm::Zstd);
+
+/**
+ * @brief 文件压缩/解压进度回调
+ * @param processedBytes 已读取的源文件字节数
+ * @param totalBytes 源文件总字节数（无法获取时为 0）
+ */
+using ProgressCallback = std::function<void(uint64_t processedBytes, uint64_t totalBytes)>;
+
+/**
+ * @brief 取消回调
+ * @return 返回 true 表示中止当前操作，目标文件保持不变
+ */
+using CancelCallback = std::function<bool()>;
+
+/**
+ * @brief 文件压缩/解压选项
+ */
+struct FileOptions {
+    int level = 3;                 // 压缩级别，取值同 Compress，仅 CompressFile 使用
+    size_t bufferSize = 1 << 20;   // 读缓冲区大小，会向上对齐到 4KB
+    bool directIO = false;         // 读取源文件时尝试 O_DIRECT，不支持时自动回退到普通读取
+    bool dropPageCache = true;     // 通过 posix_fadvise/sync_file_range 释放已处理数据占用的页缓存
+    bool syncOutput = true;        // 替换目标文件前 fsync 临时文件
+    ProgressCallback onProgress;   // 进度回调，每处理完一个缓冲区调用一次
+    CancelCallback shouldCancel;   // 取消回调，每处理一个缓冲区前检查一次
+    AsyncIO::Engine* ioEngine = nullptr;  // 非空时通过异步引擎写出（多缓冲区 + write/fsync 链接提交），
+                                          // 压缩与写盘并行；引擎可以被多个调用共享
+};
+
+/**
+ * @brief 将文件压缩到另一个文件
+ * @param srcPath 源文件路径
+ * @param dstPath 目标文件路径
+ * @param algorithm 压缩算法，默认为 Zstd
+ * @param options 文件操作选项
+ * @return 成功返回 true。失败或被取消时返回 false，且不会修改已存在的目标文件
+ * @note 流式处理，内存占用只与 bufferSize 有关。输出先写入同目录下的临时文件，
+ *       完成后通过 rename 原子替换目标文件
+ */
+bool CompressFile(const std::string& srcPath,
+                  const std::string& dstPath,
+                  Algorithm algorithm = Algorithm::Zstd,
+                  const FileOptions& options = FileOptions());
+
+/**
+ * @brief 将压缩文件解压到另一个文件
+ * @param srcPath 压缩文件路径
+ * @param dstPath 目标文件路径
+ * @param algorithm 压缩算法，默认为 Zstd
+ * @param options 文件操作选项（level 字段被忽略）
+ * @return 成功返回 true。失败、被取消或压缩文件被截断时返回 false，且不会修改已存在的目标文件
+ * @note 支持多个连续的压缩帧
+ */
+bool DecompressFile(const std::string& srcPath,
+                    const std::string& dstPath,
+                    Algorithm algorithm = Algorithm::Zstd,
+                    const FileOptions& options = FileOptions());
+
+/**
+ * @brief 解压压缩文件的前缀，只读取产生所需数据必需的部分
+ * @param srcPath 压缩文件路径
+ * @param maxBytes 需要的最大字节数
+ * @param output 输出数据，成功时为原始数据的前 maxBytes 字节（原始数据更短时为全部）
+ * @param algorithm 压缩算法，默认为 Zstd
+ * @return 成功返回 true。文件无法读取、解压失败或在达到 maxBytes 之前被截断时返回 false
+ */
+bool DecompressFilePrefix(const std::string& srcPath,
+                          size_t maxBytes,
+                          std::vector<char>& output,
+                          Algorithm algorithm = Algorithm::Zstd);
+
 } // namespace Utility::Compression
 
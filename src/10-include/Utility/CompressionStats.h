@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Compression.h"
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @file CompressionStats.h
+ * @brief Utility 压缩统计接口
+ *
+ * Compression 模块的所有公共接口都会自动记录调用次数、输入/输出字节数、失败次数和耗时。
+ * 计数在线程本地累加，只有获取快照时才会汇总，默认开启。
+ */
+
+namespace Utility::Compression {
+
+/**
+ * @brief 统计的操作类型
+ */
+enum class StatsOperation {
+    Compress = 0,    // Compress
+    Decompress,      // Decompress / DecompressAuto / DecompressPrefix
+    CompressFile,    // CompressFile
+    DecompressFile   // DecompressFile
+};
+
+// 延迟直方图桶数。第 0 个桶为 [0, 2) 微秒，第 i 个桶为 [2^i, 2^(i+1)) 微秒，最后一个桶包含所有更大的值
+constexpr size_t kLatencyBuckets = 24;
+
+// 单独统计的压缩级别范围，超出范围的级别计入边界值。解压操作的级别记为 0
+constexpr int kStatsMinLevel = -7;
+constexpr int kStatsMaxLevel = 22;
+
+/**
+ * @brief 某个操作/算法/级别组合的统计数据
+ */
+struct StatsEntry {
+    StatsOperation operation = StatsOperation::Compress;
+    Algorithm algorithm = Algorithm::Zstd;
+    int level = 0;
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t bytesIn = 0;      // 成功调用的输入字节数
+    uint64_t bytesOut = 0;     // 成功调用的输出字节数
+    uint64_t totalNanos = 0;   // 所有调用的累计耗时
+    std::array<uint64_t, kLatencyBuckets> latencyHistogram{};
+
+    /**
+     * @brief 按直方图估算延迟分位数
+     * @param percentile 分位数，取值 (0, 1]
+     * @return 所在桶的上界（微秒），没有数据时返回 0
+     */
+    uint64_t LatencyPercentileMicros(double percentile) const;
+};
+
+/**
+ * @brief 统计快照，只包含有调用记录的组合
+ */
+struct StatsSnapshot {
+    std::vector<StatsEntry> entries;
+
+    /**
+     * @brief 导出为 JSON 字符串
+     * @param indent 缩进空格数，-1 表示紧凑格式
+     */
+    std::string ToJson(int indent = -1) const;
+};
+
+/**
+ * @brief 开启或关闭统计。关闭后各接口不再读取时钟和累加计数
+ */
+void SetStatsEnabled(bool enabled);
+
+/**
+ * @brief 统计是否开启
+ */
+bool IsStatsEnabled();
+
+/**
+ * @brief 获取自进程启动（或上次 ResetStats）以来的统计快照
+ */
+StatsSnapshot GetStatsSnapshot();
+
+/**
+ * @brief 重置统计，之后的快照只包含重置后的数据
+ */
+void ResetStats();
+
+/**
+ * @brief 通过 spdlog 默认 logger 输出一次统计摘要
+ */
+void LogStats();
+
+/**
+ * @brief 启动后台线程定期输出统计摘要
+ * @param intervalSeconds 输出间隔（秒）。重复调用会替换之前的间隔
+ */
+void StartStatsLogging(unsigned intervalSeconds);
+
+/**
+ * @brief 停止定期输出统计摘要
+ */
+void StopStatsLogging();
+
+} // namespace Utility::Compression
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file IdGenerator.h
+ * @brief Utility 时间有序 64 位 ID 生成接口
+ *
+ * ID 由客户端在写入前生成，可直接作为 SQLite 的 INTEGER PRIMARY KEY（rowid 别名），
+ * 不需要 AUTOINCREMENT 维护 sqlite_sequence，也不必等插入后才拿到 ID。
+ *
+ * 位布局（从高到低）：
+ * - 1 位符号位，恒为 0
+ * - 41 位毫秒时间戳，相对 epochMillis，可用约 69 年
+ * - 10 位节点号，多个进程/设备各用不同节点号时 ID 不冲突
+ * - 12 位序号，同一毫秒内最多 4096 个，超出时借用下一毫秒
+ *
+ * 使用示例：
+ * @code
+ * Utility::IdGenerator generator(nodeId);
+ * model.id = generator.Next();
+ * @endcode
+ */
+
+namespace Utility {
+
+class IdGenerator {
+public:
+    static constexpr int kTimestampBits = 41;
+    static constexpr int kNodeBits = 10;
+    static constexpr int kSequenceBits = 12;
+    static constexpr uint16_t kMaxNode = (1u << kNodeBits) - 1;
+
+    // 默认纪元：2024-01-01 00:00:00 UTC
+    static constexpr uint64_t kDefaultEpochMillis = 1704067200000ull;
+
+    /**
+     * @brief 构造生成器
+     * @param node 节点号，取值 [0, kMaxNode]，超出部分被截断
+     * @param epochMillis 纪元（Unix 毫秒），同一数据集的所有生成器须一致
+     */
+    explicit IdGenerator(uint16_t node = 0, uint64_t epochMillis = kDefaultEpochMillis);
+
+    /**
+     * @brief 生成下一个 ID，线程安全、无锁
+     * @return 严格单调递增的正整数。系统时钟回拨时沿用已发出的最大时间继续递增，不会重复
+     */
+    int64_t Next();
+
+    /**
+     * @brief 一次生成 count 个连续递增的 ID，比逐个调用 Next() 少 count - 1 次原子操作
+     * @param ids 输出数组，长度不小于 count
+     * @param count 数量
+     */
+    void NextBatch(int64_t* ids, size_t count);
+
+    /**
+     * @brief 节点号
+     */
+    uint16_t GetNode() const { return m_node; }
+
+    /**
+     * @brief 从 ID 中取出生成时间（Unix 毫秒）
+     */
+    uint64_t TimestampOf(int64_t id) const;
+
+    /**
+     * @brief 从 ID 中取出节点号
+     */
+    static uint16_t NodeOf(int64_t id);
+
+    /**
+     * @brief 进程内共享的默认生成器（节点号 0）
+     */
+    static IdGenerator& Default();
+
+private:
+    uint64_t Reserve(uint64_t count);
+
+    uint16_t m_node;
+    uint64_t m_epochMillis;
+    // 已发出的最大 (毫秒 << kSequenceBits | 序号)
+    std::atomic<uint64_t> m_last;
+};
+
+} // namespace Utility
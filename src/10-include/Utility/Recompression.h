@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Compression.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @file Recompression.h
+ * @brief Utility 后台重压缩接口
+ *
+ * 写入时使用快速（或负数）级别压缩，空闲时由 RecompressionScheduler 按时间片
+ * 以高级别重新压缩，并通过 ObjectStore 原子替换原数据。
+ *
+ * 使用示例：
+ * @code
+ * auto store = std::make_shared<Utility::Compression::FileObjectStore>();
+ * Utility::Compression::RecompressionOptions options;
+ * options.targetLevel = 19;
+ * options.isIdle = []() { return GetCpuLoad() < 0.3; };
+ * Utility::Compression::RecompressionScheduler scheduler(store, options);
+ * scheduler.Start();
+ *
+ * // 写入新归档后登记
+ * Utility::Compression::CompressFile("log.txt", "log.txt.zst", Utility::Compression::Algorithm::Zstd, fastOptions);
+ * scheduler.Track("log.txt.zst", fastOptions.level);
+ * @endcode
+ */
+
+namespace Utility::Compression {
+
+/**
+ * @brief ObjectStore::Replace 的结果
+ */
+enum class ReplaceResult {
+    Replaced = 0,  // 已替换
+    Conflict,      // 对象在 Load 之后被修改，未替换
+    Failed         // 写入失败，未替换
+};
+
+/**
+ * @brief 被重压缩对象的存储接口
+ */
+class ObjectStore {
+public:
+    virtual ~ObjectStore() = default;
+
+    /**
+     * @brief 读取对象的压缩数据
+     * @param key 对象标识
+     * @param data 输出压缩数据
+     * @param version 输出对象版本，Replace 时用于检测并发修改
+     * @return 成功返回 true
+     */
+    virtual bool Load(const std::string& key, std::vector<char>& data, uint64_t& version) = 0;
+
+    /**
+     * @brief 原子替换对象的压缩数据
+     * @param key 对象标识
+     * @param data 新的压缩数据
+     * @param version Load 时得到的版本
+     * @return 替换结果。未替换时原数据保持不变
+     */
+    virtual ReplaceResult Replace(const std::string& key, const std::vector<char>& data, uint64_t version) = 0;
+};
+
+/**
+ * @brief 以文件路径为 key 的对象存储
+ * @note 版本由文件大小和修改时间生成。替换时先写同目录临时文件并 fsync，再 rename 覆盖
+ */
+class FileObjectStore : public ObjectStore {
+public:
+    bool Load(const std::string& key, std::vector<char>& data, uint64_t& version) override;
+    ReplaceResult Replace(const std::string& key, const std::vector<char>& data, uint64_t version) override;
+};
+
+/**
+ * @brief 重压缩调度选项
+ */
+struct RecompressionOptions {
+    Algorithm algorithm = Algorithm::Zstd;
+    int targetLevel = 19;                 // 目标压缩级别，已达到该级别的对象不会被登记
+    unsigned sliceMillis = 50;            // 单个时间片的时长预算，单个对象不会被拆分，大对象可能超出
+    double maxCpuShare = 0.25;            // 后台线程的 CPU 占用上限，按时间片耗时补足休眠
+    uint64_t ioBytesPerSecond = 8 << 20;  // 读取 + 写入的字节速率上限，0 表示不限制
+    unsigned idleCheckMillis = 1000;      // 后台线程检查空闲状态的间隔
+    double minSavingRatio = 0.02;         // 新数据至少比原数据小的比例，否则保留原数据
+    unsigned retryBackoffMillis = 1000;   // 冲突或失败后重新排队的退避时长，之后每次重试翻倍（最多 1024 倍）
+    unsigned maxRetries = 5;              // 同一对象连续冲突或失败的重试次数，超过后放弃并记入 abandonedKeys
+    std::function<bool()> isIdle;         // 空闲判定，未设置时视为总是空闲
+};
+
+/**
+ * @brief 重压缩统计
+ */
+struct RecompressionStats {
+    uint64_t pending = 0;                 // 等待重压缩的对象数
+    uint64_t pendingBytes = 0;            // 等待重压缩对象的登记大小之和
+    std::map<int, uint64_t> pendingByLevel;  // 按当前级别统计的等待对象数
+    uint64_t recompressed = 0;            // 已替换的对象数
+    uint64_t skipped = 0;                 // 节省不足而保留原数据的对象数
+    uint64_t conflicts = 0;               // 处理期间被修改而未替换的次数
+    uint64_t failures = 0;                // 读取、解压、压缩或写入失败的次数
+    uint64_t retries = 0;                 // 冲突或失败后重新排队的次数
+    std::vector<std::string> abandonedKeys;  // 超过 maxRetries 而放弃的对象，重新 Track 后会再次处理
+    uint64_t bytesBefore = 0;             // 已替换对象的原大小之和
+    uint64_t bytesAfter = 0;              // 已替换对象的新大小之和
+    uint64_t slices = 0;                  // 已执行的时间片数
+
+    /**
+     * @brief 已节省的字节数
+     */
+    uint64_t BytesSaved() const { return bytesBefore - bytesAfter; }
+};
+
+/**
+ * @brief 后台重压缩调度器
+ *
+ * 按当前级别从低到高处理登记的对象，每个时间片内处理尽可能多的对象，
+ * 时间片之间按 maxCpuShare 和 ioBytesPerSecond 休眠。
+ * 替换冲突（对象在处理期间被改写）或失败的对象会在退避后重新排队，持续被改写的对象
+ * 会在写入平息后完成重压缩；连续 maxRetries 次仍未成功时放弃，并在统计中列出。
+ */
+class RecompressionScheduler {
+public:
+    RecompressionScheduler(std::shared_ptr<ObjectStore> store,
+                           const RecompressionOptions& options = RecompressionOptions());
+    ~RecompressionScheduler();
+
+    RecompressionScheduler(const RecompressionScheduler&) = delete;
+    RecompressionScheduler& operator=(const RecompressionScheduler&) = delete;
+
+    /**
+     * @brief 登记对象。重复登记会更新级别和大小，并清除重试次数和放弃状态
+     * @param key 对象标识
+     * @param currentLevel 对象当前的压缩级别
+     * @param storedSize 对象当前的压缩后大小，仅用于统计
+     */
+    void Track(const std::string& key, int currentLevel, uint64_t storedSize = 0);
+
+    /**
+     * @brief 取消登记（如对象被删除）
+     */
+    void Untrack(const std::string& key);
+
+    /**
+     * @brief 在当前线程同步执行一个时间片
+     * @return 本时间片处理的对象数
+     */
+    size_t RunSlice();
+
+    /**
+     * @brief 启动后台线程
+     */
+    void Start();
+
+    /**
+     * @brief 停止后台线程，正在处理的对象会先完成
+     */
+    void Stop();
+
+    /**
+     * @brief 获取统计数据
+     */
+    RecompressionStats GetStats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Utility::Compression
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file ThreadLocalStats.h
+ * @brief Utility 线程本地统计的公共实现
+ *
+ * 写入路径不加锁：每个线程只写自己的计数块，快照时在注册表锁内汇总所有线程的计数块。
+ * 线程退出时计数合并到 retired；计数器只能由所属线程写入，重置改为记录基线、快照时扣除。
+ * Compression 的压缩统计和 Storage 的 SQL 追踪都基于此实现。
+ */
+
+namespace Utility::Stats {
+
+/**
+ * @brief 累加只由所属线程写入的计数器
+ * @note 快照线程只读，因此用 load + store 代替原子 RMW
+ */
+inline void Accumulate(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 更新只由所属线程写入的最大值
+ */
+inline void AccumulateMax(std::atomic<uint64_t>& counter, uint64_t value) {
+    if (value > counter.load(std::memory_order_relaxed)) {
+        counter.store(value, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief 延迟所在的 log2 直方图桶：第 0 个桶为 [0, 2) 微秒，第 i 个桶为 [2^i, 2^(i+1)) 微秒，
+ *        最后一个桶包含所有更大的值
+ */
+inline size_t LatencyBucket(uint64_t nanos, size_t bucketCount) {
+    uint64_t micros = nanos / 1000;
+    if (micros < 2) {
+        return 0;
+    }
+    size_t bucket = static_cast<size_t>(63 - __builtin_clzll(micros));
+    return bucket < bucketCount ? bucket : bucketCount - 1;
+}
+
+/**
+ * @brief 按 LatencyBucket 的直方图估算延迟分位数
+ * @param percentile 分位数，取值 (0, 1]
+ * @return 所在桶的上界（微秒），没有数据时返回 0
+ */
+template <size_t N>
+uint64_t HistogramPercentileMicros(const std::array<uint64_t, N>& histogram, double percentile) {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    double target = percentile * static_cast<double>(total);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < N; i++) {
+        cumulative += histogram[i];
+        if (static_cast<double>(cumulative) >= target) {
+            return 1ull << (i + 1);
+        }
+    }
+    return 1ull << N;
+}
+
+/**
+ * @brief 线程本地计数块的注册表，每个 Block 类型一个实例
+ * @tparam Block 线程本地计数块，须可默认构造，并提供 void MergeInto(Totals&) const。
+ *         MergeInto 在注册表锁内、与所属线程的写入并发执行，只能读取计数器
+ * @tparam Totals 汇总结果，须可默认构造和复制，默认值表示没有任何计数
+ */
+template <typename Block, typename Totals>
+class ThreadLocalRegistry {
+public:
+    static ThreadLocalRegistry& Instance() {
+        // 有意泄漏，避免进程退出时与 thread_local 析构的顺序问题
+        static ThreadLocalRegistry* registry = new ThreadLocalRegistry();
+        return *registry;
+    }
+
+    /**
+     * @brief 当前线程的计数块，首次调用时创建并登记，线程退出时合并到 retired
+     */
+    Block& Local() {
+        thread_local Holder holder(*this);
+        return holder.block;
+    }
+
+    /**
+     * @brief 汇总所有线程（含已退出线程）的累计值
+     */
+    Totals Collect() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Totals totals = m_retired;
+        for (const Block* block : m_blocks) {
+            block->MergeInto(totals);
+        }
+        return totals;
+    }
+
+    /**
+     * @brief 把当前累计值记为基线，之后的快照应扣除 Baseline()
+     */
+    void ResetBaseline() {
+        Totals totals = Collect();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_baseline = std::move(totals);
+    }
+
+    /**
+     * @brief 最近一次 ResetBaseline 时的累计值，从未重置时为默认值
+     */
+    Totals Baseline() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_baseline;
+    }
+
+private:
+    ThreadLocalRegistry() = default;
+
+    struct Holder {
+        explicit Holder(ThreadLocalRegistry& owner) : registry(owner) {
+            std::lock_guard<std::mutex> lock(registry.m_mutex);
+            registry.m_blocks.push_back(&block);
+        }
+
+        ~Holder() {
+            std::lock_guard<std::mutex> lock(registry.m_mutex);
+            block.MergeInto(registry.m_retired);
+            registry.m_blocks.erase(std::remove(registry.m_blocks.begin(), registry.m_blocks.end(), &block),
+                                    registry.m_blocks.end());
+        }
+
+        ThreadLocalRegistry& registry;
+        Block block;
+    };
+
+    std::mutex m_mutex;
+    std::vector<const Block*> m_blocks;
+    Totals m_retired;
+    Totals m_baseline;
+};
+
+} // namespace Utility::Stats
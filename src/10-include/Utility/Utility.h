@@ -17,9 +17,19 @@
  * 
  * // 解压数据
  * auto decompressed = Utility::Compression::DecompressAuto(compressed, Utility::Compression::Algorithm::Zstd);
+ *
+ * // 压缩文件
+ * Utility::Compression::FileOptions options;
+ * options.onProgress = [](uint64_t processed, uint64_t total) { ... };
+ * Utility::Compression::CompressFile("backup.db", "backup.db.zst", Utility::Compression::Algorithm::Zstd, options);
  * @endcode
  */
 
 #include "Version.h"
 #include "Compression.h"
+#include "CompressionStats.h"
+#include "AsyncIO.h"
+#include "IdGenerator.h"
+#include "Recompression.h"
+#include "Aggregate.h"
 
@@ -1,10 +1,14 @@
 #ifndef MODEL_SAMPLE_H
 #define MODEL_SAMPLE_H
 
+#include <cstdint>
+#include <string>
+
 #ifdef _WCDB_ENABLED_
 #include "WCDB/WCDBCpp.h"
 #endif
 
+// ORM 实现见 src/21-test_demo/model/model_sample.cpp，使用这些模型的程序需一同编译
 
 const std::string TABLE_NAME_SAMPLE = "sample";
 struct ModelSample
@@ -18,8 +22,8 @@ struct ModelSample
     std::string city;
     std::string state;
     std::string country;
-    std::string created_at;
-    std::string updated_at;
+    int64_t created_at;     // Unix 毫秒（UTC），见 Storage/Timestamp.h
+    int64_t updated_at;     // Unix 毫秒（UTC）
 
     std::string add_1;
 
@@ -28,4 +32,31 @@ struct ModelSample
 #endif
 };
 
+/**
+ * 客户端分配 ID 的版本，字段与 ModelSample 相同
+ * ORM 实现中使用 WCDB_CPP_PRIMARY(id)：id 为 INTEGER PRIMARY KEY，即 rowid 别名，
+ * 不带 AUTOINCREMENT，插入时不写 sqlite_sequence。id 由 Utility::IdGenerator 在插入前生成
+ */
+const std::string TABLE_NAME_SAMPLE_KEYED = "sample_keyed";
+struct ModelSampleKeyed
+{
+    int64_t id;
+    std::string name;
+    int age;
+    std::string email;
+    std::string phone;
+    std::string address;
+    std::string city;
+    std::string state;
+    std::string country;
+    int64_t created_at;     // Unix 毫秒（UTC），见 Storage/Timestamp.h
+    int64_t updated_at;     // Unix 毫秒（UTC）
+
+    std::string add_1;
+
+#ifdef _WCDB_ENABLED_
+    WCDB_CPP_ORM_DECLARATION(ModelSampleKeyed);
+#endif
+};
+
 #endif // MODEL_SAMPLE_H
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef MODEL_SAMPLE_INTERNED_H
+#define MODEL_SAMPLE_INTERNED_H
+
+#include <cstdint>
+#include <string>
+
+#include "WCDB/WCDBCpp.h"
+#include "Storage/InternedString.h"
+
+/**
+ * city / state / country 驻留的版本，其余字段与 ModelSample 相同
+ * 这三列在表中为 INTEGER，保存 Storage::StringDictionary 字典表的编码，见 Storage/InternedString.h
+ * 依赖 Storage，因此与 model_sample.h 分开，只有用到驻留字符串的程序才包含
+ * ORM 实现见 src/21-test_demo/model/model_sample_interned.cpp，使用该模型的程序需一同编译
+ */
+const std::string TABLE_NAME_SAMPLE_INTERNED = "sample_interned";
+struct ModelSampleInterned
+{
+    int id;
+    std::string name;
+    int age;
+    std::string email;
+    std::string phone;
+    std::string address;
+    Storage::InternedString city;
+    Storage::InternedString state;
+    Storage::InternedString country;
+    int64_t created_at;     // Unix 毫秒（UTC），见 Storage/Timestamp.h
+    int64_t updated_at;     // Unix 毫秒（UTC）
+
+    std::string add_1;
+
+    WCDB_CPP_ORM_DECLARATION(ModelSampleInterned);
+};
+
+#endif // MODEL_SAMPLE_INTERNED_H
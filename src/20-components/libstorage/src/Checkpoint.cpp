@@ -0,0 +1,220 @@
+#include "Storage/Checkpoint.h"
+#include "IdleDetector.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace Storage {
+
+namespace {
+
+using Clock = IdleDetector::Clock;
+
+const std::string kAutoCheckpointOwner = "checkpoint_scheduler";
+
+int64_t FileSize(const std::string& path) {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0 ? (int64_t) info.st_size : 0;
+}
+
+double SecondsBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+} // namespace
+
+class CheckpointScheduler::Impl {
+public:
+    Impl(WCDB::Database& database, const CheckpointOptions& options)
+        : m_database(database), m_options(options) {
+        const WCDB::StringView& path = m_database.getPath();
+        m_walPath = std::string(path.data(), path.length()) + "-wal";
+        m_lastCheckpointTime = Clock::now();
+        DisableAutoCheckpoint(m_database, kAutoCheckpointOwner);
+        m_idle.Start([this]() { SchedulerLoop(); });
+    }
+
+    ~Impl() {
+        Stop();
+        // 只归还自己的登记，构造前已被其他组件关闭时保持关闭
+        RestoreAutoCheckpoint(m_database, kAutoCheckpointOwner);
+    }
+
+    bool CheckpointNow(bool truncate) {
+        WCDB::Handle handle = m_database.getHandle();
+        uint64_t frames = 0;
+        bool complete = Checkpoint(handle, truncate, frames);
+        handle.invalidate();
+        return complete;
+    }
+
+    void Stop() { m_idle.Stop(); }
+
+    CheckpointStats GetStats() const {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        return m_stats;
+    }
+
+private:
+    void SchedulerLoop() {
+        WCDB::Handle handle = m_database.getHandle();
+        m_idle.Begin(handle);
+        bool pending = false;
+        Clock::time_point pendingSince = Clock::now();
+        Clock::time_point notBefore = pendingSince;
+        Clock::time_point refilled = pendingSince;
+        const double burst = (double) m_options.maxBytesPerSecond;
+        double tokens = burst;
+        unsigned busyStreak = 0;
+
+        while (m_idle.Sleep(m_options.pollIntervalMillis)) {
+            Clock::time_point now = Clock::now();
+            if (m_idle.PollCommit(handle, now)) {
+                if (!pending) {
+                    pending = true;
+                    pendingSince = now;
+                }
+            }
+            int64_t walBytes = FileSize(m_walPath);
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                m_stats.walBytes = walBytes;
+                m_stats.peakWalBytes = std::max(m_stats.peakWalBytes, walBytes);
+            }
+            if (m_options.maxBytesPerSecond > 0) {
+                tokens = std::min(burst, tokens + SecondsBetween(refilled, now) * m_options.maxBytesPerSecond);
+            }
+            refilled = now;
+            if (now < notBefore) {
+                continue;
+            }
+
+            bool truncate = (m_options.truncateWalBytes > 0 && walBytes > m_options.truncateWalBytes)
+                            || (m_options.truncateAfterBusy > 0 && busyStreak >= m_options.truncateAfterBusy);
+            if (!truncate) {
+                if (!pending) {
+                    continue;
+                }
+                bool idle = m_idle.IdleFor(m_options.idleMillis, now);
+                bool overdue = now - pendingSince >= std::chrono::milliseconds(m_options.maxDeferMillis);
+                if (!idle && !overdue) {
+                    continue;
+                }
+                if (m_options.maxBytesPerSecond > 0 && tokens < 0) {
+                    std::lock_guard<std::mutex> lock(m_statsMutex);
+                    ++m_stats.budgetDeferrals;
+                    continue;
+                }
+            }
+
+            // 超过阈值时的 TRUNCATE 检查点不受预算限制，写回量同样计入预算
+            uint64_t frames = 0;
+            bool complete = Checkpoint(handle, truncate, frames);
+            tokens -= (double) frames * m_pageSize;
+            if (complete) {
+                pending = false;
+                busyStreak = 0;
+            } else {
+                if (!truncate) {
+                    ++busyStreak;
+                }
+                // 读事务未结束时立即重试没有意义，等到下一个空闲窗口
+                notBefore = now + std::chrono::milliseconds(truncate ? m_options.maxDeferMillis : m_options.idleMillis);
+            }
+        }
+        handle.invalidate();
+    }
+
+    // 执行一次检查点并更新统计，返回是否写回了 WAL 中的全部帧
+    bool Checkpoint(WCDB::Handle& handle, bool truncate, uint64_t& frames) {
+        std::lock_guard<std::mutex> guard(m_checkpointMutex);
+        if (m_pageSize == 0) {
+            auto pageSize = handle.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::pageSize()));
+            m_pageSize = pageSize.hasValue() && pageSize.value().intValue() > 0 ? pageSize.value().intValue() : 4096;
+        }
+
+        Clock::time_point start = Clock::now();
+        auto row = handle.getOneRowFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::walCheckpoint())
+                                                 .with(truncate ? "TRUNCATE" : "PASSIVE"));
+        Clock::time_point end = Clock::now();
+
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        if (!row.hasValue() || row.value().size() < 3) {
+            ++m_stats.failed;
+            return false;
+        }
+        bool busy = row.value()[0].intValue() != 0;
+        // 非 WAL 模式时返回 -1
+        int64_t log = std::max<int64_t>(row.value()[1].intValue(), 0);
+        int64_t checkpointed = std::max<int64_t>(row.value()[2].intValue(), 0);
+
+        // 帧数只能按两次检查点的结果估算：log 变小说明 WAL 已从头重写
+        bool restarted = log < m_lastLog;
+        uint64_t appended = (uint64_t) (restarted ? log : log - m_lastLog);
+        frames = (uint64_t) (restarted || checkpointed < m_lastCheckpointed ? checkpointed
+                                                                           : checkpointed - m_lastCheckpointed);
+        double elapsed = SecondsBetween(m_lastCheckpointTime, end);
+        if (elapsed > 0) {
+            double rate = (double) appended * m_pageSize / elapsed;
+            m_stats.walGrowthBytesPerSecond = m_stats.appendedFrames == 0
+                                              ? rate : m_stats.walGrowthBytesPerSecond * 0.7 + rate * 0.3;
+        }
+        m_lastLog = log;
+        m_lastCheckpointed = checkpointed;
+        m_lastCheckpointTime = end;
+
+        double millis = std::chrono::duration<double, std::milli>(end - start).count();
+        bool complete = !busy && checkpointed == log;
+        ++(truncate ? m_stats.truncateCheckpoints : m_stats.passiveCheckpoints);
+        if (!complete) {
+            ++m_stats.incomplete;
+        }
+        m_stats.checkpointedFrames += frames;
+        m_stats.appendedFrames += appended;
+        m_stats.lastDurationMillis = millis;
+        m_stats.maxDurationMillis = std::max(m_stats.maxDurationMillis, millis);
+        m_stats.totalDurationMillis += millis;
+        m_stats.backlogFrames = log - checkpointed;
+        if (truncate && complete) {
+            m_stats.walBytes = 0;
+        }
+        return complete;
+    }
+
+    WCDB::Database& m_database;
+    CheckpointOptions m_options;
+    std::string m_walPath;
+
+    IdleDetector m_idle;
+
+    // 串行化后台线程与 CheckpointNow，保护帧数估算的状态
+    std::mutex m_checkpointMutex;
+    int64_t m_pageSize = 0;
+    int64_t m_lastLog = 0;
+    int64_t m_lastCheckpointed = 0;
+    Clock::time_point m_lastCheckpointTime;
+
+    mutable std::mutex m_statsMutex;
+    CheckpointStats m_stats;
+};
+
+CheckpointScheduler::CheckpointScheduler(WCDB::Database& database, const CheckpointOptions& options)
+    : m_impl(new Impl(database, options)) {
+}
+
+CheckpointScheduler::~CheckpointScheduler() = default;
+
+bool CheckpointScheduler::CheckpointNow(bool truncate) {
+    return m_impl->CheckpointNow(truncate);
+}
+
+void CheckpointScheduler::Stop() {
+    m_impl->Stop();
+}
+
+CheckpointStats CheckpointScheduler::GetStats() const {
+    return m_impl->GetStats();
+}
+
+} // namespace Storage
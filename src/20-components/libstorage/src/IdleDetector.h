@@ -0,0 +1,88 @@
+#pragma once
+
+#include "WCDB/WCDBCpp.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Storage {
+
+// 空闲时执行维护任务的后台线程骨架，CheckpointScheduler 和 SpaceReclaimer 共用：
+// 可被 Stop 提前唤醒的等待，以及通过 PRAGMA data_version 感知其他连接的提交
+class IdleDetector {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    IdleDetector() = default;
+
+    ~IdleDetector() { Stop(); }
+
+    IdleDetector(const IdleDetector&) = delete;
+    IdleDetector& operator=(const IdleDetector&) = delete;
+
+    // 启动后台线程执行 loop，loop 应在 Sleep 返回 false 后退出
+    void Start(std::function<void()> loop) { m_thread = std::thread(std::move(loop)); }
+
+    // 唤醒 Sleep 并等待后台线程退出，可重复调用
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_stopMutex);
+            m_stopping = true;
+        }
+        m_stopCondition.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    // 等待 millis 毫秒，期间被 Stop 唤醒时返回 false
+    bool Sleep(unsigned millis) {
+        std::unique_lock<std::mutex> lock(m_stopMutex);
+        return !m_stopCondition.wait_for(lock, std::chrono::milliseconds(millis), [this]() { return m_stopping; });
+    }
+
+    // 以下只在后台线程中调用。Handle 只在后台线程中使用；data_version 只在其他连接提交后变化
+
+    // 记下当前的 data_version，并把当前时间视为最近一次提交
+    void Begin(WCDB::Handle& handle) {
+        m_version = DataVersion(handle, -1);
+        m_lastCommit = Clock::now();
+    }
+
+    // data_version 变化时说明有其他连接提交，记下提交时间并返回 true
+    bool PollCommit(WCDB::Handle& handle, Clock::time_point now) {
+        int64_t current = DataVersion(handle, m_version);
+        if (current == m_version) {
+            return false;
+        }
+        m_version = current;
+        m_lastCommit = now;
+        return true;
+    }
+
+    // 经其他句柄提交的自身写入同样会改变 data_version，记下新值而不视为外部提交
+    void Absorb(WCDB::Handle& handle) { m_version = DataVersion(handle, m_version); }
+
+    // 最近一次提交之后是否已经连续 millis 毫秒没有提交
+    bool IdleFor(unsigned millis, Clock::time_point now) const {
+        return now - m_lastCommit >= std::chrono::milliseconds(millis);
+    }
+
+private:
+    static int64_t DataVersion(WCDB::Handle& handle, int64_t fallback) {
+        auto value = handle.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::dataVersion()));
+        return value.hasValue() ? value.value().intValue() : fallback;
+    }
+
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+    bool m_stopping = false;
+    std::thread m_thread;
+
+    int64_t m_version = -1;
+    Clock::time_point m_lastCommit;
+};
+
+} // namespace Storage
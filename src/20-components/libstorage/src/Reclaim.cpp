@@ -0,0 +1,185 @@
+#include "Storage/Reclaim.h"
+#include "IdleDetector.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace Storage {
+
+namespace {
+
+using Clock = IdleDetector::Clock;
+
+// auto_vacuum 的取值：0 NONE，1 FULL，2 INCREMENTAL
+const int64_t kAutoVacuumIncremental = 2;
+
+} // namespace
+
+class SpaceReclaimer::Impl {
+public:
+    Impl(WCDB::Database& database, const ReclaimOptions& options)
+        : m_database(database), m_options(options) {
+        if (m_options.pagesPerSlice <= 0) {
+            m_options.pagesPerSlice = 1;
+        }
+        m_database.enableAutoVacuum(true);
+        Refresh();
+        m_idle.Start([this]() { ReclaimLoop(); });
+    }
+
+    ~Impl() { Stop(); }
+
+    bool IsIncremental() const {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        return m_stats.incremental;
+    }
+
+    bool ConvertToIncremental() {
+        std::lock_guard<std::mutex> guard(m_reclaimMutex);
+        // auto_vacuum 由 enableAutoVacuum 的配置在每个句柄上设置，VACUUM 重写文件后才写入文件头
+        bool succeed = m_database.vacuum(nullptr);
+        return Refresh() && succeed && IsIncremental();
+    }
+
+    bool Refresh() {
+        auto autoVacuum = m_database.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::autoVacuum()));
+        auto pageSize = m_database.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::pageSize()));
+        auto pageCount = m_database.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::pageCount()));
+        auto freelist = m_database.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::freelistCount()));
+        if (!autoVacuum.hasValue() || !pageSize.hasValue() || !pageCount.hasValue() || !freelist.hasValue()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.incremental = autoVacuum.value().intValue() == kAutoVacuumIncremental;
+        m_stats.pageSize = pageSize.value().intValue();
+        m_stats.pageCount = pageCount.value().intValue();
+        m_stats.freelistCount = freelist.value().intValue();
+        m_stats.freelistRatio = m_stats.pageCount > 0 ? (double) m_stats.freelistCount / m_stats.pageCount : 0;
+        m_stats.reclaimableBytes = m_stats.freelistCount * m_stats.pageSize;
+        return true;
+    }
+
+    WCDB::Optional<int64_t> ReclaimNow(int pages) {
+        std::lock_guard<std::mutex> guard(m_reclaimMutex);
+        return Slice(pages);
+    }
+
+    void Stop() { m_idle.Stop(); }
+
+    ReclaimStats GetStats() const {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        return m_stats;
+    }
+
+private:
+    void ReclaimLoop() {
+        WCDB::Handle handle = m_database.getHandle();
+        m_idle.Begin(handle);
+
+        while (m_idle.Sleep(m_options.pollIntervalMillis)) {
+            if (m_idle.PollCommit(handle, Clock::now())) {
+                continue;
+            }
+            if (!m_idle.IdleFor(m_options.idleMillis, Clock::now()) || !Refresh() || !ShouldReclaim()) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(m_reclaimMutex);
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++m_stats.windows;
+            }
+            for (unsigned slice = 0; slice < m_options.maxSlicesPerWindow; slice++) {
+                WCDB::Optional<int64_t> reclaimed = Slice(m_options.pagesPerSlice);
+                // 回收片通过其他句柄提交，同样会改变本句柄看到的 data_version
+                m_idle.Absorb(handle);
+                if (!reclaimed.hasValue() || reclaimed.value() == 0 || !ShouldReclaim()) {
+                    break;
+                }
+                guard.unlock();
+                bool running = m_idle.Sleep(m_options.sliceGapMillis);
+                guard.lock();
+                if (!running) {
+                    break;
+                }
+                // 暂停期间有其他连接提交，让出写锁
+                if (m_idle.PollCommit(handle, Clock::now())) {
+                    std::lock_guard<std::mutex> lock(m_statsMutex);
+                    ++m_stats.interrupted;
+                    break;
+                }
+            }
+        }
+        handle.invalidate();
+    }
+
+    bool ShouldReclaim() const {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        return m_stats.incremental && m_stats.freelistCount > 0 && m_stats.freelistRatio >= m_options.minFreelistRatio
+               && m_stats.reclaimableBytes >= m_options.minFreeBytes;
+    }
+
+    // 执行一次 incremental_vacuum，返回回收的页数；调用方持有 m_reclaimMutex
+    WCDB::Optional<int64_t> Slice(int pages) {
+        int64_t before = GetStats().freelistCount;
+        Clock::time_point start = Clock::now();
+        bool succeed = m_database.incrementalVacuum(pages);
+        double millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        bool refreshed = Refresh();
+
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        if (!succeed || !refreshed) {
+            ++m_stats.failed;
+            return WCDB::NullOpt;
+        }
+        int64_t reclaimed = std::max<int64_t>(before - m_stats.freelistCount, 0);
+        ++m_stats.slices;
+        m_stats.reclaimedPages += (uint64_t) reclaimed;
+        m_stats.lastSliceMillis = millis;
+        m_stats.maxSliceMillis = std::max(m_stats.maxSliceMillis, millis);
+        return reclaimed;
+    }
+
+    WCDB::Database& m_database;
+    ReclaimOptions m_options;
+
+    IdleDetector m_idle;
+
+    // 串行化后台回收、ReclaimNow 和 ConvertToIncremental
+    std::mutex m_reclaimMutex;
+
+    mutable std::mutex m_statsMutex;
+    ReclaimStats m_stats;
+};
+
+SpaceReclaimer::SpaceReclaimer(WCDB::Database& database, const ReclaimOptions& options)
+    : m_impl(new Impl(database, options)) {
+}
+
+SpaceReclaimer::~SpaceReclaimer() = default;
+
+bool SpaceReclaimer::IsIncremental() const {
+    return m_impl->IsIncremental();
+}
+
+bool SpaceReclaimer::ConvertToIncremental() {
+    return m_impl->ConvertToIncremental();
+}
+
+bool SpaceReclaimer::Refresh() {
+    return m_impl->Refresh();
+}
+
+WCDB::Optional<int64_t> SpaceReclaimer::ReclaimNow(int pages) {
+    return m_impl->ReclaimNow(pages);
+}
+
+void SpaceReclaimer::Stop() {
+    m_impl->Stop();
+}
+
+ReclaimStats SpaceReclaimer::GetStats() const {
+    return m_impl->GetStats();
+}
+
+} // namespace Storage
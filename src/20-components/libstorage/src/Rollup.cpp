@@ -0,0 +1,392 @@
+#include "Storage/Rollup.h"
+#include <limits>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace Storage {
+
+namespace {
+
+using BucketMap = std::map<std::pair<std::string, int64_t>, RollupBucket>;
+
+const int64_t kNotDirty = std::numeric_limits<int64_t>::max();
+
+// 向下取整到 width 的整数倍，负数时间也按数轴向下取整
+int64_t FloorTo(int64_t time, int64_t width) {
+    int64_t remainder = time % width;
+    return remainder < 0 ? time - remainder - width : time - remainder;
+}
+
+// 60000 -> "1m"，900000 -> "15m"，3600000 -> "1h"
+std::string LevelLabel(int64_t width) {
+    if (width % 86400000 == 0) {
+        return std::to_string(width / 86400000) + "d";
+    }
+    if (width % 3600000 == 0) {
+        return std::to_string(width / 3600000) + "h";
+    }
+    if (width % 60000 == 0) {
+        return std::to_string(width / 60000) + "m";
+    }
+    if (width % 1000 == 0) {
+        return std::to_string(width / 1000) + "s";
+    }
+    return std::to_string(width) + "ms";
+}
+
+// 把一个点或一个下级桶并入桶中；lastTime 相同时以后并入的为准
+void Accumulate(RollupBucket& bucket, uint64_t count, double sum, double min, double max, int64_t lastTime,
+                double lastValue) {
+    if (count == 0) {
+        return;
+    }
+    if (bucket.count == 0) {
+        bucket.min = min;
+        bucket.max = max;
+        bucket.lastTime = lastTime;
+        bucket.lastValue = lastValue;
+    } else {
+        bucket.min = std::min(bucket.min, min);
+        bucket.max = std::max(bucket.max, max);
+        if (lastTime >= bucket.lastTime) {
+            bucket.lastTime = lastTime;
+            bucket.lastValue = lastValue;
+        }
+    }
+    bucket.count += count;
+    bucket.sum += sum;
+}
+
+RollupBucket& BucketOf(BucketMap& buckets, const std::string& key, int64_t start, int64_t width) {
+    RollupBucket& bucket = buckets[std::make_pair(key, start)];
+    if (bucket.count == 0) {
+        bucket.key = key;
+        bucket.start = start;
+        bucket.width = width;
+    }
+    return bucket;
+}
+
+// 汇总表的列
+WCDB::Column KeyColumn() { return WCDB::Column("key"); }
+WCDB::Column BucketColumn() { return WCDB::Column("bucket"); }
+WCDB::Column CountColumn() { return WCDB::Column("count"); }
+WCDB::Column SumColumn() { return WCDB::Column("sum"); }
+WCDB::Column MinColumn() { return WCDB::Column("min"); }
+WCDB::Column MaxColumn() { return WCDB::Column("max"); }
+WCDB::Column LastTimeColumn() { return WCDB::Column("last_time"); }
+WCDB::Column LastValueColumn() { return WCDB::Column("last_value"); }
+
+WCDB::ResultColumns RollupColumns() {
+    return { KeyColumn(), BucketColumn(), CountColumn(), SumColumn(), MinColumn(), MaxColumn(),
+             LastTimeColumn(), LastValueColumn() };
+}
+
+} // namespace
+
+class RollupEngine::Impl {
+public:
+    Impl(WCDB::Database& database, const RollupSource& source, const RollupOptions& options)
+        : m_database(database), m_source(source), m_options(options) {
+        m_name = m_options.name.empty() ? m_source.table + "_rollup" : m_options.name;
+        m_valid = !m_options.levels.empty() && !m_source.table.empty() && !m_source.timeColumn.empty()
+                  && !m_source.valueColumn.empty();
+        for (size_t i = 0; m_valid && i < m_options.levels.size(); i++) {
+            int64_t width = m_options.levels[i];
+            m_valid = width > 0 && (i == 0 || width % m_options.levels[i - 1] == 0);
+        }
+        for (size_t i = 0; m_valid && i < m_options.levels.size(); i++) {
+            WCDB::StatementCreateTable create;
+            create.createTable(LevelTable(i)).ifNotExists()
+                .define(WCDB::ColumnDef(KeyColumn(), WCDB::ColumnType::Text).constraint(WCDB::ColumnConstraint().notNull()))
+                .define(WCDB::ColumnDef(BucketColumn(), WCDB::ColumnType::Integer).constraint(WCDB::ColumnConstraint().notNull()))
+                .define(WCDB::ColumnDef(CountColumn(), WCDB::ColumnType::Integer))
+                .define(WCDB::ColumnDef(SumColumn(), WCDB::ColumnType::Float))
+                .define(WCDB::ColumnDef(MinColumn(), WCDB::ColumnType::Float))
+                .define(WCDB::ColumnDef(MaxColumn(), WCDB::ColumnType::Float))
+                .define(WCDB::ColumnDef(LastTimeColumn(), WCDB::ColumnType::Integer))
+                .define(WCDB::ColumnDef(LastValueColumn(), WCDB::ColumnType::Float))
+                .constraint(WCDB::TableConstraint().primaryKey().indexed(KeyColumn()).indexed(BucketColumn()))
+                .withoutRowID();
+            m_valid = m_database.execute(create);
+        }
+    }
+
+    bool IsValid() const { return m_valid; }
+
+    const std::vector<int64_t>& Levels() const { return m_options.levels; }
+
+    std::string LevelTable(size_t level) const {
+        return m_name + "_" + LevelLabel(m_options.levels[level]);
+    }
+
+    const RollupSource& Source() const { return m_source; }
+
+    WCDB::Database& Database() { return m_database; }
+
+    void MarkDirty(int64_t time) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dirtyFrom = std::min(m_dirtyFrom, time);
+    }
+
+    bool Refresh() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_valid) {
+            return false;
+        }
+        uint64_t rowsRead = 0;
+        bool succeed = m_database.runTransaction([&](WCDB::Handle& handle) {
+            // 从最细一级最后一个桶开始重算：该桶可能还没写满，其后是上次汇总之后到达的行
+            bool fullRebuild = false;
+            int64_t from = m_dirtyFrom;
+            auto last = handle.getValueFromStatement(
+                WCDB::StatementSelect().select(BucketColumn().max()).from(LevelTable(0)));
+            if (!last.hasValue()) {
+                return false;
+            }
+            if (last.value().isNull()) {
+                fullRebuild = true;
+            } else {
+                from = std::min(from, last.value().intValue());
+            }
+
+            int64_t start = fullRebuild ? 0 : FloorTo(from, m_options.levels[0]);
+            BucketMap buckets;
+            if (!AggregateSource(handle, fullRebuild, start, kNotDirty, nullptr, m_options.levels[0], buckets, rowsRead)
+                || !Replace(handle, 0, fullRebuild, start, buckets)) {
+                return false;
+            }
+            for (size_t level = 1; level < m_options.levels.size(); level++) {
+                int64_t width = m_options.levels[level];
+                start = fullRebuild ? 0 : FloorTo(start, width);
+                buckets.clear();
+                if (!AggregateLevel(handle, level - 1, fullRebuild, start, kNotDirty, nullptr, width, buckets, rowsRead)
+                    || !Replace(handle, level, fullRebuild, start, buckets)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        if (succeed) {
+            m_dirtyFrom = kNotDirty;
+            m_lastRefreshRows = rowsRead;
+        }
+        return succeed;
+    }
+
+    int LevelFor(int64_t resolution) const {
+        // 只有桶宽整除分辨率时，每个汇总桶才完整落在一个结果桶内
+        int chosen = -1;
+        for (size_t i = 0; i < m_options.levels.size(); i++) {
+            if (resolution > 0 && m_options.levels[i] > 0 && resolution % m_options.levels[i] == 0) {
+                chosen = (int) i;
+            }
+        }
+        return chosen;
+    }
+
+    WCDB::Optional<std::vector<RollupBucket>> Query(const std::string& key, int64_t from, int64_t to, int64_t resolution) {
+        if (!m_valid || resolution <= 0 || from >= to) {
+            return WCDB::NullOpt;
+        }
+        const std::string* filter = m_source.keyColumn.empty() ? nullptr : &key;
+        // 按结果桶对齐，首尾都是完整的桶
+        from = FloorTo(from, resolution);
+        to = FloorTo(to - 1, resolution) + resolution;
+        int level = LevelFor(resolution);
+        BucketMap buckets;
+        uint64_t rowsRead = 0;
+        WCDB::Handle handle = m_database.getHandle();
+        bool succeed;
+        if (level < 0) {
+            succeed = AggregateSource(handle, false, from, to, filter, resolution, buckets, rowsRead);
+        } else {
+            succeed = AggregateLevel(handle, (size_t) level, false, from, to, filter, resolution, buckets, rowsRead);
+        }
+        handle.invalidate();
+        if (!succeed) {
+            return WCDB::NullOpt;
+        }
+        std::vector<RollupBucket> result;
+        result.reserve(buckets.size());
+        for (auto& entry : buckets) {
+            result.push_back(std::move(entry.second));
+        }
+        return result;
+    }
+
+    uint64_t LastRefreshRows() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lastRefreshRows;
+    }
+
+private:
+    // 按 width 聚合原始表中时间在 [from, to) 的行；fullRebuild 时不限制起点
+    bool AggregateSource(WCDB::Handle& handle, bool fullRebuild, int64_t from, int64_t to, const std::string* key,
+                         int64_t width, BucketMap& buckets, uint64_t& rowsRead) {
+        WCDB::Column time(m_source.timeColumn);
+        WCDB::Column value(m_source.valueColumn);
+        WCDB::ResultColumns columns = { time, value };
+        if (!m_source.keyColumn.empty()) {
+            columns.push_back(WCDB::Column(m_source.keyColumn));
+        }
+        WCDB::Expression condition = value.notNull();
+        if (!fullRebuild) {
+            condition = condition && time >= from;
+        }
+        if (to != kNotDirty) {
+            condition = condition && time < to;
+        }
+        if (key != nullptr) {
+            condition = condition && WCDB::Column(m_source.keyColumn) == *key;
+        }
+        WCDB::StatementSelect select;
+        select.select(columns).from(m_source.table).where(condition).order(time.asOrder(WCDB::Order::ASC));
+        if (!handle.prepare(select)) {
+            return false;
+        }
+        bool succeed;
+        std::string rowKey;
+        while ((succeed = handle.step()) && !handle.done()) {
+            int64_t timestamp = handle.getInteger(0);
+            double number = handle.getDouble(1);
+            if (columns.size() > 2) {
+                WCDB::UnsafeStringView text = handle.getText(2);
+                rowKey.assign(text.data(), text.length());
+            }
+            RollupBucket& bucket = BucketOf(buckets, rowKey, FloorTo(timestamp, width), width);
+            Accumulate(bucket, 1, number, number, number, timestamp, number);
+            ++rowsRead;
+        }
+        handle.finalize();
+        return succeed;
+    }
+
+    // 把 level 级汇总表中桶起点在 [from, to) 的行合并成 width 宽的桶
+    bool AggregateLevel(WCDB::Handle& handle, size_t level, bool fullRebuild, int64_t from, int64_t to,
+                        const std::string* key, int64_t width, BucketMap& buckets, uint64_t& rowsRead) {
+        WCDB::Expression condition = BucketColumn() >= (fullRebuild ? std::numeric_limits<int64_t>::min() : from);
+        if (to != kNotDirty) {
+            condition = condition && BucketColumn() < to;
+        }
+        if (key != nullptr) {
+            condition = condition && KeyColumn() == *key;
+        }
+        WCDB::StatementSelect select;
+        select.select(RollupColumns()).from(LevelTable(level)).where(condition)
+            .order(BucketColumn().asOrder(WCDB::Order::ASC));
+        if (!handle.prepare(select)) {
+            return false;
+        }
+        bool succeed;
+        std::string rowKey;
+        while ((succeed = handle.step()) && !handle.done()) {
+            WCDB::UnsafeStringView text = handle.getText(0);
+            rowKey.assign(text.data(), text.length());
+            RollupBucket& bucket = BucketOf(buckets, rowKey, FloorTo(handle.getInteger(1), width), width);
+            Accumulate(bucket, (uint64_t) handle.getInteger(2), handle.getDouble(3), handle.getDouble(4),
+                       handle.getDouble(5), handle.getInteger(6), handle.getDouble(7));
+            ++rowsRead;
+        }
+        handle.finalize();
+        return succeed;
+    }
+
+    // 删除 level 级汇总表中起点不早于 from 的桶，写入重算后的桶
+    bool Replace(WCDB::Handle& handle, size_t level, bool fullRebuild, int64_t from, const BucketMap& buckets) {
+        WCDB::StatementDelete remove;
+        remove.deleteFrom(LevelTable(level));
+        if (!fullRebuild) {
+            remove.where(BucketColumn() >= from);
+        }
+        if (!handle.execute(remove)) {
+            return false;
+        }
+        WCDB::StatementInsert insert;
+        insert.insertIntoTable(LevelTable(level))
+            .columns({ KeyColumn(), BucketColumn(), CountColumn(), SumColumn(), MinColumn(), MaxColumn(),
+                       LastTimeColumn(), LastValueColumn() })
+            .values(WCDB::BindParameter::bindParameters(8));
+        if (!handle.prepare(insert)) {
+            return false;
+        }
+        for (const auto& entry : buckets) {
+            const RollupBucket& bucket = entry.second;
+            handle.reset();
+            handle.bindText(WCDB::UnsafeStringView(bucket.key.data(), bucket.key.size()), 1);
+            handle.bindInteger(bucket.start, 2);
+            handle.bindInteger((int64_t) bucket.count, 3);
+            handle.bindDouble(bucket.sum, 4);
+            handle.bindDouble(bucket.min, 5);
+            handle.bindDouble(bucket.max, 6);
+            handle.bindInteger(bucket.lastTime, 7);
+            handle.bindDouble(bucket.lastValue, 8);
+            if (!handle.step()) {
+                handle.finalize();
+                return false;
+            }
+        }
+        handle.finalize();
+        return true;
+    }
+
+    WCDB::Database& m_database;
+    RollupSource m_source;
+    RollupOptions m_options;
+    std::string m_name;
+    bool m_valid = false;
+
+    mutable std::mutex m_mutex;
+    int64_t m_dirtyFrom = kNotDirty;
+    uint64_t m_lastRefreshRows = 0;
+};
+
+RollupEngine::RollupEngine(WCDB::Database& database, const RollupSource& source, const RollupOptions& options)
+    : m_impl(new Impl(database, source, options)) {
+}
+
+RollupEngine::~RollupEngine() = default;
+
+bool RollupEngine::IsValid() const {
+    return m_impl->IsValid();
+}
+
+const std::vector<int64_t>& RollupEngine::Levels() const {
+    return m_impl->Levels();
+}
+
+std::string RollupEngine::LevelTable(size_t level) const {
+    return m_impl->LevelTable(level);
+}
+
+void RollupEngine::MarkDirty(int64_t time) {
+    m_impl->MarkDirty(time);
+}
+
+bool RollupEngine::Refresh() {
+    return m_impl->Refresh();
+}
+
+int RollupEngine::LevelFor(int64_t resolution) const {
+    return m_impl->LevelFor(resolution);
+}
+
+WCDB::Optional<std::vector<RollupBucket>> RollupEngine::Query(const std::string& key, int64_t from, int64_t to,
+                                                              int64_t resolution) {
+    return m_impl->Query(key, from, to, resolution);
+}
+
+uint64_t RollupEngine::LastRefreshRows() const {
+    return m_impl->LastRefreshRows();
+}
+
+WCDB::Database& RollupEngine::Database() {
+    return m_impl->Database();
+}
+
+const RollupSource& RollupEngine::Source() const {
+    return m_impl->Source();
+}
+
+} // namespace Storage
@@ -0,0 +1,437 @@
+#include "Storage/SqlTrace.h"
+#include "Utility/ThreadLocalStats.h"
+#include "nlohmann/json.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+namespace Storage {
+
+namespace {
+
+// 指纹表已满时仍缓存原始语句到计数器的映射，数量受限以免内联字面量的语句占满内存
+constexpr size_t kRawCacheLimit = 4 * kSqlFingerprintsPerThread;
+
+std::atomic<bool> g_enabled{false};
+std::atomic<uint64_t> g_slowNanos{100 * 1000 * 1000};
+std::atomic<unsigned> g_slowLogsPerSecond{10};
+std::atomic<size_t> g_maxFingerprintLength{512};
+
+std::atomic<int64_t> g_slowWindow{0};
+std::atomic<unsigned> g_slowInWindow{0};
+std::atomic<uint64_t> g_suppressedSlowLogs{0};
+std::atomic<uint64_t> g_baselineSuppressed{0};
+
+using Utility::Stats::Accumulate;
+using Utility::Stats::AccumulateMax;
+
+uint64_t Hash(const char* data, size_t length) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool IsIdentifier(char c) {
+    return std::isalnum((unsigned char) c) || c == '_' || c == '$';
+}
+
+struct Counters {
+    Counters(uint64_t hash_, std::string fingerprint_) : hash(hash_), fingerprint(std::move(fingerprint_)) {
+        for (auto& bucket : latencyHistogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const uint64_t hash;
+    const std::string fingerprint;
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> slowCalls{0};
+    std::atomic<uint64_t> totalNanos{0};
+    std::atomic<uint64_t> maxNanos{0};
+    std::atomic<uint64_t> pagesRead{0};
+    std::atomic<uint64_t> pagesWritten{0};
+    std::array<std::atomic<uint64_t>, kSqlLatencyBuckets> latencyHistogram;
+};
+
+using EntryMap = std::unordered_map<uint64_t, SqlTraceEntry>;
+
+// 按指纹哈希汇总的结果
+struct TraceTotals {
+    EntryMap entries;
+    uint64_t dropped = 0;
+};
+
+void AddTo(SqlTraceEntry& entry, const Counters& counters) {
+    if (entry.fingerprint.empty()) {
+        entry.fingerprint = counters.fingerprint;
+    }
+    entry.calls += counters.calls.load(std::memory_order_relaxed);
+    entry.slowCalls += counters.slowCalls.load(std::memory_order_relaxed);
+    entry.totalNanos += counters.totalNanos.load(std::memory_order_relaxed);
+    entry.maxNanos = std::max(entry.maxNanos, counters.maxNanos.load(std::memory_order_relaxed));
+    entry.pagesRead += counters.pagesRead.load(std::memory_order_relaxed);
+    entry.pagesWritten += counters.pagesWritten.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kSqlLatencyBuckets; i++) {
+        entry.latencyHistogram[i] += counters.latencyHistogram[i].load(std::memory_order_relaxed);
+    }
+}
+
+// 线程本地统计块：按指纹哈希开放寻址，计数器按需分配，发布后不再移动
+class ThreadTrace {
+public:
+    ThreadTrace() {
+        for (auto& slot : m_slots) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadTrace() {
+        for (auto& slot : m_slots) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    // 返回语句所属指纹的计数器，指纹表已满时返回 nullptr
+    Counters* Find(const WCDB::UnsafeStringView& sql) {
+        uint64_t raw = Hash(sql.data(), sql.length());
+        auto cached = m_rawCache.find(raw);
+        if (cached != m_rawCache.end()) {
+            return cached->second;
+        }
+        std::string fingerprint = FingerprintSql(sql, g_maxFingerprintLength.load(std::memory_order_relaxed));
+        Counters* counters = Insert(Hash(fingerprint.data(), fingerprint.size()), std::move(fingerprint));
+        if (m_rawCache.size() < kRawCacheLimit) {
+            m_rawCache.emplace(raw, counters);
+        }
+        return counters;
+    }
+
+    void Drop() { Accumulate(m_dropped, 1); }
+
+    void MergeInto(TraceTotals& totals) const {
+        for (const auto& slot : m_slots) {
+            const Counters* counters = slot.load(std::memory_order_acquire);
+            if (counters != nullptr) {
+                AddTo(totals.entries[counters->hash], *counters);
+            }
+        }
+        totals.dropped += m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    Counters* Insert(uint64_t hash, std::string fingerprint) {
+        for (size_t i = 0; i < kSqlFingerprintsPerThread; i++) {
+            auto& slot = m_slots[(hash + i) % kSqlFingerprintsPerThread];
+            Counters* counters = slot.load(std::memory_order_relaxed);
+            if (counters == nullptr) {
+                counters = new Counters(hash, std::move(fingerprint));
+                slot.store(counters, std::memory_order_release);
+                return counters;
+            }
+            if (counters->hash == hash) {
+                return counters;
+            }
+        }
+        return nullptr;
+    }
+
+    std::array<std::atomic<Counters*>, kSqlFingerprintsPerThread> m_slots;
+    std::atomic<uint64_t> m_dropped{0};
+    // 只由所属线程访问
+    std::unordered_map<uint64_t, Counters*> m_rawCache;
+};
+
+using Registry = Utility::Stats::ThreadLocalRegistry<ThreadTrace, TraceTotals>;
+
+// 按秒限制慢查询日志条数，窗口切换时的少量竞争可以接受
+void LogSlowQuery(const std::string& fingerprint, uint64_t nanos, uint64_t pagesRead, uint64_t pagesWritten) {
+    int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+                     std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t window = g_slowWindow.load(std::memory_order_relaxed);
+    if (window != second && g_slowWindow.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+        g_slowInWindow.store(0, std::memory_order_relaxed);
+    }
+    if (g_slowInWindow.fetch_add(1, std::memory_order_relaxed) >= g_slowLogsPerSecond.load(std::memory_order_relaxed)) {
+        g_suppressedSlowLogs.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    SPDLOG_WARN("慢查询: 耗时={:.3f} 毫秒 读页={} 写页={} 语句={}", nanos / 1e6, pagesRead, pagesWritten, fingerprint);
+}
+
+void ApplyOptions(const SqlTraceOptions& options) {
+    g_slowNanos.store(options.slowQueryMicros * 1000, std::memory_order_relaxed);
+    g_slowLogsPerSecond.store(options.slowLogsPerSecond, std::memory_order_relaxed);
+    g_maxFingerprintLength.store(options.maxFingerprintLength, std::memory_order_relaxed);
+    g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void OnPerformance(long, const WCDB::UnsafeStringView&, uint64_t, const WCDB::UnsafeStringView& sql,
+                   const WCDB::Database::PerformanceInfo& info) {
+    uint64_t pagesRead = (uint64_t) (info.tablePageReadCount + info.indexPageReadCount + info.overflowPageReadCount);
+    uint64_t pagesWritten = (uint64_t) (info.tablePageWriteCount + info.indexPageWriteCount
+                                        + info.overflowPageWriteCount);
+    RecordSql(sql, info.costInNanoseconds > 0 ? (uint64_t) info.costInNanoseconds : 0, pagesRead, pagesWritten);
+}
+
+// 把从 begin 开始的 "?, ?, ?" 合并为 "?, ..."，返回合并后应继续扫描的位置
+size_t CollapseList(const std::string& text, size_t begin, std::string& out) {
+    size_t end = begin + 1;
+    bool repeated = false;
+    while (true) {
+        size_t next = end;
+        while (next < text.size() && text[next] == ' ') {
+            next++;
+        }
+        if (next >= text.size() || text[next] != ',') {
+            break;
+        }
+        next++;
+        while (next < text.size() && text[next] == ' ') {
+            next++;
+        }
+        if (next >= text.size() || text[next] != '?') {
+            break;
+        }
+        end = next + 1;
+        repeated = true;
+    }
+    out += repeated ? "?, ..." : "?";
+    return end;
+}
+
+} // namespace
+
+std::string FingerprintSql(const WCDB::UnsafeStringView& sql, size_t maxLength) {
+    const char* text = sql.data();
+    size_t length = sql.length();
+    std::string normalized;
+    normalized.reserve(std::min(length, maxLength) + 8);
+
+    size_t i = 0;
+    while (i < length && normalized.size() < maxLength) {
+        char c = text[i];
+        if (std::isspace((unsigned char) c)) {
+            while (i < length && std::isspace((unsigned char) text[i])) {
+                i++;
+            }
+            if (!normalized.empty() && normalized.back() != ' ') {
+                normalized.push_back(' ');
+            }
+        } else if (c == '\'') {
+            // 字符串字面量，'' 为转义的单引号
+            for (i++; i < length; i++) {
+                if (text[i] == '\'') {
+                    if (i + 1 < length && text[i + 1] == '\'') {
+                        i++;
+                        continue;
+                    }
+                    i++;
+                    break;
+                }
+            }
+            normalized.push_back('?');
+        } else if (c == '"' || c == '`' || c == '[') {
+            // 带引号的标识符原样保留
+            char close = c == '[' ? ']' : c;
+            size_t begin = i++;
+            while (i < length && text[i] != close) {
+                i++;
+            }
+            i = std::min(i + 1, length);
+            normalized.append(text + begin, i - begin);
+        } else if (std::isdigit((unsigned char) c)) {
+            if (c == '0' && i + 1 < length && (text[i + 1] == 'x' || text[i + 1] == 'X')) {
+                for (i += 2; i < length && std::isxdigit((unsigned char) text[i]); i++) {}
+            } else {
+                while (i < length && (std::isdigit((unsigned char) text[i]) || text[i] == '.')) {
+                    i++;
+                }
+                if (i < length && (text[i] == 'e' || text[i] == 'E')) {
+                    i++;
+                    if (i < length && (text[i] == '+' || text[i] == '-')) {
+                        i++;
+                    }
+                    while (i < length && std::isdigit((unsigned char) text[i])) {
+                        i++;
+                    }
+                }
+            }
+            normalized.push_back('?');
+        } else if (c == '?' || ((c == ':' || c == '@') && i + 1 < length && IsIdentifier(text[i + 1]))) {
+            // 绑定参数 ?NNN / :name / @name 统一为 ?
+            for (i++; i < length && IsIdentifier(text[i]); i++) {}
+            normalized.push_back('?');
+        } else if (IsIdentifier(c)) {
+            // 整段复制标识符，其中的数字不当作字面量
+            size_t begin = i;
+            while (i < length && IsIdentifier(text[i])) {
+                i++;
+            }
+            normalized.append(text + begin, i - begin);
+        } else {
+            normalized.push_back(c);
+            i++;
+        }
+    }
+    while (!normalized.empty() && normalized.back() == ' ') {
+        normalized.pop_back();
+    }
+
+    std::string fingerprint;
+    fingerprint.reserve(normalized.size());
+    for (size_t j = 0; j < normalized.size();) {
+        if (normalized[j] == '?') {
+            j = CollapseList(normalized, j, fingerprint);
+        } else {
+            fingerprint.push_back(normalized[j++]);
+        }
+    }
+    if (fingerprint.size() > maxLength) {
+        fingerprint.resize(maxLength);
+    }
+    return fingerprint;
+}
+
+void StartSqlTrace(const SqlTraceOptions& options) {
+    ApplyOptions(options);
+    WCDB::Database::globalTracePerformance(OnPerformance);
+}
+
+void AttachSqlTrace(WCDB::Database& database, const SqlTraceOptions& options) {
+    ApplyOptions(options);
+    database.tracePerformance(OnPerformance);
+}
+
+void StopSqlTrace() {
+    g_enabled.store(false, std::memory_order_relaxed);
+    WCDB::Database::globalTracePerformance(nullptr);
+}
+
+bool IsSqlTraceEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void RecordSql(const WCDB::UnsafeStringView& sql, uint64_t nanos, uint64_t pagesRead, uint64_t pagesWritten) {
+    if (!g_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ThreadTrace& trace = Registry::Instance().Local();
+    Counters* counters = trace.Find(sql);
+    uint64_t slowNanos = g_slowNanos.load(std::memory_order_relaxed);
+    bool slow = slowNanos > 0 && nanos >= slowNanos;
+    if (counters == nullptr) {
+        trace.Drop();
+    } else {
+        Accumulate(counters->calls, 1);
+        Accumulate(counters->totalNanos, nanos);
+        AccumulateMax(counters->maxNanos, nanos);
+        Accumulate(counters->pagesRead, pagesRead);
+        Accumulate(counters->pagesWritten, pagesWritten);
+        Accumulate(counters->latencyHistogram[Utility::Stats::LatencyBucket(nanos, kSqlLatencyBuckets)], 1);
+        if (slow) {
+            Accumulate(counters->slowCalls, 1);
+        }
+    }
+    if (slow) {
+        LogSlowQuery(counters != nullptr ? counters->fingerprint
+                                         : FingerprintSql(sql, g_maxFingerprintLength.load(std::memory_order_relaxed)),
+                     nanos, pagesRead, pagesWritten);
+    }
+}
+
+uint64_t SqlTraceEntry::LatencyPercentileMicros(double percentile) const {
+    return Utility::Stats::HistogramPercentileMicros(latencyHistogram, percentile);
+}
+
+std::string SqlTraceSnapshot::ToJson(int indent) const {
+    nlohmann::json entriesJson = nlohmann::json::array();
+    for (const auto& entry : entries) {
+        nlohmann::json item;
+        item["fingerprint"] = entry.fingerprint;
+        item["calls"] = entry.calls;
+        item["slow_calls"] = entry.slowCalls;
+        item["total_ns"] = entry.totalNanos;
+        item["max_ns"] = entry.maxNanos;
+        item["avg_us"] = entry.calls > 0 ? entry.totalNanos / entry.calls / 1000 : 0;
+        item["p50_us"] = entry.LatencyPercentileMicros(0.5);
+        item["p99_us"] = entry.LatencyPercentileMicros(0.99);
+        item["pages_read"] = entry.pagesRead;
+        item["pages_written"] = entry.pagesWritten;
+        item["latency_histogram_us"] = entry.latencyHistogram;
+        entriesJson.push_back(item);
+    }
+
+    nlohmann::json root;
+    root["enabled"] = IsSqlTraceEnabled();
+    root["slow_query_us"] = g_slowNanos.load(std::memory_order_relaxed) / 1000;
+    root["dropped_calls"] = droppedCalls;
+    root["suppressed_slow_logs"] = suppressedSlowLogs;
+    root["entries"] = entriesJson;
+    return root.dump(indent);
+}
+
+SqlTraceSnapshot GetSqlTraceSnapshot() {
+    TraceTotals totals = Registry::Instance().Collect();
+    TraceTotals baseline = Registry::Instance().Baseline();
+
+    SqlTraceSnapshot snapshot;
+    for (auto& total : totals.entries) {
+        SqlTraceEntry& entry = total.second;
+        auto base = baseline.entries.find(total.first);
+        if (base != baseline.entries.end()) {
+            // maxNanos 无法扣除基线，保留重置前的最大值
+            entry.calls -= base->second.calls;
+            entry.slowCalls -= base->second.slowCalls;
+            entry.totalNanos -= base->second.totalNanos;
+            entry.pagesRead -= base->second.pagesRead;
+            entry.pagesWritten -= base->second.pagesWritten;
+            for (size_t b = 0; b < kSqlLatencyBuckets; b++) {
+                entry.latencyHistogram[b] -= base->second.latencyHistogram[b];
+            }
+        }
+        if (entry.calls > 0) {
+            snapshot.entries.push_back(std::move(entry));
+        }
+    }
+    snapshot.droppedCalls = totals.dropped - baseline.dropped;
+    snapshot.suppressedSlowLogs = g_suppressedSlowLogs.load(std::memory_order_relaxed)
+                                  - g_baselineSuppressed.load(std::memory_order_relaxed);
+    std::sort(snapshot.entries.begin(), snapshot.entries.end(), [](const SqlTraceEntry& a, const SqlTraceEntry& b) {
+        return a.totalNanos > b.totalNanos;
+    });
+    return snapshot;
+}
+
+void ResetSqlTrace() {
+    Registry::Instance().ResetBaseline();
+    g_baselineSuppressed.store(g_suppressedSlowLogs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void LogSqlTrace(size_t top) {
+    SqlTraceSnapshot snapshot = GetSqlTraceSnapshot();
+    if (snapshot.entries.empty()) {
+        SPDLOG_INFO("SQL 统计: 暂无数据");
+        return;
+    }
+    for (size_t i = 0; i < snapshot.entries.size() && i < top; i++) {
+        const SqlTraceEntry& entry = snapshot.entries[i];
+        SPDLOG_INFO("SQL 统计: 调用={} 累计={:.3f} 毫秒 平均={} 微秒 p99<={} 微秒 慢={} 读页={} 写页={} 语句={}",
+                    entry.calls, entry.totalNanos / 1e6, entry.totalNanos / entry.calls / 1000,
+                    entry.LatencyPercentileMicros(0.99), entry.slowCalls, entry.pagesRead, entry.pagesWritten,
+                    entry.fingerprint);
+    }
+    if (snapshot.droppedCalls > 0 || snapshot.suppressedSlowLogs > 0) {
+        SPDLOG_INFO("SQL 统计: 未单独统计的调用={} 未输出的慢查询日志={}", snapshot.droppedCalls,
+                    snapshot.suppressedSlowLogs);
+    }
+}
+
+} // namespace Storage
@@ -0,0 +1,513 @@
+#include "Storage/TimeSeries.h"
+#include "Utility/Compression.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace Storage {
+
+namespace {
+
+// 块编码格式版本，写入 encoding 列，解码时按版本选择格式
+const int64_t kEncodingDeltaXor = 1;
+
+void PutVarint(std::vector<char>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((char) (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char) value);
+}
+
+bool GetVarint(const char*& cursor, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = (uint8_t) *cursor++;
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t ZigZag(int64_t value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+// 以无符号运算求差，避免极端时间戳相减溢出
+int64_t Difference(int64_t a, int64_t b) {
+    return (int64_t) ((uint64_t) a - (uint64_t) b);
+}
+
+/**
+ * 块编码：
+ *   varint count
+ *   时间戳：第一个点 zigzag(timestamp)，之后每个点 zigzag(本次差分 - 上次差分)
+ *   数值：每个值与前一个值的位模式异或，按字节拆成 8 个平面（最高字节在前），每个平面 count 字节
+ */
+std::vector<char> EncodeBlock(const std::vector<TimeSeriesPoint>& points) {
+    std::vector<char> out;
+    out.reserve(points.size() * 10 + 10);
+    PutVarint(out, points.size());
+    int64_t previous = 0;
+    int64_t previousDelta = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        int64_t timestamp = points[i].timestamp;
+        if (i == 0) {
+            PutVarint(out, ZigZag(timestamp));
+        } else {
+            int64_t delta = Difference(timestamp, previous);
+            PutVarint(out, ZigZag(Difference(delta, previousDelta)));
+            previousDelta = delta;
+        }
+        previous = timestamp;
+    }
+
+    size_t count = points.size();
+    size_t base = out.size();
+    out.resize(base + count * 8);
+    uint64_t previousBits = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits;
+        memcpy(&bits, &points[i].value, sizeof(bits));
+        uint64_t delta = bits ^ previousBits;
+        previousBits = bits;
+        for (size_t plane = 0; plane < 8; plane++) {
+            out[base + plane * count + i] = (char) (delta >> (56 - plane * 8));
+        }
+    }
+    return out;
+}
+
+bool DecodeBlock(const std::vector<char>& data, std::vector<TimeSeriesPoint>& points) {
+    const char* cursor = data.data();
+    const char* end = cursor + data.size();
+    uint64_t count = 0;
+    if (!GetVarint(cursor, end, count) || count > data.size()) {
+        return false;
+    }
+    points.resize(count);
+    int64_t previous = 0;
+    int64_t previousDelta = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t encoded = 0;
+        if (!GetVarint(cursor, end, encoded)) {
+            return false;
+        }
+        if (i == 0) {
+            previous = UnZigZag(encoded);
+        } else {
+            previousDelta = (int64_t) ((uint64_t) previousDelta + (uint64_t) UnZigZag(encoded));
+            previous = (int64_t) ((uint64_t) previous + (uint64_t) previousDelta);
+        }
+        points[i].timestamp = previous;
+    }
+
+    if ((size_t) (end - cursor) != count * 8) {
+        return false;
+    }
+    uint64_t previousBits = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t delta = 0;
+        for (size_t plane = 0; plane < 8; plane++) {
+            delta |= (uint64_t) (uint8_t) cursor[plane * count + i] << (56 - plane * 8);
+        }
+        previousBits ^= delta;
+        memcpy(&points[i].value, &previousBits, sizeof(previousBits));
+    }
+    return true;
+}
+
+void Merge(Utility::Aggregate::Summary<double>& target, const Utility::Aggregate::Summary<double>& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (target.count == 0) {
+        target = other;
+        return;
+    }
+    target.sum += other.sum;
+    target.min = std::min(target.min, other.min);
+    target.max = std::max(target.max, other.max);
+    target.count += other.count;
+}
+
+// 块表的列
+WCDB::Column SeriesColumn() { return WCDB::Column("series"); }
+WCDB::Column BeginColumn() { return WCDB::Column("begin_time"); }
+WCDB::Column EndColumn() { return WCDB::Column("end_time"); }
+WCDB::Column CountColumn() { return WCDB::Column("count"); }
+WCDB::Column MinColumn() { return WCDB::Column("min_value"); }
+WCDB::Column MaxColumn() { return WCDB::Column("max_value"); }
+WCDB::Column SumColumn() { return WCDB::Column("sum_value"); }
+WCDB::Column RawSizeColumn() { return WCDB::Column("raw_size"); }
+WCDB::Column EncodingColumn() { return WCDB::Column("encoding"); }
+WCDB::Column DataColumn() { return WCDB::Column("data"); }
+
+// 与查询范围重叠的一个块，data 为压缩后的数据
+struct StoredBlock {
+    int64_t rowid = 0;
+    int64_t begin = 0;
+    int64_t end = 0;
+    Utility::Aggregate::Summary<double> summary;
+    int64_t rawSize = 0;
+    int64_t encoding = 0;
+    std::vector<char> data;
+};
+
+} // namespace
+
+class TimeSeriesStore::Impl {
+public:
+    Impl(WCDB::Database& database, const TimeSeriesOptions& options)
+        : m_database(database), m_options(options) {
+        if (m_options.pointsPerBlock == 0) {
+            m_options.pointsPerBlock = 1;
+        }
+        WCDB::StatementCreateTable create;
+        create.createTable(m_options.table).ifNotExists()
+            .define(WCDB::ColumnDef(SeriesColumn(), WCDB::ColumnType::Text).constraint(WCDB::ColumnConstraint().notNull()))
+            .define(WCDB::ColumnDef(BeginColumn(), WCDB::ColumnType::Integer))
+            .define(WCDB::ColumnDef(EndColumn(), WCDB::ColumnType::Integer))
+            .define(WCDB::ColumnDef(CountColumn(), WCDB::ColumnType::Integer))
+            .define(WCDB::ColumnDef(MinColumn(), WCDB::ColumnType::Float))
+            .define(WCDB::ColumnDef(MaxColumn(), WCDB::ColumnType::Float))
+            .define(WCDB::ColumnDef(SumColumn(), WCDB::ColumnType::Float))
+            .define(WCDB::ColumnDef(RawSizeColumn(), WCDB::ColumnType::Integer))
+            .define(WCDB::ColumnDef(EncodingColumn(), WCDB::ColumnType::Integer))
+            .define(WCDB::ColumnDef(DataColumn(), WCDB::ColumnType::BLOB));
+        // 范围查询按 series 定位，再按 end_time >= from 跳过更早的块
+        WCDB::StatementCreateIndex index;
+        index.createIndex(m_options.table + "_series_end_index").ifNotExists().table(m_options.table)
+            .indexed(SeriesColumn()).indexed(EndColumn());
+        m_valid = m_database.execute(create) && m_database.execute(index);
+    }
+
+    ~Impl() { Flush(); }
+
+    bool IsValid() const { return m_valid; }
+
+    bool Append(const std::string& series, const TimeSeriesPoint* points, size_t count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<TimeSeriesPoint>& buffer = m_buffers[series];
+        bool succeed = true;
+        for (size_t i = 0; i < count; i++) {
+            buffer.push_back(points[i]);
+            // 写入失败时缓冲区继续增长，每再攒满一块重试一次
+            if (buffer.size() % m_options.pointsPerBlock == 0) {
+                succeed = Seal(series, buffer) && succeed;
+            }
+        }
+        m_stats.appendedPoints += count;
+        return succeed;
+    }
+
+    bool Flush() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool succeed = true;
+        for (auto& entry : m_buffers) {
+            if (!entry.second.empty()) {
+                succeed = Seal(entry.first, entry.second) && succeed;
+            }
+        }
+        return succeed;
+    }
+
+    WCDB::Optional<std::vector<TimeSeriesPoint>> Query(const std::string& series, int64_t from, int64_t to) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<StoredBlock> blocks;
+        if (!LoadBlocks(series, from, to, true, blocks)) {
+            return WCDB::NullOpt;
+        }
+        std::vector<TimeSeriesPoint> result;
+        std::vector<TimeSeriesPoint> decoded;
+        for (const StoredBlock& block : blocks) {
+            if (!Decode(block, decoded)) {
+                return WCDB::NullOpt;
+            }
+            for (const TimeSeriesPoint& point : decoded) {
+                if (point.timestamp >= from && point.timestamp < to) {
+                    result.push_back(point);
+                }
+            }
+        }
+        auto buffer = m_buffers.find(series);
+        if (buffer != m_buffers.end()) {
+            for (const TimeSeriesPoint& point : buffer->second) {
+                if (point.timestamp >= from && point.timestamp < to) {
+                    result.push_back(point);
+                }
+            }
+        }
+        // 块按起始时间排列，块内和缓冲区中通常已有序；乱序写入时才需要排序
+        auto earlier = [](const TimeSeriesPoint& a, const TimeSeriesPoint& b) { return a.timestamp < b.timestamp; };
+        if (!std::is_sorted(result.begin(), result.end(), earlier)) {
+            std::stable_sort(result.begin(), result.end(), earlier);
+        }
+        return result;
+    }
+
+    WCDB::Optional<Utility::Aggregate::Summary<double>> Summarize(const std::string& series, int64_t from, int64_t to) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<StoredBlock> blocks;
+        if (!LoadBlocks(series, from, to, false, blocks)) {
+            return WCDB::NullOpt;
+        }
+        Utility::Aggregate::Summary<double> summary;
+        std::vector<TimeSeriesPoint> decoded;
+        std::vector<double> values;
+        auto collect = [&](const std::vector<TimeSeriesPoint>& points) {
+            values.clear();
+            for (const TimeSeriesPoint& point : points) {
+                if (point.timestamp >= from && point.timestamp < to) {
+                    values.push_back(point.value);
+                }
+            }
+            Merge(summary, Utility::Aggregate::Summarize(values.data(), values.size()));
+        };
+        for (StoredBlock& block : blocks) {
+            if (block.begin >= from && block.end < to) {
+                Merge(summary, block.summary);
+                continue;
+            }
+            // 部分重叠的块才读取数据并解压
+            if (!LoadData(block) || !Decode(block, decoded)) {
+                return WCDB::NullOpt;
+            }
+            collect(decoded);
+        }
+        auto buffer = m_buffers.find(series);
+        if (buffer != m_buffers.end()) {
+            collect(buffer->second);
+        }
+        return summary;
+    }
+
+    WCDB::Optional<size_t> DropBefore(int64_t cutoff) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        WCDB::Handle handle = m_database.getHandle();
+        bool succeed = handle.execute(WCDB::StatementDelete().deleteFrom(m_options.table).where(EndColumn() < cutoff));
+        size_t dropped = succeed ? (size_t) handle.getChanges() : 0;
+        handle.invalidate();
+        if (!succeed) {
+            return WCDB::NullOpt;
+        }
+        return dropped;
+    }
+
+    WCDB::Optional<std::vector<std::string>> ListSeries() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto names = m_database.getOneColumnFromStatement(
+            WCDB::StatementSelect().select(SeriesColumn()).distinct().from(m_options.table));
+        if (!names.hasValue()) {
+            return WCDB::NullOpt;
+        }
+        std::set<std::string> series;
+        for (const WCDB::Value& name : names.value()) {
+            series.insert(name.textValue());
+        }
+        for (const auto& entry : m_buffers) {
+            if (!entry.second.empty()) {
+                series.insert(entry.first);
+            }
+        }
+        return std::vector<std::string>(series.begin(), series.end());
+    }
+
+    TimeSeriesStats GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TimeSeriesStats stats = m_stats;
+        stats.bufferedPoints = 0;
+        for (const auto& entry : m_buffers) {
+            stats.bufferedPoints += entry.second.size();
+        }
+        return stats;
+    }
+
+private:
+    // 调用方须持有 m_mutex。写入成功后清空缓冲区，失败时保留以便下次重试
+    bool Seal(const std::string& series, std::vector<TimeSeriesPoint>& points) {
+        std::vector<double> values(points.size());
+        int64_t begin = points.front().timestamp;
+        int64_t end = points.front().timestamp;
+        for (size_t i = 0; i < points.size(); i++) {
+            values[i] = points[i].value;
+            begin = std::min(begin, points[i].timestamp);
+            end = std::max(end, points[i].timestamp);
+        }
+        Utility::Aggregate::Summary<double> summary = Utility::Aggregate::Summarize(values.data(), values.size());
+
+        std::vector<char> encoded = EncodeBlock(points);
+        std::vector<char> compressed
+            = Utility::Compression::Compress(encoded, Utility::Compression::Algorithm::Zstd, m_options.compressionLevel);
+        if (compressed.empty()) {
+            ++m_stats.failedBlocks;
+            return false;
+        }
+
+        WCDB::StatementInsert insert;
+        insert.insertIntoTable(m_options.table)
+            .columns({ SeriesColumn(), BeginColumn(), EndColumn(), CountColumn(), MinColumn(), MaxColumn(),
+                       SumColumn(), RawSizeColumn(), EncodingColumn(), DataColumn() })
+            .values(WCDB::BindParameter::bindParameters(10));
+        WCDB::Handle handle = m_database.getHandle();
+        bool succeed = handle.prepare(insert);
+        if (succeed) {
+            handle.bindText(WCDB::UnsafeStringView(series.data(), series.size()), 1);
+            handle.bindInteger(begin, 2);
+            handle.bindInteger(end, 3);
+            handle.bindInteger((int64_t) summary.count, 4);
+            handle.bindDouble(summary.min, 5);
+            handle.bindDouble(summary.max, 6);
+            handle.bindDouble(summary.sum, 7);
+            handle.bindInteger((int64_t) encoded.size(), 8);
+            handle.bindInteger(kEncodingDeltaXor, 9);
+            handle.bindBLOB(WCDB::UnsafeData::immutable((const unsigned char*) compressed.data(), compressed.size()), 10);
+            succeed = handle.step();
+            handle.finalize();
+        }
+        handle.invalidate();
+        if (!succeed) {
+            ++m_stats.failedBlocks;
+            return false;
+        }
+
+        ++m_stats.sealedBlocks;
+        m_stats.sealedPoints += points.size();
+        m_stats.encodedBytes += encoded.size();
+        m_stats.storedBytes += compressed.size();
+        points.clear();
+        return true;
+    }
+
+    // 读取与 [from, to) 重叠的块的元数据，withData 为 false 时不读取 data 列
+    bool LoadBlocks(const std::string& series, int64_t from, int64_t to, bool withData, std::vector<StoredBlock>& blocks) {
+        WCDB::ResultColumns columns = { WCDB::Column::rowid(), BeginColumn(), EndColumn(), CountColumn(), MinColumn(), MaxColumn(),
+                                        SumColumn(), RawSizeColumn(), EncodingColumn() };
+        if (withData) {
+            columns.push_back(DataColumn());
+        }
+        WCDB::StatementSelect select;
+        select.select(columns).from(m_options.table)
+            .where(SeriesColumn() == WCDB::BindParameter(1) && EndColumn() >= WCDB::BindParameter(2)
+                   && BeginColumn() < WCDB::BindParameter(3))
+            .order(BeginColumn().asOrder(WCDB::Order::ASC));
+
+        WCDB::Handle handle = m_database.getHandle();
+        bool succeed = handle.prepare(select);
+        if (succeed) {
+            handle.bindText(WCDB::UnsafeStringView(series.data(), series.size()), 1);
+            handle.bindInteger(from, 2);
+            handle.bindInteger(to, 3);
+            while ((succeed = handle.step()) && !handle.done()) {
+                StoredBlock block;
+                block.rowid = handle.getInteger(0);
+                block.begin = handle.getInteger(1);
+                block.end = handle.getInteger(2);
+                block.summary.count = (size_t) handle.getInteger(3);
+                block.summary.min = handle.getDouble(4);
+                block.summary.max = handle.getDouble(5);
+                block.summary.sum = handle.getDouble(6);
+                block.rawSize = handle.getInteger(7);
+                block.encoding = handle.getInteger(8);
+                if (withData) {
+                    const WCDB::UnsafeData data = handle.getBLOB(9);
+                    block.data.assign((const char*) data.buffer(), (const char*) data.buffer() + data.size());
+                }
+                blocks.push_back(std::move(block));
+            }
+            handle.finalize();
+        }
+        handle.invalidate();
+        return succeed;
+    }
+
+    // 按 rowid 读取块的 data 列
+    bool LoadData(StoredBlock& block) {
+        WCDB::StatementSelect select;
+        select.select(DataColumn()).from(m_options.table).where(WCDB::Column::rowid() == WCDB::BindParameter(1));
+        WCDB::Handle handle = m_database.getHandle();
+        bool succeed = handle.prepare(select);
+        if (succeed) {
+            handle.bindInteger(block.rowid, 1);
+            succeed = handle.step() && !handle.done();
+            if (succeed) {
+                const WCDB::UnsafeData data = handle.getBLOB(0);
+                block.data.assign((const char*) data.buffer(), (const char*) data.buffer() + data.size());
+            }
+            handle.finalize();
+        }
+        handle.invalidate();
+        return succeed;
+    }
+
+    static bool Decode(const StoredBlock& block, std::vector<TimeSeriesPoint>& points) {
+        if (block.encoding != kEncodingDeltaXor || block.rawSize <= 0) {
+            return false;
+        }
+        std::vector<char> encoded = Utility::Compression::Decompress(block.data, (size_t) block.rawSize);
+        return !encoded.empty() && DecodeBlock(encoded, points);
+    }
+
+    WCDB::Database& m_database;
+    TimeSeriesOptions m_options;
+    bool m_valid = false;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::vector<TimeSeriesPoint>> m_buffers;
+    TimeSeriesStats m_stats;
+};
+
+TimeSeriesStore::TimeSeriesStore(WCDB::Database& database, const TimeSeriesOptions& options)
+    : m_impl(new Impl(database, options)) {
+}
+
+TimeSeriesStore::~TimeSeriesStore() = default;
+
+bool TimeSeriesStore::IsValid() const {
+    return m_impl->IsValid();
+}
+
+bool TimeSeriesStore::Append(const std::string& series, int64_t timestamp, double value) {
+    TimeSeriesPoint point;
+    point.timestamp = timestamp;
+    point.value = value;
+    return m_impl->Append(series, &point, 1);
+}
+
+bool TimeSeriesStore::AppendBatch(const std::string& series, const std::vector<TimeSeriesPoint>& points) {
+    return m_impl->Append(series, points.data(), points.size());
+}
+
+bool TimeSeriesStore::Flush() {
+    return m_impl->Flush();
+}
+
+WCDB::Optional<std::vector<TimeSeriesPoint>> TimeSeriesStore::Query(const std::string& series, int64_t from, int64_t to) {
+    return m_impl->Query(series, from, to);
+}
+
+WCDB::Optional<Utility::Aggregate::Summary<double>> TimeSeriesStore::Summarize(const std::string& series, int64_t from, int64_t to) {
+    return m_impl->Summarize(series, from, to);
+}
+
+WCDB::Optional<size_t> TimeSeriesStore::DropBefore(int64_t cutoff) {
+    return m_impl->DropBefore(cutoff);
+}
+
+WCDB::Optional<std::vector<std::string>> TimeSeriesStore::ListSeries() {
+    return m_impl->ListSeries();
+}
+
+TimeSeriesStats TimeSeriesStore::GetStats() const {
+    return m_impl->GetStats();
+}
+
+} // namespace Storage
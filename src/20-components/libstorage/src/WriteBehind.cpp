@@ -0,0 +1,248 @@
+#include "Storage/WriteBehind.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Storage {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PendingOperation {
+    uint64_t seq = 0;
+    WriteBehindQueue::Operation operation;
+    WriteBehindQueue::DurableCallback onDurable;
+};
+
+} // namespace
+
+class WriteBehindQueue::Impl {
+public:
+    Impl(WCDB::Database& database, const WriteBehindOptions& options)
+        : m_database(database), m_options(options) {
+        if (m_options.capacity == 0) {
+            m_options.capacity = 1;
+        }
+        if (m_options.maxBatch == 0) {
+            m_options.maxBatch = 1;
+        }
+        m_thread = std::thread([this]() { WriterLoop(); });
+    }
+
+    ~Impl() { Stop(); }
+
+    bool Submit(Operation operation, DurableCallback onDurable) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stopping && m_queue.size() >= m_options.capacity) {
+            if (m_options.overflow == OverflowPolicy::Reject) {
+                ++m_stats.rejected;
+                return false;
+            }
+            auto hasRoom = [this]() { return m_stopping || m_queue.size() < m_options.capacity; };
+            if (m_options.submitTimeoutMillis == 0) {
+                m_notFull.wait(lock, hasRoom);
+            } else if (!m_notFull.wait_for(lock, std::chrono::milliseconds(m_options.submitTimeoutMillis), hasRoom)) {
+                ++m_stats.rejected;
+                return false;
+            }
+        }
+        if (m_stopping) {
+            return false;
+        }
+
+        bool wasEmpty = m_queue.empty();
+        PendingOperation pending;
+        pending.seq = ++m_submittedSeq;
+        pending.operation = std::move(operation);
+        pending.onDurable = std::move(onDurable);
+        m_queue.push_back(std::move(pending));
+        if (wasEmpty) {
+            m_windowStart = Clock::now();
+        }
+
+        ++m_stats.submitted;
+        m_stats.maxPending = std::max(m_stats.maxPending, m_queue.size());
+        // 只在开启新窗口或凑满一批时唤醒写线程，其余入队不产生额外唤醒
+        if (wasEmpty || m_queue.size() >= m_options.maxBatch) {
+            m_notEmpty.notify_one();
+        }
+        return true;
+    }
+
+    bool Flush() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        uint64_t target = m_submittedSeq;
+        uint64_t failedBefore = m_stats.failed;
+        ++m_flushWaiters;
+        m_notEmpty.notify_one();
+        m_done.wait(lock, [&]() { return m_completedSeq >= target || m_exited; });
+        --m_flushWaiters;
+        return m_completedSeq >= target && m_stats.failed == failedBefore;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    WriteBehindStats GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        WriteBehindStats stats = m_stats;
+        stats.pending = m_queue.size();
+        return stats;
+    }
+
+private:
+    void WriterLoop() {
+        // Handle 只在写线程中使用
+        WCDB::Handle handle = m_database.getHandle();
+        std::vector<PendingOperation> batch;
+        std::vector<char> results;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_notEmpty.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty()) {
+                    break;
+                }
+                // 刷新窗口：等到窗口结束、凑满一批、有人 Flush 或正在停止
+                m_notEmpty.wait_until(lock, m_windowStart + std::chrono::milliseconds(m_options.flushIntervalMillis), [this]() {
+                    return m_stopping || m_flushWaiters > 0 || m_queue.size() >= m_options.maxBatch;
+                });
+
+                size_t count = std::min(m_queue.size(), m_options.maxBatch);
+                batch.reserve(count);
+                for (size_t i = 0; i < count; i++) {
+                    batch.push_back(std::move(m_queue.front()));
+                    m_queue.pop_front();
+                }
+                // 剩余操作已经等待过一个窗口，保留 m_windowStart 使其在下一轮立即提交
+            }
+            m_notFull.notify_all();
+
+            uint64_t transactions = 0;
+            uint64_t retries = 0;
+            Execute(handle, batch, results, transactions, retries);
+
+            uint64_t committed = 0;
+            for (size_t i = 0; i < batch.size(); i++) {
+                if (results[i]) {
+                    ++committed;
+                }
+                if (batch[i].onDurable) {
+                    batch[i].onDurable(results[i] != 0);
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_completedSeq = batch.back().seq;
+                m_stats.committed += committed;
+                m_stats.failed += batch.size() - committed;
+                m_stats.transactions += transactions;
+                m_stats.retries += retries;
+            }
+            m_done.notify_all();
+            batch.clear();
+        }
+
+        handle.invalidate();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exited = true;
+        }
+        m_done.notify_all();
+    }
+
+    // 整批放入一个事务；失败时回滚并逐条单独提交，找出出错的操作
+    static void Execute(WCDB::Handle& handle, std::vector<PendingOperation>& batch, std::vector<char>& results,
+                        uint64_t& transactions, uint64_t& retries) {
+        results.assign(batch.size(), 0);
+        bool succeed = handle.runTransaction([&](WCDB::Handle& inTransaction) {
+            for (PendingOperation& pending : batch) {
+                if (!pending.operation(inTransaction)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        if (succeed) {
+            std::fill(results.begin(), results.end(), 1);
+            ++transactions;
+            return;
+        }
+        if (batch.size() == 1) {
+            return;
+        }
+
+        ++retries;
+        for (size_t i = 0; i < batch.size(); i++) {
+            results[i] = handle.runTransaction([&](WCDB::Handle& inTransaction) {
+                return batch[i].operation(inTransaction);
+            }) ? 1 : 0;
+            if (results[i]) {
+                ++transactions;
+            }
+        }
+    }
+
+    WCDB::Database& m_database;
+    WriteBehindOptions m_options;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::condition_variable m_done;
+    std::deque<PendingOperation> m_queue;
+    Clock::time_point m_windowStart;
+    uint64_t m_submittedSeq = 0;
+    uint64_t m_completedSeq = 0;
+    unsigned m_flushWaiters = 0;
+    bool m_stopping = false;
+    bool m_exited = false;
+    WriteBehindStats m_stats;
+
+    std::thread m_thread;
+};
+
+WriteBehindQueue::WriteBehindQueue(WCDB::Database& database, const WriteBehindOptions& options)
+    : m_impl(new Impl(database, options)) {
+}
+
+WriteBehindQueue::~WriteBehindQueue() = default;
+
+bool WriteBehindQueue::Submit(Operation operation, DurableCallback onDurable) {
+    return m_impl->Submit(std::move(operation), std::move(onDurable));
+}
+
+bool WriteBehindQueue::DeleteObjects(const std::string& table, const WCDB::Expression& where, DurableCallback onDurable) {
+    return Submit([table, where](WCDB::Handle& handle) {
+        return handle.deleteObjects(table, where);
+    }, std::move(onDurable));
+}
+
+bool WriteBehindQueue::Flush() {
+    return m_impl->Flush();
+}
+
+void WriteBehindQueue::Stop() {
+    m_impl->Stop();
+}
+
+WriteBehindStats WriteBehindQueue::GetStats() const {
+    return m_impl->GetStats();
+}
+
+} // namespace Storage
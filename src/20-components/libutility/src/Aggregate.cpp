@@ -0,0 +1,356 @@
+#include "Utility/Aggregate.h"
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define UTILITY_AGGREGATE_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define UTILITY_AGGREGATE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Utility::Aggregate {
+
+namespace {
+
+// 有符号溢出是未定义行为，整数按无符号相加以得到补码回绕的结果
+inline int64_t AddWrapped(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+inline double AddWrapped(double a, double b) {
+    return a + b;
+}
+
+// ---------------------------------------------------------------------------
+// 标量实现，也用于处理向量实现剩余的尾部元素
+// ---------------------------------------------------------------------------
+
+template<typename T>
+void SummarizeScalar(const T* data, size_t count, Summary<T>& summary) {
+    for (size_t i = 0; i < count; i++) {
+        T value = data[i];
+        if (summary.count == 0) {
+            summary.min = value;
+            summary.max = value;
+        } else {
+            summary.min = std::min(summary.min, value);
+            summary.max = std::max(summary.max, value);
+        }
+        summary.sum = AddWrapped(summary.sum, value);
+        ++summary.count;
+    }
+}
+
+template<typename T>
+size_t CountInRangeScalar(const T* data, size_t count, T low, T high) {
+    size_t matched = 0;
+    for (size_t i = 0; i < count; i++) {
+        matched += (data[i] >= low && data[i] <= high) ? 1 : 0;
+    }
+    return matched;
+}
+
+// 合并两个部分结果
+template<typename T>
+void Merge(Summary<T>& summary, const Summary<T>& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (summary.count == 0) {
+        summary = other;
+        return;
+    }
+    summary.sum = AddWrapped(summary.sum, other.sum);
+    summary.min = std::min(summary.min, other.min);
+    summary.max = std::max(summary.max, other.max);
+    summary.count += other.count;
+}
+
+#if UTILITY_AGGREGATE_AVX2
+
+// ---------------------------------------------------------------------------
+// AVX2：每个寄存器 4 个元素，运行时检测 CPU 支持后才会调用
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2"))) Summary<int64_t> SummarizeAvx2(const int64_t* data, size_t count) {
+    Summary<int64_t> summary;
+    // 每次处理 8 个元素，两组累加器交替使用以缩短比较和混合指令的依赖链
+    size_t vectorCount = count & ~static_cast<size_t>(7);
+    if (vectorCount > 0) {
+        __m256i sum = _mm256_setzero_si256();
+        __m256i sum2 = _mm256_setzero_si256();
+        __m256i min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        __m256i max = min;
+        __m256i min2 = min;
+        __m256i max2 = min;
+        for (size_t i = 0; i < vectorCount; i += 8) {
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i value2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 4));
+            sum = _mm256_add_epi64(sum, value);
+            sum2 = _mm256_add_epi64(sum2, value2);
+            min = _mm256_blendv_epi8(min, value, _mm256_cmpgt_epi64(min, value));
+            min2 = _mm256_blendv_epi8(min2, value2, _mm256_cmpgt_epi64(min2, value2));
+            max = _mm256_blendv_epi8(max, value, _mm256_cmpgt_epi64(value, max));
+            max2 = _mm256_blendv_epi8(max2, value2, _mm256_cmpgt_epi64(value2, max2));
+        }
+        sum = _mm256_add_epi64(sum, sum2);
+        min = _mm256_blendv_epi8(min, min2, _mm256_cmpgt_epi64(min, min2));
+        max = _mm256_blendv_epi8(max, max2, _mm256_cmpgt_epi64(max2, max));
+        alignas(32) int64_t sums[4];
+        alignas(32) int64_t mins[4];
+        alignas(32) int64_t maxs[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), sum);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(mins), min);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), max);
+        summary.sum = AddWrapped(AddWrapped(sums[0], sums[1]), AddWrapped(sums[2], sums[3]));
+        summary.min = std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3]));
+        summary.max = std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3]));
+        summary.count = vectorCount;
+    }
+    Summary<int64_t> tail;
+    SummarizeScalar(data + vectorCount, count - vectorCount, tail);
+    Merge(summary, tail);
+    return summary;
+}
+
+__attribute__((target("avx2"))) Summary<double> SummarizeAvx2(const double* data, size_t count) {
+    Summary<double> summary;
+    size_t vectorCount = count & ~static_cast<size_t>(7);
+    if (vectorCount > 0) {
+        __m256d sum = _mm256_setzero_pd();
+        __m256d sum2 = _mm256_setzero_pd();
+        __m256d min = _mm256_loadu_pd(data);
+        __m256d max = min;
+        __m256d min2 = min;
+        __m256d max2 = min;
+        for (size_t i = 0; i < vectorCount; i += 8) {
+            __m256d value = _mm256_loadu_pd(data + i);
+            __m256d value2 = _mm256_loadu_pd(data + i + 4);
+            sum = _mm256_add_pd(sum, value);
+            sum2 = _mm256_add_pd(sum2, value2);
+            min = _mm256_min_pd(min, value);
+            min2 = _mm256_min_pd(min2, value2);
+            max = _mm256_max_pd(max, value);
+            max2 = _mm256_max_pd(max2, value2);
+        }
+        sum = _mm256_add_pd(sum, sum2);
+        min = _mm256_min_pd(min, min2);
+        max = _mm256_max_pd(max, max2);
+        alignas(32) double sums[4];
+        alignas(32) double mins[4];
+        alignas(32) double maxs[4];
+        _mm256_store_pd(sums, sum);
+        _mm256_store_pd(mins, min);
+        _mm256_store_pd(maxs, max);
+        summary.sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        summary.min = std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3]));
+        summary.max = std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3]));
+        summary.count = vectorCount;
+    }
+    Summary<double> tail;
+    SummarizeScalar(data + vectorCount, count - vectorCount, tail);
+    Merge(summary, tail);
+    return summary;
+}
+
+__attribute__((target("avx2,popcnt"))) size_t CountInRangeAvx2(const int64_t* data, size_t count,
+                                                               int64_t low, int64_t high) {
+    size_t vectorCount = count & ~static_cast<size_t>(3);
+    __m256i lows = _mm256_set1_epi64x(low);
+    __m256i highs = _mm256_set1_epi64x(high);
+    size_t outside = 0;
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i mask = _mm256_or_si256(_mm256_cmpgt_epi64(lows, value), _mm256_cmpgt_epi64(value, highs));
+        outside += static_cast<size_t>(_mm_popcnt_u32(static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(mask)))));
+    }
+    return vectorCount - outside + CountInRangeScalar(data + vectorCount, count - vectorCount, low, high);
+}
+
+__attribute__((target("avx2,popcnt"))) size_t CountInRangeAvx2(const double* data, size_t count,
+                                                               double low, double high) {
+    size_t vectorCount = count & ~static_cast<size_t>(3);
+    __m256d lows = _mm256_set1_pd(low);
+    __m256d highs = _mm256_set1_pd(high);
+    size_t matched = 0;
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        __m256d value = _mm256_loadu_pd(data + i);
+        __m256d mask = _mm256_and_pd(_mm256_cmp_pd(value, lows, _CMP_GE_OQ), _mm256_cmp_pd(value, highs, _CMP_LE_OQ));
+        matched += static_cast<size_t>(_mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_pd(mask))));
+    }
+    return matched + CountInRangeScalar(data + vectorCount, count - vectorCount, low, high);
+}
+
+bool UseAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    return supported;
+}
+
+#endif // UTILITY_AGGREGATE_AVX2
+
+#if UTILITY_AGGREGATE_NEON
+
+// ---------------------------------------------------------------------------
+// NEON：每次处理 2 个元素，aarch64 上总是可用
+// ---------------------------------------------------------------------------
+
+Summary<int64_t> SummarizeNeon(const int64_t* data, size_t count) {
+    Summary<int64_t> summary;
+    size_t vectorCount = count & ~static_cast<size_t>(1);
+    if (vectorCount > 0) {
+        int64x2_t sum = vdupq_n_s64(0);
+        int64x2_t min = vld1q_s64(data);
+        int64x2_t max = min;
+        for (size_t i = 0; i < vectorCount; i += 2) {
+            int64x2_t value = vld1q_s64(data + i);
+            sum = vaddq_s64(sum, value);
+            min = vbslq_s64(vcgtq_s64(min, value), value, min);
+            max = vbslq_s64(vcgtq_s64(value, max), value, max);
+        }
+        summary.sum = AddWrapped(vgetq_lane_s64(sum, 0), vgetq_lane_s64(sum, 1));
+        summary.min = std::min(vgetq_lane_s64(min, 0), vgetq_lane_s64(min, 1));
+        summary.max = std::max(vgetq_lane_s64(max, 0), vgetq_lane_s64(max, 1));
+        summary.count = vectorCount;
+    }
+    Summary<int64_t> tail;
+    SummarizeScalar(data + vectorCount, count - vectorCount, tail);
+    Merge(summary, tail);
+    return summary;
+}
+
+Summary<double> SummarizeNeon(const double* data, size_t count) {
+    Summary<double> summary;
+    size_t vectorCount = count & ~static_cast<size_t>(1);
+    if (vectorCount > 0) {
+        float64x2_t sum = vdupq_n_f64(0);
+        float64x2_t min = vld1q_f64(data);
+        float64x2_t max = min;
+        for (size_t i = 0; i < vectorCount; i += 2) {
+            float64x2_t value = vld1q_f64(data + i);
+            sum = vaddq_f64(sum, value);
+            min = vminq_f64(min, value);
+            max = vmaxq_f64(max, value);
+        }
+        summary.sum = vaddvq_f64(sum);
+        summary.min = vminvq_f64(min);
+        summary.max = vmaxvq_f64(max);
+        summary.count = vectorCount;
+    }
+    Summary<double> tail;
+    SummarizeScalar(data + vectorCount, count - vectorCount, tail);
+    Merge(summary, tail);
+    return summary;
+}
+
+size_t CountInRangeNeon(const int64_t* data, size_t count, int64_t low, int64_t high) {
+    size_t vectorCount = count & ~static_cast<size_t>(1);
+    int64x2_t lows = vdupq_n_s64(low);
+    int64x2_t highs = vdupq_n_s64(high);
+    // 命中的通道为全 1（即 -1），逐次累加后取负得到个数
+    int64x2_t matched = vdupq_n_s64(0);
+    for (size_t i = 0; i < vectorCount; i += 2) {
+        int64x2_t value = vld1q_s64(data + i);
+        uint64x2_t mask = vandq_u64(vcgeq_s64(value, lows), vcleq_s64(value, highs));
+        matched = vaddq_s64(matched, vreinterpretq_s64_u64(mask));
+    }
+    size_t vectorMatched = static_cast<size_t>(-(vgetq_lane_s64(matched, 0) + vgetq_lane_s64(matched, 1)));
+    return vectorMatched + CountInRangeScalar(data + vectorCount, count - vectorCount, low, high);
+}
+
+size_t CountInRangeNeon(const double* data, size_t count, double low, double high) {
+    size_t vectorCount = count & ~static_cast<size_t>(1);
+    float64x2_t lows = vdupq_n_f64(low);
+    float64x2_t highs = vdupq_n_f64(high);
+    int64x2_t matched = vdupq_n_s64(0);
+    for (size_t i = 0; i < vectorCount; i += 2) {
+        float64x2_t value = vld1q_f64(data + i);
+        uint64x2_t mask = vandq_u64(vcgeq_f64(value, lows), vcleq_f64(value, highs));
+        matched = vaddq_s64(matched, vreinterpretq_s64_u64(mask));
+    }
+    size_t vectorMatched = static_cast<size_t>(-(vgetq_lane_s64(matched, 0) + vgetq_lane_s64(matched, 1)));
+    return vectorMatched + CountInRangeScalar(data + vectorCount, count - vectorCount, low, high);
+}
+
+#endif // UTILITY_AGGREGATE_NEON
+
+template<typename T>
+Summary<T> SummarizeAny(const T* data, size_t count) {
+#if UTILITY_AGGREGATE_AVX2
+    if (UseAvx2()) {
+        return SummarizeAvx2(data, count);
+    }
+#elif UTILITY_AGGREGATE_NEON
+    return SummarizeNeon(data, count);
+#endif
+    Summary<T> summary;
+    SummarizeScalar(data, count, summary);
+    return summary;
+}
+
+template<typename T>
+size_t CountInRangeAny(const T* data, size_t count, T low, T high) {
+#if UTILITY_AGGREGATE_AVX2
+    if (UseAvx2()) {
+        return CountInRangeAvx2(data, count, low, high);
+    }
+#elif UTILITY_AGGREGATE_NEON
+    return CountInRangeNeon(data, count, low, high);
+#endif
+    return CountInRangeScalar(data, count, low, high);
+}
+
+} // namespace
+
+Summary<int64_t> Summarize(const int64_t* data, size_t count) {
+    return SummarizeAny(data, count);
+}
+
+Summary<double> Summarize(const double* data, size_t count) {
+    return SummarizeAny(data, count);
+}
+
+int64_t Sum(const int64_t* data, size_t count) {
+    return Summarize(data, count).sum;
+}
+
+double Sum(const double* data, size_t count) {
+    return Summarize(data, count).sum;
+}
+
+int64_t Min(const int64_t* data, size_t count) {
+    return Summarize(data, count).min;
+}
+
+double Min(const double* data, size_t count) {
+    return Summarize(data, count).min;
+}
+
+int64_t Max(const int64_t* data, size_t count) {
+    return Summarize(data, count).max;
+}
+
+double Max(const double* data, size_t count) {
+    return Summarize(data, count).max;
+}
+
+size_t CountInRange(const int64_t* data, size_t count, int64_t low, int64_t high) {
+    return CountInRangeAny(data, count, low, high);
+}
+
+size_t CountInRange(const double* data, size_t count, double low, double high) {
+    return CountInRangeAny(data, count, low, high);
+}
+
+const char* Backend() {
+#if UTILITY_AGGREGATE_AVX2
+    return UseAvx2() ? "avx2" : "scalar";
+#elif UTILITY_AGGREGATE_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace Utility::Aggregate
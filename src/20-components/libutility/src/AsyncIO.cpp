@@ -0,0 +1,662 @@
+#include "Utility/AsyncIO.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define UTILITY_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace Utility::AsyncIO {
+
+// 后端公共部分：在途计数和已完成队列
+class Engine::Impl {
+public:
+    virtual ~Impl() = default;
+
+    virtual Backend GetBackend() const = 0;
+    virtual bool RegisterBuffers(const std::vector<Buffer>& buffers) = 0;
+    virtual void UnregisterBuffers() = 0;
+    // 返回实际提交的请求数，未提交的请求不会执行完成回调
+    virtual size_t Submit(std::vector<Request>& requests) = 0;
+
+    size_t Reap(size_t minComplete) {
+        size_t reaped = 0;
+        for (;;) {
+            CollectCompletions();
+
+            std::deque<Finished> ready;
+            {
+                std::lock_guard<std::mutex> lock(m_readyMutex);
+                ready.swap(m_ready);
+            }
+            for (auto& finished : ready) {
+                if (finished.callback) {
+                    finished.callback(finished.result);
+                }
+            }
+            reaped += ready.size();
+
+            if (reaped >= minComplete) {
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_readyMutex);
+                if (m_inFlight == 0 && m_ready.empty()) {
+                    break;
+                }
+                if (!m_ready.empty()) {
+                    continue;
+                }
+            }
+            WaitForCompletion();
+        }
+        return reaped;
+    }
+
+    size_t InFlight() const {
+        return m_inFlight.load(std::memory_order_acquire);
+    }
+
+protected:
+    struct Finished {
+        Completion callback;
+        int64_t result;
+    };
+
+    // 非阻塞地把内核中已完成的请求转移到就绪队列
+    virtual void CollectCompletions() = 0;
+
+    // 阻塞直到至少有一个请求完成
+    virtual void WaitForCompletion() = 0;
+
+    void Finish(Completion callback, int64_t result) {
+        std::lock_guard<std::mutex> lock(m_readyMutex);
+        m_ready.push_back(Finished{std::move(callback), result});
+        m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+        m_readyCond.notify_all();
+    }
+
+    // 将请求按 linkNext 切分为链，返回每条链的 [begin, end)
+    static std::vector<std::pair<size_t, size_t>> SplitChains(std::vector<Request>& requests) {
+        std::vector<std::pair<size_t, size_t>> chains;
+        size_t begin = 0;
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (!requests[i].linkNext || i + 1 == requests.size()) {
+                requests[i].linkNext = false;
+                chains.emplace_back(begin, i + 1);
+                begin = i + 1;
+            }
+        }
+        return chains;
+    }
+
+    std::atomic<size_t> m_inFlight{0};
+    std::mutex m_readyMutex;
+    std::condition_variable m_readyCond;
+    std::deque<Finished> m_ready;
+};
+
+namespace {
+
+// 执行一次完整的读写，返回字节数或 -errno
+int64_t ExecuteSync(const Request& request) {
+    char* buffer = static_cast<char*>(request.buffer);
+    size_t done = 0;
+    switch (request.operation) {
+        case Operation::Read:
+            while (done < request.length) {
+                ssize_t n = pread(request.fd, buffer + done, request.length - done,
+                                  static_cast<off_t>(request.offset + done));
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n < 0) {
+                    return -errno;
+                }
+                if (n == 0) {
+                    break;
+                }
+                done += static_cast<size_t>(n);
+            }
+            return static_cast<int64_t>(done);
+        case Operation::Write:
+            while (done < request.length) {
+                ssize_t n = pwrite(request.fd, buffer + done, request.length - done,
+                                   static_cast<off_t>(request.offset + done));
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n < 0) {
+                    return -errno;
+                }
+                done += static_cast<size_t>(n);
+            }
+            return static_cast<int64_t>(done);
+        case Operation::Fsync:
+            return fsync(request.fd) == 0 ? 0 : -errno;
+        case Operation::Fdatasync:
+            return fdatasync(request.fd) == 0 ? 0 : -errno;
+        default:
+            return -EINVAL;
+    }
+}
+
+// 链上的请求是否完整成功，与 io_uring 断链条件一致
+bool CompletedFully(const Request& request, int64_t result) {
+    if (result < 0) {
+        return false;
+    }
+    if (request.operation == Operation::Read || request.operation == Operation::Write) {
+        return static_cast<size_t>(result) == request.length;
+    }
+    return true;
+}
+
+// 线程池后端：每条请求链由一个工作线程按顺序执行
+class ThreadPoolImpl : public Engine::Impl {
+public:
+    explicit ThreadPoolImpl(unsigned workerThreads) {
+        if (workerThreads == 0) {
+            workerThreads = 1;
+        }
+        for (unsigned i = 0; i < workerThreads; i++) {
+            m_workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPoolImpl() override {
+        {
+            std::lock_guard<std::mutex> lock(m_jobMutex);
+            m_stopping = true;
+        }
+        m_jobCond.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    Backend GetBackend() const override {
+        return Backend::ThreadPool;
+    }
+
+    bool RegisterBuffers(const std::vector<Buffer>& buffers) override {
+        m_registeredCount = buffers.size();
+        return true;
+    }
+
+    void UnregisterBuffers() override {
+        m_registeredCount = 0;
+    }
+
+    size_t Submit(std::vector<Request>& requests) override {
+        for (const auto& request : requests) {
+            if (request.bufferIndex >= 0 && static_cast<size_t>(request.bufferIndex) >= m_registeredCount) {
+                return 0;
+            }
+        }
+
+        auto chains = SplitChains(requests);
+        {
+            std::lock_guard<std::mutex> lock(m_jobMutex);
+            for (const auto& chain : chains) {
+                m_jobs.emplace_back(std::make_move_iterator(requests.begin() + chain.first),
+                                    std::make_move_iterator(requests.begin() + chain.second));
+            }
+            m_inFlight.fetch_add(requests.size(), std::memory_order_acq_rel);
+        }
+        m_jobCond.notify_all();
+        return requests.size();
+    }
+
+protected:
+    void CollectCompletions() override {
+        // 工作线程直接写入就绪队列
+    }
+
+    void WaitForCompletion() override {
+        std::unique_lock<std::mutex> lock(m_readyMutex);
+        m_readyCond.wait(lock, [this]() {
+            return !m_ready.empty() || m_inFlight.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+private:
+    void WorkerLoop() {
+        for (;;) {
+            std::vector<Request> chain;
+            {
+                std::unique_lock<std::mutex> lock(m_jobMutex);
+                m_jobCond.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+                if (m_jobs.empty()) {
+                    return;
+                }
+                chain = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            bool broken = false;
+            for (auto& request : chain) {
+                int64_t result = broken ? -ECANCELED : ExecuteSync(request);
+                if (!CompletedFully(request, result)) {
+                    broken = true;
+                }
+                Finish(std::move(request.onComplete), result);
+            }
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobCond;
+    std::deque<std::vector<Request>> m_jobs;
+    bool m_stopping = false;
+    size_t m_registeredCount = 0;
+};
+
+#ifdef UTILITY_HAS_IO_URING
+
+int IoUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// io_uring 后端：直接使用系统调用，不依赖 liburing
+class IoUringImpl : public Engine::Impl {
+public:
+    ~IoUringImpl() override {
+        if (m_sqes != nullptr) {
+            munmap(m_sqes, m_sqesSize);
+        }
+        if (m_cqRing != nullptr && m_cqRing != m_sqRing) {
+            munmap(m_cqRing, m_cqRingSize);
+        }
+        if (m_sqRing != nullptr) {
+            munmap(m_sqRing, m_sqRingSize);
+        }
+        if (m_ringFd >= 0) {
+            close(m_ringFd);
+        }
+    }
+
+    bool Init(unsigned queueDepth) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        m_ringFd = IoUringSetup(queueDepth == 0 ? 1 : queueDepth, &params);
+        if (m_ringFd < 0) {
+            return false;
+        }
+
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        }
+
+        m_sqRing = MapRing(m_sqRingSize, IORING_OFF_SQ_RING);
+        if (m_sqRing == nullptr) {
+            return false;
+        }
+        m_cqRing = singleMmap ? m_sqRing : MapRing(m_cqRingSize, IORING_OFF_CQ_RING);
+        if (m_cqRing == nullptr) {
+            return false;
+        }
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = static_cast<io_uring_sqe*>(MapRing(m_sqesSize, IORING_OFF_SQES));
+        if (m_sqes == nullptr) {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(m_sqRing);
+        m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        m_sqEntries = params.sq_entries;
+
+        char* cq = static_cast<char*>(m_cqRing);
+        m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        m_cqEntries = params.cq_entries;
+
+        return ProbeOperations();
+    }
+
+    Backend GetBackend() const override {
+        return Backend::IoUring;
+    }
+
+    bool RegisterBuffers(const std::vector<Buffer>& buffers) override {
+        std::lock_guard<std::mutex> lock(m_submitMutex);
+        UnregisterLocked();
+        if (buffers.empty()) {
+            return true;
+        }
+
+        std::vector<iovec> iovecs;
+        iovecs.reserve(buffers.size());
+        for (const auto& buffer : buffers) {
+            iovecs.push_back(iovec{buffer.data, buffer.size});
+        }
+        if (IoUringRegister(m_ringFd, IORING_REGISTER_BUFFERS, iovecs.data(),
+                            static_cast<unsigned>(iovecs.size())) != 0) {
+            return false;
+        }
+        m_registeredCount = buffers.size();
+        return true;
+    }
+
+    void UnregisterBuffers() override {
+        std::lock_guard<std::mutex> lock(m_submitMutex);
+        UnregisterLocked();
+    }
+
+    size_t Submit(std::vector<Request>& requests) override {
+        std::lock_guard<std::mutex> lock(m_submitMutex);
+
+        for (const auto& request : requests) {
+            if (request.bufferIndex >= 0 && static_cast<size_t>(request.bufferIndex) >= m_registeredCount) {
+                return 0;
+            }
+        }
+        auto chains = SplitChains(requests);
+        for (const auto& chain : chains) {
+            if (chain.second - chain.first > m_sqEntries) {
+                return 0;
+            }
+        }
+
+        size_t pushed = 0;
+        for (const auto& chain : chains) {
+            size_t count = chain.second - chain.first;
+            // 整条链必须在同一次 io_uring_enter 中提交，否则链接关系会被截断
+            while (SqSpace() < count || InFlight() + count > m_cqEntries) {
+                if (!Flush()) {
+                    return pushed - Retract();
+                }
+                if (SqSpace() >= count && InFlight() + count <= m_cqEntries) {
+                    break;
+                }
+                WaitForCompletion();
+                CollectCompletions();
+            }
+
+            for (size_t i = chain.first; i < chain.second; i++) {
+                PushSqe(requests[i]);
+            }
+            m_inFlight.fetch_add(count, std::memory_order_acq_rel);
+            pushed += count;
+        }
+        return Flush() ? pushed : pushed - Retract();
+    }
+
+protected:
+    void CollectCompletions() override {
+        std::lock_guard<std::mutex> lock(m_completeMutex);
+        unsigned head = *m_cqHead;
+        unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+            std::unique_ptr<Completion> callback(reinterpret_cast<Completion*>(cqe.user_data));
+            Finish(std::move(*callback), cqe.res);
+            m_kernelOwned.fetch_sub(1, std::memory_order_acq_rel);
+            head++;
+        }
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    // 多个线程可以同时 Reap：检查和等待都在 m_completeMutex 内进行，其他线程无法在两者之间
+    // 取走最后一个完成事件；只在内核确实持有请求时才阻塞，撤回的请求不会让等待方永远挂起
+    void WaitForCompletion() override {
+        std::lock_guard<std::mutex> lock(m_completeMutex);
+        if (*m_cqHead != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE)
+            || m_kernelOwned.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        int ret = IoUringEnter(m_ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR) {
+            // 内核拒绝等待时避免空转
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    void* MapRing(size_t size, off_t offset) {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    // 确认内核支持所有需要的操作码（IORING_OP_READ/WRITE 需要 5.6+）
+    bool ProbeOperations() {
+        const unsigned opCount = 256;
+        std::vector<char> storage(sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+        if (IoUringRegister(m_ringFd, IORING_REGISTER_PROBE, probe, opCount) != 0) {
+            return false;
+        }
+        const unsigned required[] = {
+            IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED, IORING_OP_FSYNC
+        };
+        for (unsigned op : required) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void UnregisterLocked() {
+        if (m_registeredCount > 0) {
+            IoUringRegister(m_ringFd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            m_registeredCount = 0;
+        }
+    }
+
+    size_t SqSpace() const {
+        unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+        return m_sqEntries - (m_sqLocalTail - head);
+    }
+
+    void PushSqe(Request& request) {
+        unsigned index = m_sqLocalTail & m_sqMask;
+        io_uring_sqe& sqe = m_sqes[index];
+        memset(&sqe, 0, sizeof(sqe));
+
+        sqe.fd = request.fd;
+        sqe.off = request.offset;
+        sqe.addr = reinterpret_cast<uint64_t>(request.buffer);
+        sqe.len = static_cast<uint32_t>(request.length);
+        switch (request.operation) {
+            case Operation::Read:
+                sqe.opcode = request.bufferIndex >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+                break;
+            case Operation::Write:
+                sqe.opcode = request.bufferIndex >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                break;
+            case Operation::Fsync:
+                sqe.opcode = IORING_OP_FSYNC;
+                break;
+            case Operation::Fdatasync:
+                sqe.opcode = IORING_OP_FSYNC;
+                sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+                break;
+        }
+        if (request.bufferIndex >= 0) {
+            sqe.buf_index = static_cast<uint16_t>(request.bufferIndex);
+        }
+        if (request.linkNext) {
+            sqe.flags |= IOSQE_IO_LINK;
+        }
+        sqe.user_data = reinterpret_cast<uint64_t>(new Completion(std::move(request.onComplete)));
+
+        m_sqArray[index] = index;
+        m_sqLocalTail++;
+        m_pendingSubmit++;
+    }
+
+    // 发布本地尾指针并提交所有待提交的 SQE
+    bool Flush() {
+        __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+        while (m_pendingSubmit > 0) {
+            int ret = IoUringEnter(m_ringFd, m_pendingSubmit, 0, 0);
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if ((errno == EAGAIN || errno == EBUSY) && m_kernelOwned.load(std::memory_order_acquire) > 0) {
+                    // 完成队列已满，先消费完成事件再重试
+                    WaitForCompletion();
+                    CollectCompletions();
+                    continue;
+                }
+                return false;
+            }
+            m_pendingSubmit -= static_cast<unsigned>(ret);
+            m_kernelOwned.fetch_add(static_cast<size_t>(ret), std::memory_order_acq_rel);
+        }
+        return true;
+    }
+
+    // io_uring_enter 失败后撤回内核尚未取走的 SQE：释放其回调并扣减在途计数，返回撤回的数量。
+    // 未使用 SQPOLL，内核只在 io_uring_enter 中读取 SQ，持有 m_submitMutex 时撤回是安全的。
+    // 被截断的链中已取走的部分照常执行
+    size_t Retract() {
+        unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+        size_t retracted = m_sqLocalTail - head;
+        for (unsigned i = head; i != m_sqLocalTail; i++) {
+            delete reinterpret_cast<Completion*>(m_sqes[i & m_sqMask].user_data);
+        }
+        m_sqLocalTail = head;
+        __atomic_store_n(m_sqTail, head, __ATOMIC_RELEASE);
+        m_pendingSubmit = 0;
+        m_inFlight.fetch_sub(retracted, std::memory_order_acq_rel);
+        return retracted;
+    }
+
+    int m_ringFd = -1;
+    void* m_sqRing = nullptr;
+    void* m_cqRing = nullptr;
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    size_t m_sqesSize = 0;
+
+    unsigned* m_sqHead = nullptr;
+    unsigned* m_sqTail = nullptr;
+    unsigned* m_sqArray = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_sqEntries = 0;
+    unsigned m_sqLocalTail = 0;
+    unsigned m_pendingSubmit = 0;
+
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+    unsigned m_cqMask = 0;
+    unsigned m_cqEntries = 0;
+
+    // 已被内核取走、尚未收割完成事件的请求数
+    std::atomic<size_t> m_kernelOwned{0};
+
+    size_t m_registeredCount = 0;
+    std::mutex m_submitMutex;
+    std::mutex m_completeMutex;
+};
+
+#endif // UTILITY_HAS_IO_URING
+
+} // namespace
+
+Engine::Engine(const Options& options) {
+#ifdef UTILITY_HAS_IO_URING
+    if (options.backend == Backend::Auto || options.backend == Backend::IoUring) {
+        std::unique_ptr<IoUringImpl> uring(new IoUringImpl());
+        if (uring->Init(options.queueDepth)) {
+            m_impl = std::move(uring);
+            return;
+        }
+    }
+#endif
+    if (options.backend == Backend::Auto || options.backend == Backend::ThreadPool) {
+        m_impl.reset(new ThreadPoolImpl(options.workerThreads));
+    }
+}
+
+Engine::~Engine() {
+    if (m_impl) {
+        Drain();
+    }
+}
+
+bool Engine::IsValid() const {
+    return m_impl != nullptr;
+}
+
+Backend Engine::GetBackend() const {
+    return m_impl ? m_impl->GetBackend() : Backend::Auto;
+}
+
+bool Engine::RegisterBuffers(const std::vector<Buffer>& buffers) {
+    return m_impl && m_impl->RegisterBuffers(buffers);
+}
+
+void Engine::UnregisterBuffers() {
+    if (m_impl) {
+        m_impl->UnregisterBuffers();
+    }
+}
+
+size_t Engine::Submit(std::vector<Request> requests) {
+    if (!m_impl || requests.empty()) {
+        return 0;
+    }
+    return m_impl->Submit(requests);
+}
+
+bool Engine::Submit(Request request) {
+    std::vector<Request> requests;
+    requests.push_back(std::move(request));
+    return Submit(std::move(requests)) == 1;
+}
+
+size_t Engine::Reap(size_t minComplete) {
+    return m_impl ? m_impl->Reap(minComplete) : 0;
+}
+
+void Engine::Drain() {
+    if (!m_impl) {
+        return;
+    }
+    while (m_impl->InFlight() > 0) {
+        m_impl->Reap(m_impl->InFlight());
+    }
+    m_impl->Reap(0);
+}
+
+size_t Engine::InFlight() const {
+    return m_impl ? m_impl->InFlight() : 0;
+}
+
+} // namespace Utility::AsyncIO
@@ -1,5 +1,7 @@
 #include "Utility/Compression.h"
+#include "CompressionInternal.h"
 #include "zstd/zstd.h"
+#include <algorithm>
 #include <cstring>
 
 namespace Utility::Compression {
@@ -13,11 +15,6 @@ static std::vector<char> CompressZstd(const std::vector<char>& data, int level)
         return std::vector<char>();
     }
 
-    // 验证压缩级别
-    if (level < 1 || level > ZSTD_maxCLevel()) {
-        level = 3; // 使用默认级别
-    }
-
     // 计算压缩后的最大大小
     size_t const dstCapacity = ZSTD_compressBound(data.size());
     std::vector<char> dst(dstCapacity);
@@ -158,32 +155,203 @@ static std::vector<char> DecompressStreamingZstd(const std::vector<char>& compre
     return dst;
 }
 
+// Zstd 前缀解压实现：直接解压到结果缓冲区，得到 maxBytes 字节后停止
+static std::vector<char> DecompressPrefixZstd(const std::vector<char>& compressed, size_t maxBytes, size_t& consumed) {
+    if (compressed.empty() || maxBytes == 0) {
+        return std::vector<char>();
+    }
+
+    // 帧头记录了原始大小时按其分配，避免 maxBytes 很大时预先分配过多内存
+    size_t initialSize = std::min(maxBytes, ZSTD_DStreamOutSize());
+    unsigned long long const frameContentSize = ZSTD_getFrameContentSize(
+        compressed.data(), compressed.size()
+    );
+    if (frameContentSize == ZSTD_CONTENTSIZE_ERROR) {
+        return std::vector<char>();
+    }
+    if (frameContentSize != ZSTD_CONTENTSIZE_UNKNOWN) {
+        initialSize = static_cast<size_t>(std::min<unsigned long long>(maxBytes, std::max<unsigned long long>(frameContentSize, 1)));
+    }
+
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (dctx == nullptr) {
+        return std::vector<char>();
+    }
+
+    std::vector<char> dst(initialSize);
+    size_t produced = 0;
+    ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+
+    while (produced < maxBytes) {
+        if (produced == dst.size()) {
+            dst.resize(std::min(maxBytes, dst.size() * 2));
+        }
+
+        ZSTD_outBuffer output = {dst.data() + produced, dst.size() - produced, 0};
+        size_t const ret = ZSTD_decompressStream(dctx, &output, &input);
+        if (ZSTD_isError(ret)) {
+            ZSTD_freeDCtx(dctx);
+            return std::vector<char>();
+        }
+        produced += output.pos;
+
+        // 返回0且输入已用完，表示所有帧都已解压完成
+        if (ret == 0 && input.pos == input.size) {
+            break;
+        }
+        // 输入已用完却没有新的输出，说明数据被截断
+        if (output.pos == 0 && input.pos == input.size) {
+            ZSTD_freeDCtx(dctx);
+            return std::vector<char>();
+        }
+    }
+
+    ZSTD_freeDCtx(dctx);
+    consumed = input.pos;
+    dst.resize(produced);
+    return dst;
+}
+
+// Zstd 回调式流式解压实现
+static bool DecompressStreamZstd(const std::vector<char>& compressed, const ChunkCallback& onChunk,
+                                 size_t& consumed, size_t& produced) {
+    if (compressed.empty()) {
+        return false;
+    }
+
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (dctx == nullptr) {
+        return false;
+    }
+
+    const size_t outBufferSize = ZSTD_DStreamOutSize();
+    std::vector<char> outBuffer(outBufferSize);
+    ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+    bool ok = false;
+
+    for (;;) {
+        ZSTD_outBuffer output = {outBuffer.data(), outBufferSize, 0};
+        size_t const ret = ZSTD_decompressStream(dctx, &output, &input);
+        if (ZSTD_isError(ret)) {
+            break;
+        }
+        produced += output.pos;
+
+        if (output.pos > 0 && onChunk && !onChunk(outBuffer.data(), output.pos)) {
+            ok = true; // 调用方已获得足够数据
+            break;
+        }
+        if (ret == 0 && input.pos == input.size) {
+            ok = true;
+            break;
+        }
+        if (output.pos == 0 && input.pos == input.size) {
+            break; // 数据被截断
+        }
+    }
+
+    ZSTD_freeDCtx(dctx);
+    consumed = input.pos;
+    return ok;
+}
+
+int NormalizeLevel(Algorithm algorithm, int level) {
+    switch (algorithm) {
+        case Algorithm::Zstd:
+            // 验证压缩级别，负数级别为快速模式
+            if (level == 0 || level < ZSTD_minCLevel() || level > ZSTD_maxCLevel()) {
+                return 3; // 使用默认级别
+            }
+            return level;
+        default:
+            return level;
+    }
+}
+
+// 空输入返回空结果属于正常情况，不计为失败
+static void FinishStats(StatsScope& stats, size_t inputSize, const std::vector<char>& result) {
+    if (!result.empty() || inputSize == 0) {
+        stats.Succeed(inputSize, result.size());
+    }
+}
+
 // 公共接口实现
 std::vector<char> Compress(const std::vector<char>& data, Algorithm algorithm, int level) {
+    level = NormalizeLevel(algorithm, level);
+    StatsScope stats(StatsOperation::Compress, algorithm, level);
+    std::vector<char> result;
     switch (algorithm) {
         case Algorithm::Zstd:
-            return CompressZstd(data, level);
+            result = CompressZstd(data, level);
+            break;
         default:
-            return std::vector<char>();
+            break;
     }
+    FinishStats(stats, data.size(), result);
+    return result;
 }
 
 std::vector<char> Decompress(const std::vector<char>& compressed, size_t originalSize, Algorithm algorithm) {
+    StatsScope stats(StatsOperation::Decompress, algorithm, 0);
+    std::vector<char> result;
     switch (algorithm) {
         case Algorithm::Zstd:
-            return DecompressZstd(compressed, originalSize);
+            result = DecompressZstd(compressed, originalSize);
+            break;
         default:
-            return std::vector<char>();
+            break;
     }
+    FinishStats(stats, compressed.size(), result);
+    return result;
 }
 
 std::vector<char> DecompressAuto(const std::vector<char>& compressed, Algorithm algorithm) {
+    StatsScope stats(StatsOperation::Decompress, algorithm, 0);
+    std::vector<char> result;
     switch (algorithm) {
         case Algorithm::Zstd:
-            return DecompressAutoZstd(compressed);
+            result = DecompressAutoZstd(compressed);
+            break;
         default:
-            return std::vector<char>();
+            break;
+    }
+    FinishStats(stats, compressed.size(), result);
+    return result;
+}
+
+std::vector<char> DecompressPrefix(const std::vector<char>& compressed, size_t maxBytes, Algorithm algorithm) {
+    StatsScope stats(StatsOperation::Decompress, algorithm, 0);
+    std::vector<char> result;
+    size_t consumed = 0;
+    switch (algorithm) {
+        case Algorithm::Zstd:
+            result = DecompressPrefixZstd(compressed, maxBytes, consumed);
+            break;
+        default:
+            break;
+    }
+    if (!result.empty()) {
+        stats.Succeed(consumed, result.size());
+    }
+    return result;
+}
+
+bool DecompressStream(const std::vector<char>& compressed, const ChunkCallback& onChunk, Algorithm algorithm) {
+    StatsScope stats(StatsOperation::Decompress, algorithm, 0);
+    bool ok = false;
+    size_t consumed = 0;
+    size_t produced = 0;
+    switch (algorithm) {
+        case Algorithm::Zstd:
+            ok = DecompressStreamZstd(compressed, onChunk, consumed, produced);
+            break;
+        default:
+            break;
+    }
+    if (ok) {
+        stats.Succeed(consumed, produced);
     }
+    return ok;
 }
 
 } // namespace Utility::Compression
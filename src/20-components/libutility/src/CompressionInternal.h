@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Utility/CompressionStats.h"
+
+namespace Utility::Compression {
+
+// 将非法的压缩级别替换为默认级别，返回实际使用的级别
+int NormalizeLevel(Algorithm algorithm, int level);
+
+// 统计开启时返回当前时间（纳秒），关闭时返回 0
+uint64_t StatsClockNow();
+
+// 记录一次调用，startNanos 为 0 表示调用开始时统计未开启
+void RecordStats(StatsOperation operation, Algorithm algorithm, int level,
+                 uint64_t bytesIn, uint64_t bytesOut, bool success, uint64_t startNanos);
+
+// 在作用域结束时记录一次调用，默认记为失败，成功时调用 Succeed 设置字节数
+class StatsScope {
+public:
+    StatsScope(StatsOperation operation, Algorithm algorithm, int level)
+        : m_operation(operation), m_algorithm(algorithm), m_level(level), m_start(StatsClockNow()) {}
+
+    ~StatsScope() {
+        if (m_start != 0) {
+            RecordStats(m_operation, m_algorithm, m_level, m_bytesIn, m_bytesOut, m_success, m_start);
+        }
+    }
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+    void Succeed(uint64_t bytesIn, uint64_t bytesOut) {
+        m_success = true;
+        m_bytesIn = bytesIn;
+        m_bytesOut = bytesOut;
+    }
+
+private:
+    StatsOperation m_operation;
+    Algorithm m_algorithm;
+    int m_level;
+    uint64_t m_start;
+    bool m_success = false;
+    uint64_t m_bytesIn = 0;
+    uint64_t m_bytesOut = 0;
+};
+
+} // namespace Utility::Compression
@@ -0,0 +1,301 @@
+#include "CompressionInternal.h"
+#include "Utility/ThreadLocalStats.h"
+#include "nlohmann/json.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Utility::Compression {
+
+namespace {
+
+constexpr size_t kOperationCount = 4;
+constexpr size_t kAlgorithmCount = 1;
+constexpr size_t kLevelCount = kStatsMaxLevel - kStatsMinLevel + 1;
+constexpr size_t kSlotCount = kOperationCount * kAlgorithmCount * kLevelCount;
+
+std::atomic<bool> g_statsEnabled{true};
+
+using Stats::Accumulate;
+
+struct Counters {
+    Counters() {
+        for (auto& bucket : latencyHistogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> bytesIn{0};
+    std::atomic<uint64_t> bytesOut{0};
+    std::atomic<uint64_t> totalNanos{0};
+    std::array<std::atomic<uint64_t>, kLatencyBuckets> latencyHistogram;
+};
+
+size_t SlotIndex(StatsOperation operation, Algorithm algorithm, int level) {
+    if (level < kStatsMinLevel) {
+        level = kStatsMinLevel;
+    } else if (level > kStatsMaxLevel) {
+        level = kStatsMaxLevel;
+    }
+    return (static_cast<size_t>(operation) * kAlgorithmCount + static_cast<size_t>(algorithm)) * kLevelCount
+           + static_cast<size_t>(level - kStatsMinLevel);
+}
+
+StatsEntry EmptyEntry(size_t index) {
+    StatsEntry entry;
+    entry.level = static_cast<int>(index % kLevelCount) + kStatsMinLevel;
+    entry.algorithm = static_cast<Algorithm>((index / kLevelCount) % kAlgorithmCount);
+    entry.operation = static_cast<StatsOperation>(index / kLevelCount / kAlgorithmCount);
+    return entry;
+}
+
+void AddTo(StatsEntry& entry, const Counters& counters) {
+    entry.calls += counters.calls.load(std::memory_order_relaxed);
+    entry.failures += counters.failures.load(std::memory_order_relaxed);
+    entry.bytesIn += counters.bytesIn.load(std::memory_order_relaxed);
+    entry.bytesOut += counters.bytesOut.load(std::memory_order_relaxed);
+    entry.totalNanos += counters.totalNanos.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kLatencyBuckets; i++) {
+        entry.latencyHistogram[i] += counters.latencyHistogram[i].load(std::memory_order_relaxed);
+    }
+}
+
+// 所有组合的汇总值，下标为 SlotIndex
+struct StatsTotals {
+    StatsTotals() {
+        entries.reserve(kSlotCount);
+        for (size_t i = 0; i < kSlotCount; i++) {
+            entries.push_back(EmptyEntry(i));
+        }
+    }
+
+    std::vector<StatsEntry> entries;
+};
+
+// 线程本地统计块，计数器按需分配
+class ThreadStats {
+public:
+    ThreadStats() {
+        for (auto& slot : m_slots) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadStats() {
+        for (auto& slot : m_slots) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    Counters& Get(size_t index) {
+        Counters* counters = m_slots[index].load(std::memory_order_relaxed);
+        if (counters == nullptr) {
+            counters = new Counters();
+            m_slots[index].store(counters, std::memory_order_release);
+        }
+        return *counters;
+    }
+
+    void MergeInto(StatsTotals& totals) const {
+        for (size_t i = 0; i < kSlotCount; i++) {
+            const Counters* counters = m_slots[i].load(std::memory_order_acquire);
+            if (counters != nullptr) {
+                AddTo(totals.entries[i], *counters);
+            }
+        }
+    }
+
+private:
+    std::array<std::atomic<Counters*>, kSlotCount> m_slots;
+};
+
+using Registry = Stats::ThreadLocalRegistry<ThreadStats, StatsTotals>;
+
+const char* OperationName(StatsOperation operation) {
+    switch (operation) {
+        case StatsOperation::Compress:
+            return "compress";
+        case StatsOperation::Decompress:
+            return "decompress";
+        case StatsOperation::CompressFile:
+            return "compress_file";
+        case StatsOperation::DecompressFile:
+            return "decompress_file";
+        default:
+            return "unknown";
+    }
+}
+
+const char* AlgorithmName(Algorithm algorithm) {
+    switch (algorithm) {
+        case Algorithm::Zstd:
+            return "zstd";
+        default:
+            return "unknown";
+    }
+}
+
+// 定期输出统计的后台线程
+struct PeriodicLogger {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread thread;
+    bool stopping = false;
+
+    ~PeriodicLogger() { Stop(); }
+
+    void Start(unsigned intervalSeconds) {
+        Stop();
+        stopping = false;
+        thread = std::thread([this, intervalSeconds]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!cond.wait_for(lock, std::chrono::seconds(intervalSeconds), [this]() { return stopping; })) {
+                lock.unlock();
+                LogStats();
+                lock.lock();
+            }
+        });
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cond.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
+PeriodicLogger& GetPeriodicLogger() {
+    static PeriodicLogger logger;
+    return logger;
+}
+
+} // namespace
+
+uint64_t StatsClockNow() {
+    if (!g_statsEnabled.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    uint64_t nanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    return nanos == 0 ? 1 : nanos;
+}
+
+void RecordStats(StatsOperation operation, Algorithm algorithm, int level,
+                 uint64_t bytesIn, uint64_t bytesOut, bool success, uint64_t startNanos) {
+    if (startNanos == 0) {
+        return;
+    }
+    uint64_t now = StatsClockNow();
+    uint64_t elapsed = now > startNanos ? now - startNanos : 0;
+
+    Counters& counters = Registry::Instance().Local().Get(SlotIndex(operation, algorithm, level));
+    Accumulate(counters.calls, 1);
+    if (success) {
+        Accumulate(counters.bytesIn, bytesIn);
+        Accumulate(counters.bytesOut, bytesOut);
+    } else {
+        Accumulate(counters.failures, 1);
+    }
+    Accumulate(counters.totalNanos, elapsed);
+    Accumulate(counters.latencyHistogram[Stats::LatencyBucket(elapsed, kLatencyBuckets)], 1);
+}
+
+uint64_t StatsEntry::LatencyPercentileMicros(double percentile) const {
+    return Stats::HistogramPercentileMicros(latencyHistogram, percentile);
+}
+
+std::string StatsSnapshot::ToJson(int indent) const {
+    nlohmann::json entriesJson = nlohmann::json::array();
+    for (const auto& entry : entries) {
+        nlohmann::json item;
+        item["operation"] = OperationName(entry.operation);
+        item["algorithm"] = AlgorithmName(entry.algorithm);
+        item["level"] = entry.level;
+        item["calls"] = entry.calls;
+        item["failures"] = entry.failures;
+        item["bytes_in"] = entry.bytesIn;
+        item["bytes_out"] = entry.bytesOut;
+        item["total_ns"] = entry.totalNanos;
+        item["p50_us"] = entry.LatencyPercentileMicros(0.5);
+        item["p99_us"] = entry.LatencyPercentileMicros(0.99);
+        item["latency_histogram_us"] = entry.latencyHistogram;
+        entriesJson.push_back(item);
+    }
+
+    nlohmann::json root;
+    root["enabled"] = IsStatsEnabled();
+    root["entries"] = entriesJson;
+    return root.dump(indent);
+}
+
+void SetStatsEnabled(bool enabled) {
+    g_statsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsStatsEnabled() {
+    return g_statsEnabled.load(std::memory_order_relaxed);
+}
+
+StatsSnapshot GetStatsSnapshot() {
+    StatsTotals totals = Registry::Instance().Collect();
+    StatsTotals baseline = Registry::Instance().Baseline();
+
+    StatsSnapshot snapshot;
+    for (size_t i = 0; i < kSlotCount; i++) {
+        StatsEntry entry = totals.entries[i];
+        const StatsEntry& base = baseline.entries[i];
+        entry.calls -= base.calls;
+        entry.failures -= base.failures;
+        entry.bytesIn -= base.bytesIn;
+        entry.bytesOut -= base.bytesOut;
+        entry.totalNanos -= base.totalNanos;
+        for (size_t b = 0; b < kLatencyBuckets; b++) {
+            entry.latencyHistogram[b] -= base.latencyHistogram[b];
+        }
+        if (entry.calls > 0) {
+            snapshot.entries.push_back(entry);
+        }
+    }
+    return snapshot;
+}
+
+void ResetStats() {
+    Registry::Instance().ResetBaseline();
+}
+
+void LogStats() {
+    StatsSnapshot snapshot = GetStatsSnapshot();
+    if (snapshot.entries.empty()) {
+        SPDLOG_INFO("压缩统计: 暂无数据");
+        return;
+    }
+    for (const auto& entry : snapshot.entries) {
+        double ratio = entry.bytesIn > 0 ? static_cast<double>(entry.bytesOut) / entry.bytesIn : 0.0;
+        SPDLOG_INFO("压缩统计: {} {} level={} 调用={} 失败={} 输入={} bytes 输出={} bytes 比例={:.3f} "
+                    "平均耗时={} 微秒 p99<={} 微秒",
+                    OperationName(entry.operation), AlgorithmName(entry.algorithm), entry.level,
+                    entry.calls, entry.failures, entry.bytesIn, entry.bytesOut, ratio,
+                    entry.totalNanos / entry.calls / 1000, entry.LatencyPercentileMicros(0.99));
+    }
+}
+
+void StartStatsLogging(unsigned intervalSeconds) {
+    GetPeriodicLogger().Start(intervalSeconds == 0 ? 1 : intervalSeconds);
+}
+
+void StopStatsLogging() {
+    GetPeriodicLogger().Stop();
+}
+
+} // namespace Utility::Compression
@@ -0,0 +1,688 @@
+#include "Utility/Compression.h"
+#include "Utility/AsyncIO.h"
+#include "CompressionInternal.h"
+#include "zstd/zstd.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <fcntl.h>
+#include <libgen.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Utility::Compression {
+
+namespace {
+
+// O_DIRECT 要求缓冲区地址、长度和文件偏移都按块对齐，统一使用 4KB
+constexpr size_t kIoAlignment = 4096;
+
+// 每写满一个窗口就回写并释放上一个窗口的页缓存
+constexpr uint64_t kCacheDropWindow = 8ull << 20;
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// 按 kIoAlignment 对齐的缓冲区
+class AlignedBuffer {
+public:
+    explicit AlignedBuffer(size_t size) : m_size(AlignUp(std::max<size_t>(size, 1), kIoAlignment)) {
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, kIoAlignment, m_size) == 0) {
+            m_data = static_cast<char*>(ptr);
+        }
+    }
+    ~AlignedBuffer() { free(m_data); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool valid() const { return m_data != nullptr; }
+
+private:
+    char* m_data = nullptr;
+    size_t m_size;
+};
+
+// 顺序读取的源文件
+class InputFile {
+public:
+    ~InputFile() {
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    }
+
+    bool Open(const std::string& path, bool directIO, bool dropCache) {
+        m_dropCache = dropCache;
+        if (directIO) {
+            m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        }
+        if (m_fd < 0) {
+            // 文件系统不支持 O_DIRECT（如 tmpfs）时回退到普通读取
+            m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+        if (m_fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(m_fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            m_size = static_cast<uint64_t>(st.st_size);
+            m_sizeKnown = true;
+        }
+        posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return true;
+    }
+
+    // 读取最多 capacity 字节，返回读取的字节数，0 表示文件结束，-1 表示失败
+    ssize_t Read(char* buffer, size_t capacity) {
+        size_t filled = 0;
+        while (filled < capacity) {
+            ssize_t n = read(m_fd, buffer + filled, capacity - filled);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && errno == EINVAL && DisableDirectIO()) {
+                // 短读导致偏移不再对齐，关闭 O_DIRECT 后重试
+                continue;
+            }
+            if (n < 0) {
+                return -1;
+            }
+            if (n == 0) {
+                break;
+            }
+            filled += static_cast<size_t>(n);
+        }
+
+        if (m_dropCache && filled > 0) {
+            posix_fadvise(m_fd, static_cast<off_t>(m_offset), static_cast<off_t>(filled), POSIX_FADV_DONTNEED);
+        }
+        m_offset += filled;
+        return static_cast<ssize_t>(filled);
+    }
+
+    uint64_t Size() const { return m_size; }
+    bool SizeKnown() const { return m_sizeKnown; }
+    uint64_t Offset() const { return m_offset; }
+
+private:
+    bool DisableDirectIO() {
+        int flags = fcntl(m_fd, F_GETFL);
+        if (flags < 0 || !(flags & O_DIRECT)) {
+            return false;
+        }
+        return fcntl(m_fd, F_SETFL, flags & ~O_DIRECT) == 0;
+    }
+
+    int m_fd = -1;
+    bool m_dropCache = false;
+    bool m_sizeKnown = false;
+    uint64_t m_size = 0;
+    uint64_t m_offset = 0;
+};
+
+// 先写同目录临时文件，Commit 时 rename 到目标路径；未提交的临时文件在析构时删除。
+// 指定异步引擎时，数据先拷贝到轮转的暂存缓冲区，写满后异步提交；提交时等待之前的写入完成，
+// 再把最后一次写入与 fsync 链接提交
+class AtomicOutputFile {
+public:
+    ~AtomicOutputFile() {
+        // 在途写入的完成回调引用了本对象，必须先等待
+        WaitAsync([this]() { return AllSlotsIdle() && !m_syncBusy.load(std::memory_order_acquire); });
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+        if (!m_committed && !m_tempPath.empty()) {
+            unlink(m_tempPath.c_str());
+        }
+    }
+
+    bool Open(const std::string& path, bool dropCache, AsyncIO::Engine* engine, size_t bufferSize) {
+        m_path = path;
+        m_dropCache = dropCache;
+
+        if (engine != nullptr) {
+            for (size_t i = 0; i < kAsyncSlots; i++) {
+                m_slots.emplace_back(new Slot(bufferSize));
+                if (!m_slots.back()->buffer.valid()) {
+                    return false;
+                }
+            }
+            m_engine = engine;
+        }
+
+        std::vector<char> templ(path.begin(), path.end());
+        const char suffix[] = ".tmp.XXXXXX";
+        templ.insert(templ.end(), suffix, suffix + sizeof(suffix));
+        m_fd = mkostemp(templ.data(), O_CLOEXEC);
+        if (m_fd < 0) {
+            return false;
+        }
+        m_tempPath = templ.data();
+        fchmod(m_fd, 0644);
+        return true;
+    }
+
+    bool Write(const char* data, size_t size) {
+        if (m_engine != nullptr) {
+            return WriteAsync(data, size);
+        }
+
+        while (size > 0) {
+            ssize_t n = write(m_fd, data, size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+            m_written += static_cast<uint64_t>(n);
+        }
+
+        if (m_dropCache && m_written - m_windowStart >= kCacheDropWindow) {
+            DropWrittenWindow();
+        }
+        return true;
+    }
+
+    bool Commit(bool sync) {
+        if (m_engine != nullptr) {
+            if (!FlushAsync(sync)) {
+                return false;
+            }
+        } else if (sync && fsync(m_fd) != 0) {
+            return false;
+        }
+        if (m_dropCache) {
+            posix_fadvise(m_fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+        if (close(m_fd) != 0) {
+            m_fd = -1;
+            return false;
+        }
+        m_fd = -1;
+
+        if (rename(m_tempPath.c_str(), m_path.c_str()) != 0) {
+            return false;
+        }
+        m_committed = true;
+
+        if (sync) {
+            SyncParentDirectory();
+        }
+        return true;
+    }
+
+    // 已写出（或已提交异步写入）的字节数，不含暂存缓冲区中尚未提交的数据
+    uint64_t Written() const { return m_written; }
+
+private:
+    // 异步模式下轮转使用的暂存缓冲区数量
+    static constexpr size_t kAsyncSlots = 4;
+
+    struct Slot {
+        explicit Slot(size_t size) : buffer(size) {}
+        AlignedBuffer buffer;
+        size_t used = 0;
+        std::atomic<bool> busy{false};
+    };
+
+    bool WriteAsync(const char* data, size_t size) {
+        while (size > 0) {
+            if (m_asyncError.load(std::memory_order_acquire) != 0) {
+                return false;
+            }
+            Slot& slot = *m_slots[m_current];
+            size_t n = std::min(size, slot.buffer.size() - slot.used);
+            memcpy(slot.buffer.data() + slot.used, data, n);
+            slot.used += n;
+            data += n;
+            size -= n;
+
+            if (slot.used == slot.buffer.size()) {
+                if (!SubmitAsync(slot, false)) {
+                    return false;
+                }
+                m_current = (m_current + 1) % m_slots.size();
+                Slot& next = *m_slots[m_current];
+                WaitAsync([&next]() { return !next.busy.load(std::memory_order_acquire); });
+            }
+        }
+        return m_asyncError.load(std::memory_order_acquire) == 0;
+    }
+
+    // 提交暂存缓冲区中的数据，linkSync 为 true 时在同一条链上追加 fsync
+    bool SubmitAsync(Slot& slot, bool linkSync) {
+        std::vector<AsyncIO::Request> requests;
+        std::atomic<int64_t>* error = &m_asyncError;
+
+        if (slot.used > 0) {
+            AsyncIO::Request write;
+            write.operation = AsyncIO::Operation::Write;
+            write.fd = m_fd;
+            write.buffer = slot.buffer.data();
+            write.length = slot.used;
+            write.offset = m_written;
+            write.linkNext = linkSync;
+            Slot* target = &slot;
+            int64_t expected = static_cast<int64_t>(slot.used);
+            write.onComplete = [target, error, expected](int64_t result) {
+                if (result != expected) {
+                    int64_t none = 0;
+                    error->compare_exchange_strong(none, result < 0 ? result : -EIO);
+                }
+                target->used = 0;
+                target->busy.store(false, std::memory_order_release);
+            };
+            m_written += slot.used;
+            slot.busy.store(true, std::memory_order_release);
+            requests.push_back(std::move(write));
+        }
+
+        if (linkSync) {
+            AsyncIO::Request sync;
+            sync.operation = AsyncIO::Operation::Fsync;
+            sync.fd = m_fd;
+            std::atomic<bool>* busy = &m_syncBusy;
+            sync.onComplete = [error, busy](int64_t result) {
+                if (result < 0) {
+                    int64_t none = 0;
+                    error->compare_exchange_strong(none, result);
+                }
+                busy->store(false, std::memory_order_release);
+            };
+            m_syncBusy.store(true, std::memory_order_release);
+            requests.push_back(std::move(sync));
+        }
+
+        if (requests.empty()) {
+            return true;
+        }
+        // 只提交了前一部分时，已提交请求的回调照常执行，未提交的请求由这里复位状态
+        size_t total = requests.size();
+        size_t submitted = m_engine->Submit(std::move(requests));
+        if (submitted == total) {
+            return true;
+        }
+        if (submitted == 0 && slot.busy.load(std::memory_order_acquire)) {
+            slot.busy.store(false, std::memory_order_release);
+        }
+        m_syncBusy.store(false, std::memory_order_release);
+        int64_t none = 0;
+        m_asyncError.compare_exchange_strong(none, -EIO);
+        return false;
+    }
+
+    bool FlushAsync(bool sync) {
+        // IOSQE_IO_LINK 只约束同一条链，线程池后端也会并行执行不同的链：
+        // 先等之前的写入全部完成，fsync 才能覆盖整个文件
+        WaitAsync([this]() { return AllSlotsIdle(); });
+        if (m_asyncError.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        bool ok = SubmitAsync(*m_slots[m_current], sync);
+        WaitAsync([this]() { return AllSlotsIdle() && !m_syncBusy.load(std::memory_order_acquire); });
+        return ok && m_asyncError.load(std::memory_order_acquire) == 0;
+    }
+
+    bool AllSlotsIdle() const {
+        for (const auto& slot : m_slots) {
+            if (slot->busy.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 引擎可能被共享，本对象的完成回调可能在其他线程的 Reap 中执行（见 AsyncIO::Engine 的说明），
+    // 因此以本对象的状态而不是 Reap 的返回值判断是否完成
+    template <typename Predicate>
+    void WaitAsync(Predicate done) {
+        while (!done()) {
+            if (m_engine->Reap(1) == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // 异步发起当前窗口的回写，等待上一个窗口落盘后释放其页缓存
+    void DropWrittenWindow() {
+        off_t start = static_cast<off_t>(m_windowStart);
+        off_t length = static_cast<off_t>(m_written - m_windowStart);
+        sync_file_range(m_fd, start, length, SYNC_FILE_RANGE_WRITE);
+        if (m_previousWindowLength > 0) {
+            sync_file_range(m_fd, m_previousWindowStart, m_previousWindowLength,
+                            SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+            posix_fadvise(m_fd, m_previousWindowStart, m_previousWindowLength, POSIX_FADV_DONTNEED);
+        }
+        m_previousWindowStart = start;
+        m_previousWindowLength = length;
+        m_windowStart = m_written;
+    }
+
+    void SyncParentDirectory() {
+        std::vector<char> copy(m_path.begin(), m_path.end());
+        copy.push_back('\0');
+        int dirFd = open(dirname(copy.data()), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd >= 0) {
+            fsync(dirFd);
+            close(dirFd);
+        }
+    }
+
+    std::string m_path;
+    std::string m_tempPath;
+    int m_fd = -1;
+    bool m_dropCache = false;
+    bool m_committed = false;
+    uint64_t m_written = 0;
+    uint64_t m_windowStart = 0;
+    off_t m_previousWindowStart = 0;
+    off_t m_previousWindowLength = 0;
+
+    AsyncIO::Engine* m_engine = nullptr;
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    size_t m_current = 0;
+    std::atomic<int64_t> m_asyncError{0};
+    std::atomic<bool> m_syncBusy{false};
+};
+
+// 一次文件操作的读写字节数，用于统计
+struct FileTotals {
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+};
+
+bool ShouldCancel(const FileOptions& options) {
+    return options.shouldCancel && options.shouldCancel();
+}
+
+void ReportProgress(const FileOptions& options, const InputFile& input) {
+    if (options.onProgress) {
+        options.onProgress(input.Offset(), input.SizeKnown() ? input.Size() : 0);
+    }
+}
+
+// Zstd 文件压缩实现
+bool CompressFileZstd(const std::string& srcPath, const std::string& dstPath, const FileOptions& options,
+                      FileTotals& totals) {
+    InputFile input;
+    if (!input.Open(srcPath, options.directIO, options.dropPageCache)) {
+        return false;
+    }
+
+    AlignedBuffer inBuffer(options.bufferSize);
+    AlignedBuffer outBuffer(std::max(options.bufferSize, ZSTD_CStreamOutSize()));
+    if (!inBuffer.valid() || !outBuffer.valid()) {
+        return false;
+    }
+
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    if (cctx == nullptr) {
+        return false;
+    }
+
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, NormalizeLevel(Algorithm::Zstd, options.level));
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+    if (input.SizeKnown()) {
+        // 写入帧头的原始大小，便于 DecompressAuto 直接分配输出
+        ZSTD_CCtx_setPledgedSrcSize(cctx, input.Size());
+    }
+
+    AtomicOutputFile output;
+    bool ok = output.Open(dstPath, options.dropPageCache, options.ioEngine, options.bufferSize);
+
+    bool finished = false;
+    while (ok && !finished) {
+        if (ShouldCancel(options)) {
+            ok = false;
+            break;
+        }
+
+        ssize_t n = input.Read(inBuffer.data(), inBuffer.size());
+        if (n < 0) {
+            ok = false;
+            break;
+        }
+
+        ZSTD_EndDirective const mode = (n == 0) ? ZSTD_e_end : ZSTD_e_continue;
+        ZSTD_inBuffer in = {inBuffer.data(), static_cast<size_t>(n), 0};
+
+        // ZSTD_e_continue 时消费完输入即可，ZSTD_e_end 时需要刷出整个帧
+        for (;;) {
+            ZSTD_outBuffer out = {outBuffer.data(), outBuffer.size(), 0};
+            size_t const remaining = ZSTD_compressStream2(cctx, &out, &in, mode);
+            if (ZSTD_isError(remaining)) {
+                ok = false;
+                break;
+            }
+            if (out.pos > 0 && !output.Write(outBuffer.data(), out.pos)) {
+                ok = false;
+                break;
+            }
+            if (mode == ZSTD_e_end ? remaining == 0 : in.pos == in.size) {
+                break;
+            }
+        }
+
+        finished = (n == 0);
+        if (ok) {
+            ReportProgress(options, input);
+        }
+    }
+
+    ZSTD_freeCCtx(cctx);
+    ok = ok && output.Commit(options.syncOutput);
+    totals.bytesIn = input.Offset();
+    totals.bytesOut = output.Written();
+    return ok;
+}
+
+// Zstd 文件解压实现
+bool DecompressFileZstd(const std::string& srcPath, const std::string& dstPath, const FileOptions& options,
+                        FileTotals& totals) {
+    InputFile input;
+    if (!input.Open(srcPath, options.directIO, options.dropPageCache)) {
+        return false;
+    }
+
+    AlignedBuffer inBuffer(options.bufferSize);
+    AlignedBuffer outBuffer(std::max(options.bufferSize, ZSTD_DStreamOutSize()));
+    if (!inBuffer.valid() || !outBuffer.valid()) {
+        return false;
+    }
+
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (dctx == nullptr) {
+        return false;
+    }
+
+    AtomicOutputFile output;
+    bool ok = output.Open(dstPath, options.dropPageCache, options.ioEngine, options.bufferSize);
+
+    // 最近一次 ZSTD_decompressStream 的返回值，0 表示当前帧已完整结束
+    size_t lastRet = 0;
+    bool sawInput = false;
+    while (ok) {
+        if (ShouldCancel(options)) {
+            ok = false;
+            break;
+        }
+
+        ssize_t n = input.Read(inBuffer.data(), inBuffer.size());
+        if (n < 0) {
+            ok = false;
+            break;
+        }
+        if (n == 0) {
+            // 输入结束时帧必须完整，否则说明文件被截断
+            ok = sawInput && lastRet == 0;
+            break;
+        }
+        sawInput = true;
+
+        // 输出缓冲区被写满时解压器内部可能还有数据，需要继续刷出
+        ZSTD_inBuffer in = {inBuffer.data(), static_cast<size_t>(n), 0};
+        bool outputFull = false;
+        while (in.pos < in.size || outputFull) {
+            ZSTD_outBuffer out = {outBuffer.data(), outBuffer.size(), 0};
+            lastRet = ZSTD_decompressStream(dctx, &out, &in);
+            if (ZSTD_isError(lastRet)) {
+                ok = false;
+                break;
+            }
+            if (out.pos > 0 && !output.Write(outBuffer.data(), out.pos)) {
+                ok = false;
+                break;
+            }
+            // 返回 0 表示帧已完整解压并刷出
+            outputFull = (out.pos == out.size) && lastRet != 0;
+        }
+
+        if (ok) {
+            ReportProgress(options, input);
+        }
+    }
+
+    ZSTD_freeDCtx(dctx);
+    ok = ok && output.Commit(options.syncOutput);
+    totals.bytesIn = input.Offset();
+    totals.bytesOut = output.Written();
+    return ok;
+}
+
+// Zstd 文件前缀解压实现：按 ZSTD_DStreamInSize 小块读取，得到 maxBytes 字节后停止读取
+bool DecompressFilePrefixZstd(const std::string& srcPath, size_t maxBytes, std::vector<char>& output,
+                              FileTotals& totals) {
+    output.clear();
+    InputFile input;
+    if (maxBytes == 0 || !input.Open(srcPath, false, false)) {
+        return false;
+    }
+
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (dctx == nullptr) {
+        return false;
+    }
+
+    std::vector<char> inBuffer(ZSTD_DStreamInSize());
+    output.resize(std::min(maxBytes, ZSTD_DStreamOutSize()));
+    size_t produced = 0;
+    size_t lastRet = 0;
+    bool ok = true;
+    bool eof = false;
+
+    while (ok && produced < maxBytes && !eof) {
+        ssize_t n = input.Read(inBuffer.data(), inBuffer.size());
+        if (n < 0) {
+            ok = false;
+            break;
+        }
+        eof = (n == 0);
+
+        // 输入用完后仍需继续调用，直到解压器不再产生输出
+        ZSTD_inBuffer in = {inBuffer.data(), static_cast<size_t>(n), 0};
+        for (;;) {
+            if (produced == output.size()) {
+                if (produced == maxBytes) {
+                    break;
+                }
+                output.resize(std::min(maxBytes, output.size() * 2));
+            }
+            ZSTD_outBuffer out = {output.data() + produced, output.size() - produced, 0};
+            size_t const consumedBefore = in.pos;
+            size_t const ret = ZSTD_decompressStream(dctx, &out, &in);
+            if (ZSTD_isError(ret)) {
+                ok = false;
+                break;
+            }
+            // 帧结束后的空调用会返回下一帧头的大小提示，不能覆盖帧完整的状态
+            if (in.pos > consumedBefore || out.pos > 0) {
+                lastRet = ret;
+            }
+            produced += out.pos;
+            if (in.pos == in.size && out.pos == 0) {
+                break;
+            }
+        }
+    }
+
+    // 未达到 maxBytes 就读到文件末尾时，最后一个帧必须完整
+    if (ok && produced < maxBytes && (lastRet != 0 || input.Offset() == 0)) {
+        ok = false;
+    }
+
+    ZSTD_freeDCtx(dctx);
+    totals.bytesIn = input.Offset();
+    totals.bytesOut = produced;
+    output.resize(ok ? produced : 0);
+    return ok;
+}
+
+} // namespace
+
+bool CompressFile(const std::string& srcPath, const std::string& dstPath, Algorithm algorithm, const FileOptions& options) {
+    StatsScope stats(StatsOperation::CompressFile, algorithm, NormalizeLevel(algorithm, options.level));
+    FileTotals totals;
+    bool ok = false;
+    switch (algorithm) {
+        case Algorithm::Zstd:
+            ok = CompressFileZstd(srcPath, dstPath, options, totals);
+            break;
+        default:
+            break;
+    }
+    if (ok) {
+        stats.Succeed(totals.bytesIn, totals.bytesOut);
+    }
+    return ok;
+}
+
+bool DecompressFile(const std::string& srcPath, const std::string& dstPath, Algorithm algorithm, const FileOptions& options) {
+    StatsScope stats(StatsOperation::DecompressFile, algorithm, 0);
+    FileTotals totals;
+    bool ok = false;
+    switch (algorithm) {
+        case Algorithm::Zstd:
+            ok = DecompressFileZstd(srcPath, dstPath, options, totals);
+            break;
+        default:
+            break;
+    }
+    if (ok) {
+        stats.Succeed(totals.bytesIn, totals.bytesOut);
+    }
+    return ok;
+}
+
+bool DecompressFilePrefix(const std::string& srcPath, size_t maxBytes, std::vector<char>& output, Algorithm algorithm) {
+    StatsScope stats(StatsOperation::DecompressFile, algorithm, 0);
+    FileTotals totals;
+    bool ok = false;
+    switch (algorithm) {
+        case Algorithm::Zstd:
+            ok = DecompressFilePrefixZstd(srcPath, maxBytes, output, totals);
+            break;
+        default:
+            output.clear();
+            break;
+    }
+    if (ok) {
+        stats.Succeed(totals.bytesIn, totals.bytesOut);
+    }
+    return ok;
+}
+
+} // namespace Utility::Compression
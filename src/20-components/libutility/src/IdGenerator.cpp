@@ -0,0 +1,68 @@
+#include "Utility/IdGenerator.h"
+#include <chrono>
+
+namespace Utility {
+
+namespace {
+
+uint64_t NowMillis() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+IdGenerator::IdGenerator(uint16_t node, uint64_t epochMillis)
+    : m_node(node & kMaxNode), m_epochMillis(epochMillis), m_last(0) {
+}
+
+uint64_t IdGenerator::Reserve(uint64_t count) {
+    uint64_t now = NowMillis();
+    uint64_t elapsed = now > m_epochMillis ? now - m_epochMillis : 0;
+    uint64_t floor = elapsed << kSequenceBits;
+
+    // 新值取 max(上次 + 1, 当前毫秒的第 0 个序号)：
+    // 时钟前进时从新毫秒开始，同一毫秒内递增序号，序号用尽或时钟回拨时进位到下一毫秒
+    uint64_t last = m_last.load(std::memory_order_relaxed);
+    uint64_t first;
+    do {
+        first = last + 1 > floor ? last + 1 : floor;
+    } while (!m_last.compare_exchange_weak(last, first + count - 1, std::memory_order_relaxed));
+    return first;
+}
+
+int64_t IdGenerator::Next() {
+    uint64_t value = Reserve(1);
+    uint64_t millis = value >> kSequenceBits;
+    uint64_t sequence = value & ((1u << kSequenceBits) - 1);
+    return static_cast<int64_t>((millis << (kNodeBits + kSequenceBits))
+                                | (static_cast<uint64_t>(m_node) << kSequenceBits) | sequence);
+}
+
+void IdGenerator::NextBatch(int64_t* ids, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    uint64_t value = Reserve(count);
+    for (size_t i = 0; i < count; i++, value++) {
+        uint64_t millis = value >> kSequenceBits;
+        uint64_t sequence = value & ((1u << kSequenceBits) - 1);
+        ids[i] = static_cast<int64_t>((millis << (kNodeBits + kSequenceBits))
+                                      | (static_cast<uint64_t>(m_node) << kSequenceBits) | sequence);
+    }
+}
+
+uint64_t IdGenerator::TimestampOf(int64_t id) const {
+    return (static_cast<uint64_t>(id) >> (kNodeBits + kSequenceBits)) + m_epochMillis;
+}
+
+uint16_t IdGenerator::NodeOf(int64_t id) {
+    return static_cast<uint16_t>((static_cast<uint64_t>(id) >> kSequenceBits) & kMaxNode);
+}
+
+IdGenerator& IdGenerator::Default() {
+    static IdGenerator generator;
+    return generator;
+}
+
+} // namespace Utility
@@ -0,0 +1,461 @@
+#include "Utility/Recompression.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <fcntl.h>
+#include <libgen.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Utility::Compression {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 由文件元数据生成版本，内容被改写或替换后都会变化
+uint64_t FileVersion(const struct stat& st) {
+    uint64_t version = static_cast<uint64_t>(st.st_size);
+    version = version * 1000003u ^ static_cast<uint64_t>(st.st_ino);
+    version = version * 1000003u ^ static_cast<uint64_t>(st.st_mtim.tv_sec);
+    version = version * 1000003u ^ static_cast<uint64_t>(st.st_mtim.tv_nsec);
+    return version;
+}
+
+bool CurrentVersion(const std::string& path, uint64_t& version) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    version = FileVersion(st);
+    return true;
+}
+
+bool WriteAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+bool FileObjectStore::Load(const std::string& key, std::vector<char>& data, uint64_t& version) {
+    int fd = open(key.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (ok) {
+        version = FileVersion(st);
+        data.resize(static_cast<size_t>(st.st_size));
+        size_t filled = 0;
+        while (filled < data.size()) {
+            ssize_t n = read(fd, data.data() + filled, data.size() - filled);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                ok = false;
+                break;
+            }
+            filled += static_cast<size_t>(n);
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+ReplaceResult FileObjectStore::Replace(const std::string& key, const std::vector<char>& data, uint64_t version) {
+    uint64_t current = 0;
+    if (!CurrentVersion(key, current) || current != version) {
+        return ReplaceResult::Conflict;
+    }
+
+    std::vector<char> templ(key.begin(), key.end());
+    const char suffix[] = ".tmp.XXXXXX";
+    templ.insert(templ.end(), suffix, suffix + sizeof(suffix));
+    int fd = mkostemp(templ.data(), O_CLOEXEC);
+    if (fd < 0) {
+        return ReplaceResult::Failed;
+    }
+
+    struct stat st;
+    if (stat(key.c_str(), &st) == 0) {
+        fchmod(fd, st.st_mode & 07777);
+    }
+    bool ok = WriteAll(fd, data.data(), data.size()) && fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+    if (!ok) {
+        unlink(templ.data());
+        return ReplaceResult::Failed;
+    }
+
+    // 写临时文件期间对象可能被改写，rename 前再检查一次
+    if (!CurrentVersion(key, current) || current != version) {
+        unlink(templ.data());
+        return ReplaceResult::Conflict;
+    }
+    if (rename(templ.data(), key.c_str()) != 0) {
+        unlink(templ.data());
+        return ReplaceResult::Failed;
+    }
+
+    std::vector<char> dir(key.begin(), key.end());
+    dir.push_back('\0');
+    int dirFd = open(dirname(dir.data()), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return ReplaceResult::Replaced;
+}
+
+class RecompressionScheduler::Impl {
+public:
+    Impl(std::shared_ptr<ObjectStore> store, const RecompressionOptions& options)
+        : m_store(std::move(store)), m_options(options), m_lastRefill(Clock::now()) {
+        m_tokens = static_cast<double>(m_options.ioBytesPerSecond);
+    }
+
+    ~Impl() { Stop(); }
+
+    void Track(const std::string& key, int currentLevel, uint64_t storedSize) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RemoveLocked(key);
+        m_abandoned.erase(key);
+        if (currentLevel >= m_options.targetLevel) {
+            return;
+        }
+        Tracked tracked;
+        tracked.level = currentLevel;
+        tracked.sequence = m_nextSequence++;
+        tracked.size = storedSize;
+        m_queue.emplace(tracked.level, tracked.sequence, key);
+        m_tracked.emplace(key, tracked);
+        m_pendingBytes += storedSize;
+        m_cond.notify_all();
+    }
+
+    void Untrack(const std::string& key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RemoveLocked(key);
+        m_abandoned.erase(key);
+    }
+
+    size_t RunSlice() {
+        // 同一时刻只允许一个时间片执行，避免前台 RunSlice 与后台线程叠加预算
+        std::lock_guard<std::mutex> sliceLock(m_sliceMutex);
+
+        Clock::time_point start = Clock::now();
+        Clock::time_point deadline = start + std::chrono::milliseconds(m_options.sliceMillis);
+        size_t processed = 0;
+
+        while (Clock::now() < deadline) {
+            RefillTokens();
+            if (m_options.ioBytesPerSecond > 0 && m_tokens <= 0) {
+                break;
+            }
+
+            std::string key;
+            Tracked tracked;
+            if (!PopNext(key, tracked)) {
+                break;
+            }
+            bool retry = false;
+            uint64_t ioBytes = Process(key, retry);
+            if (retry) {
+                Requeue(key, tracked);
+            }
+            m_tokens -= static_cast<double>(ioBytes);
+            processed++;
+        }
+
+        Clock::duration pause = PauseAfterSlice(Clock::now() - start);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.slices++;
+        m_pause = pause;
+        return processed;
+    }
+
+    void Start() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_thread.joinable()) {
+            return;
+        }
+        m_stopping = false;
+        m_thread = std::thread([this]() { WorkerLoop(); });
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cond.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    RecompressionStats GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RecompressionStats stats = m_stats;
+        stats.pending = m_tracked.size();
+        stats.pendingBytes = m_pendingBytes;
+        for (const auto& item : m_tracked) {
+            stats.pendingByLevel[item.second.level]++;
+        }
+        stats.abandonedKeys.assign(m_abandoned.begin(), m_abandoned.end());
+        return stats;
+    }
+
+private:
+    struct Tracked {
+        int level = 0;
+        uint64_t sequence = 0;
+        uint64_t size = 0;
+        unsigned attempts = 0;       // 连续冲突或失败的次数
+        bool deferred = false;       // 处于退避中，在 m_deferred 而不是 m_queue 中
+        Clock::time_point notBefore;
+    };
+
+    // 调用方需持有 m_mutex
+    void RemoveLocked(const std::string& key) {
+        auto it = m_tracked.find(key);
+        if (it == m_tracked.end()) {
+            return;
+        }
+        if (it->second.deferred) {
+            m_deferred.erase(std::make_pair(it->second.notBefore, key));
+        } else {
+            m_queue.erase(std::make_tuple(it->second.level, it->second.sequence, key));
+        }
+        m_pendingBytes -= it->second.size;
+        m_tracked.erase(it);
+    }
+
+    // 把退避已结束的对象移回待处理队列，返回是否有可处理的对象。调用方需持有 m_mutex
+    bool HasReadyLocked() {
+        Clock::time_point now = Clock::now();
+        while (!m_deferred.empty() && m_deferred.begin()->first <= now) {
+            Tracked& tracked = m_tracked[m_deferred.begin()->second];
+            tracked.deferred = false;
+            m_queue.emplace(tracked.level, tracked.sequence, m_deferred.begin()->second);
+            m_deferred.erase(m_deferred.begin());
+        }
+        return !m_queue.empty();
+    }
+
+    // 取出级别最低、登记最早的对象
+    bool PopNext(std::string& key, Tracked& tracked) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!HasReadyLocked()) {
+            return false;
+        }
+        key = std::get<2>(*m_queue.begin());
+        tracked = m_tracked[key];
+        RemoveLocked(key);
+        return true;
+    }
+
+    // 冲突或失败后退避重新排队；处理期间被重新 Track 时以新的登记为准
+    void Requeue(const std::string& key, Tracked tracked) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tracked.count(key) > 0) {
+            return;
+        }
+        tracked.attempts++;
+        if (tracked.attempts > m_options.maxRetries) {
+            m_abandoned.insert(key);
+            return;
+        }
+        unsigned shift = std::min(tracked.attempts - 1, 10u);
+        tracked.sequence = m_nextSequence++;
+        tracked.deferred = true;
+        tracked.notBefore = Clock::now() + std::chrono::milliseconds(uint64_t(m_options.retryBackoffMillis) << shift);
+        m_deferred.emplace(tracked.notBefore, key);
+        m_tracked.emplace(key, tracked);
+        m_pendingBytes += tracked.size;
+        m_stats.retries++;
+    }
+
+    // 重压缩一个对象，返回读取和写入的字节数；冲突或失败时 retry 置为 true
+    uint64_t Process(const std::string& key, bool& retry) {
+        std::vector<char> original;
+        uint64_t version = 0;
+        retry = true;
+        if (!m_store->Load(key, original, version)) {
+            CountFailure();
+            return 0;
+        }
+
+        std::vector<char> raw = DecompressAuto(original, m_options.algorithm);
+        if (raw.empty()) {
+            CountFailure();
+            return original.size();
+        }
+        std::vector<char> recompressed = Compress(raw, m_options.algorithm, m_options.targetLevel);
+        if (recompressed.empty()) {
+            CountFailure();
+            return original.size();
+        }
+
+        double limit = static_cast<double>(original.size()) * (1.0 - m_options.minSavingRatio);
+        if (static_cast<double>(recompressed.size()) > limit) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.skipped++;
+            retry = false;
+            return original.size();
+        }
+
+        ReplaceResult result = m_store->Replace(key, recompressed, version);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        switch (result) {
+            case ReplaceResult::Replaced:
+                retry = false;
+                m_stats.recompressed++;
+                m_stats.bytesBefore += original.size();
+                m_stats.bytesAfter += recompressed.size();
+                break;
+            case ReplaceResult::Conflict:
+                m_stats.conflicts++;
+                break;
+            default:
+                m_stats.failures++;
+                break;
+        }
+        return original.size() + recompressed.size();
+    }
+
+    void CountFailure() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.failures++;
+    }
+
+    // 令牌桶：按 ioBytesPerSecond 补充，最多积累 1 秒的额度
+    void RefillTokens() {
+        if (m_options.ioBytesPerSecond == 0) {
+            return;
+        }
+        Clock::time_point now = Clock::now();
+        double seconds = std::chrono::duration<double>(now - m_lastRefill).count();
+        double rate = static_cast<double>(m_options.ioBytesPerSecond);
+        m_tokens = std::min(rate, m_tokens + seconds * rate);
+        m_lastRefill = now;
+    }
+
+    // 下一个时间片之前需要休眠的时长：取 CPU 占用补偿和 I/O 欠额补偿中的较大值。调用方需持有 m_sliceMutex
+    Clock::duration PauseAfterSlice(Clock::duration sliceDuration) const {
+        Clock::duration pause = Clock::duration::zero();
+        double share = m_options.maxCpuShare;
+        if (share > 0 && share < 1) {
+            auto cpuPause = std::chrono::duration_cast<Clock::duration>(sliceDuration * ((1.0 - share) / share));
+            pause = std::max(pause, cpuPause);
+        }
+        if (m_options.ioBytesPerSecond > 0 && m_tokens < 0) {
+            double seconds = -m_tokens / static_cast<double>(m_options.ioBytesPerSecond);
+            pause = std::max(pause, std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+        }
+        return pause;
+    }
+
+    bool IsIdle() const {
+        return !m_options.isIdle || m_options.isIdle();
+    }
+
+    void WorkerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stopping) {
+            m_cond.wait_for(lock, std::chrono::milliseconds(m_options.idleCheckMillis),
+                            [this]() { return m_stopping; });
+            if (m_stopping || !HasReadyLocked()) {
+                continue;
+            }
+
+            lock.unlock();
+            // 空闲期间连续执行时间片，直到队列清空或不再空闲；只剩退避中的对象时等下一次检查
+            while (IsIdle()) {
+                size_t processed = RunSlice();
+                lock.lock();
+                bool done = m_stopping || !HasReadyLocked() || processed == 0;
+                if (!done) {
+                    m_cond.wait_for(lock, m_pause, [this]() { return m_stopping; });
+                    done = m_stopping;
+                }
+                lock.unlock();
+                if (done) {
+                    break;
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    std::shared_ptr<ObjectStore> m_store;
+    RecompressionOptions m_options;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::map<std::string, Tracked> m_tracked;
+    std::set<std::tuple<int, uint64_t, std::string>> m_queue;
+    std::set<std::pair<Clock::time_point, std::string>> m_deferred;
+    std::set<std::string> m_abandoned;
+    uint64_t m_nextSequence = 0;
+    uint64_t m_pendingBytes = 0;
+    RecompressionStats m_stats;
+    std::thread m_thread;
+    bool m_stopping = false;
+
+    std::mutex m_sliceMutex;
+    double m_tokens = 0;
+    Clock::time_point m_lastRefill;
+    Clock::duration m_pause = Clock::duration::zero();
+};
+
+RecompressionScheduler::RecompressionScheduler(std::shared_ptr<ObjectStore> store, const RecompressionOptions& options)
+    : m_impl(new Impl(std::move(store), options)) {}
+
+RecompressionScheduler::~RecompressionScheduler() = default;
+
+void RecompressionScheduler::Track(const std::string& key, int currentLevel, uint64_t storedSize) {
+    m_impl->Track(key, currentLevel, storedSize);
+}
+
+void RecompressionScheduler::Untrack(const std::string& key) {
+    m_impl->Untrack(key);
+}
+
+size_t RecompressionScheduler::RunSlice() {
+    return m_impl->RunSlice();
+}
+
+void RecompressionScheduler::Start() {
+    m_impl->Start();
+}
+
+void RecompressionScheduler::Stop() {
+    m_impl->Stop();
+}
+
+RecompressionStats RecompressionScheduler::GetStats() const {
+    return m_impl->GetStats();
+}
+
+} // namespace Utility::Compression
@@ -0,0 +1,49 @@
+#include "model/model_sample.h"
+
+// model_sample.h 中模型的 WCDB ORM 实现，wcdb_test / wcdb_bench / wcdb_perf 共用
+
+// 设置表wcdb宏
+WCDB_CPP_ORM_IMPLEMENTATION_BEGIN(ModelSample);
+WCDB_CPP_SYNTHESIZE(id);
+WCDB_CPP_SYNTHESIZE(name);
+WCDB_CPP_SYNTHESIZE(age);
+WCDB_CPP_SYNTHESIZE(email);
+WCDB_CPP_SYNTHESIZE(phone);
+WCDB_CPP_SYNTHESIZE(address);
+WCDB_CPP_SYNTHESIZE(city);
+WCDB_CPP_SYNTHESIZE(state);
+WCDB_CPP_SYNTHESIZE(country);
+WCDB_CPP_SYNTHESIZE(created_at);
+WCDB_CPP_SYNTHESIZE(updated_at);
+WCDB_CPP_SYNTHESIZE(add_1);
+
+WCDB_CPP_PRIMARY_AUTO_INCREMENT(id);
+// 按姓名查找、按城市查找并按创建时间排序、按创建时间范围查询
+WCDB_CPP_INDEX("_name_index", name);
+WCDB_CPP_INDEX("_city_created_at_index", city);
+WCDB_CPP_INDEX("_city_created_at_index", created_at);
+WCDB_CPP_INDEX("_created_at_index", created_at);
+WCDB_CPP_ORM_IMPLEMENTATION_END;
+
+// 客户端分配 ID 的版本：INTEGER PRIMARY KEY，不带 AUTOINCREMENT
+WCDB_CPP_ORM_IMPLEMENTATION_BEGIN(ModelSampleKeyed);
+WCDB_CPP_SYNTHESIZE(id);
+WCDB_CPP_SYNTHESIZE(name);
+WCDB_CPP_SYNTHESIZE(age);
+WCDB_CPP_SYNTHESIZE(email);
+WCDB_CPP_SYNTHESIZE(phone);
+WCDB_CPP_SYNTHESIZE(address);
+WCDB_CPP_SYNTHESIZE(city);
+WCDB_CPP_SYNTHESIZE(state);
+WCDB_CPP_SYNTHESIZE(country);
+WCDB_CPP_SYNTHESIZE(created_at);
+WCDB_CPP_SYNTHESIZE(updated_at);
+WCDB_CPP_SYNTHESIZE(add_1);
+
+WCDB_CPP_PRIMARY(id);
+// 与 ModelSample 相同的索引，两者只差在主键
+WCDB_CPP_INDEX("_name_index", name);
+WCDB_CPP_INDEX("_city_created_at_index", city);
+WCDB_CPP_INDEX("_city_created_at_index", created_at);
+WCDB_CPP_INDEX("_created_at_index", created_at);
+WCDB_CPP_ORM_IMPLEMENTATION_END;
@@ -0,0 +1,25 @@
+#include "model/model_sample_interned.h"
+
+// model_sample_interned.h 中模型的 WCDB ORM 实现，使用该模型的程序一同编译
+
+// city / state / country 驻留为字典编码，索引与 ModelSample 相同
+WCDB_CPP_ORM_IMPLEMENTATION_BEGIN(ModelSampleInterned);
+WCDB_CPP_SYNTHESIZE(id);
+WCDB_CPP_SYNTHESIZE(name);
+WCDB_CPP_SYNTHESIZE(age);
+WCDB_CPP_SYNTHESIZE(email);
+WCDB_CPP_SYNTHESIZE(phone);
+WCDB_CPP_SYNTHESIZE(address);
+WCDB_CPP_SYNTHESIZE(city);
+WCDB_CPP_SYNTHESIZE(state);
+WCDB_CPP_SYNTHESIZE(country);
+WCDB_CPP_SYNTHESIZE(created_at);
+WCDB_CPP_SYNTHESIZE(updated_at);
+WCDB_CPP_SYNTHESIZE(add_1);
+
+WCDB_CPP_PRIMARY_AUTO_INCREMENT(id);
+WCDB_CPP_INDEX("_name_index", name);
+WCDB_CPP_INDEX("_city_created_at_index", city);
+WCDB_CPP_INDEX("_city_created_at_index", created_at);
+WCDB_CPP_INDEX("_created_at_index", created_at);
+WCDB_CPP_ORM_IMPLEMENTATION_END;
@@ -0,0 +1,1707 @@
+#include "spdlog/spdlog.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "model/model_sample.h"
+#include "model/model_sample_interned.h"
+#include "Storage/Storage.h"
+#include "Utility/Aggregate.h"
+#include <sys/resource.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::string appname = "wcdb_bench";
+
+// 设置spdlog参数配置
+void initlog()
+{
+    auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    console_sink->set_level(spdlog::level::info);
+
+    auto logger = std::make_shared<spdlog::logger>(appname, console_sink);
+    logger->set_level(spdlog::level::info);
+    logger->set_pattern("wcdb_bench: [%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+
+    spdlog::set_default_logger(logger);
+}
+
+/**
+ * @brief 单项测试结果
+ */
+struct BenchResult {
+    std::string name;
+    size_t ops = 0;
+    double seconds = 0;
+
+    double NanosPerOp() const { return ops > 0 ? seconds * 1e9 / ops : 0; }
+    double OpsPerSecond() const { return seconds > 0 ? ops / seconds : 0; }
+};
+
+std::vector<BenchResult> g_results;
+
+/**
+ * @brief 计时执行 fn 并记录结果
+ * @param name 测试项名称
+ * @param ops fn 内执行的操作数
+ */
+template<typename Fn>
+void measure(const std::string &name, size_t ops, Fn &&fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool ok = fn();
+    auto end = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    result.name = name;
+    result.ops = ops;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    if (!ok) {
+        SPDLOG_ERROR("{} 执行失败", name);
+    }
+    SPDLOG_INFO("{:<40} {:>8} ops {:>12.0f} ns/op {:>12.0f} ops/s",
+                result.name, result.ops, result.NanosPerOp(), result.OpsPerSecond());
+    g_results.push_back(result);
+}
+
+// 2026-01-01 00:00:00 UTC
+const int64_t kSampleEpochMillis = 1767225600000;
+
+ModelSample makeSample(int i)
+{
+    ModelSample model;
+    model.id = 0;
+    model.isAutoIncrement = true;
+    model.name = "John Doe " + std::to_string(i);
+    model.age = i % 100;
+    model.email = "john.doe@example.com " + std::to_string(i);
+    model.phone = "1234567890 " + std::to_string(i);
+    model.address = "No. " + std::to_string(i) + " Example Road";
+    model.city = "City " + std::to_string(i % 50);
+    model.state = "State " + std::to_string(i % 10);
+    model.country = "Country";
+    model.created_at = kSampleEpochMillis;
+    model.updated_at = kSampleEpochMillis;
+    model.add_1 = "add_1_ " + std::to_string(i);
+    return model;
+}
+
+/**
+ * @brief 进程的峰值常驻内存（KB）
+ */
+long peakRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief 进程内 operator new 的调用次数，用于统计每行的堆分配
+ */
+std::atomic<uint64_t> g_allocations(0);
+
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+ModelSampleKeyed makeKeyedSample(int i)
+{
+    ModelSample model = makeSample(i);
+    ModelSampleKeyed keyed;
+    keyed.id = 0;
+    keyed.name = model.name;
+    keyed.age = model.age;
+    keyed.email = model.email;
+    keyed.phone = model.phone;
+    keyed.address = model.address;
+    keyed.city = model.city;
+    keyed.state = model.state;
+    keyed.country = model.country;
+    keyed.created_at = model.created_at;
+    keyed.updated_at = model.updated_at;
+    keyed.add_1 = model.add_1;
+    return keyed;
+}
+
+bool resetTable(WCDB::Database &db)
+{
+    return db.dropTable(TABLE_NAME_SAMPLE) && db.createTable<ModelSample>(TABLE_NAME_SAMPLE);
+}
+
+/**
+ * @brief Database 通用 ORM 接口与 Storage::Repository 的对比
+ *
+ * 单行操作都放在一个事务内执行，以排除每次提交的 fsync 开销，只比较语句构造、prepare 和绑定的差异。
+ */
+void benchRepository(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Repository vs Database ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+
+    std::vector<ModelSample> models;
+    models.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        models.push_back(makeSample(i));
+    }
+
+    // 插入
+    resetTable(db);
+    measure("Database::insertObjects (per row)", rows, [&]() {
+        return db.runTransaction([&](WCDB::Handle &) {
+            for (const ModelSample &model : models) {
+                if (!db.insertObjects<ModelSample>(model, TABLE_NAME_SAMPLE)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+    resetTable(db);
+    measure("Database::insertObjects (batch)", rows, [&]() {
+        return db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    });
+
+    resetTable(db);
+    {
+        Storage::Repository<ModelSample> repo(db, TABLE_NAME_SAMPLE, idField);
+        measure("Repository::Insert (per row)", rows, [&]() {
+            return repo.RunTransaction([&]() {
+                for (const ModelSample &model : models) {
+                    if (!repo.Insert(model)) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        });
+    }
+    resetTable(db);
+    Storage::Repository<ModelSample> repo(db, TABLE_NAME_SAMPLE, idField);
+    measure("Repository::InsertBatch", rows, [&]() {
+        return repo.InsertBatch(models);
+    });
+
+    // 按主键查询
+    measure("Database::getFirstObject", rows, [&]() {
+        for (int i = 1; i <= rows; i++) {
+            if (!db.getFirstObject<ModelSample>(TABLE_NAME_SAMPLE, idField == i).hasValue()) {
+                return false;
+            }
+        }
+        return true;
+    });
+    measure("Repository::Get", rows, [&]() {
+        for (int i = 1; i <= rows; i++) {
+            if (!repo.Get(i).hasValue()) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    // 按主键更新
+    measure("Database::updateObject", rows, [&]() {
+        return db.runTransaction([&](WCDB::Handle &) {
+            for (int i = 1; i <= rows; i++) {
+                if (!db.updateObject(models[i - 1], ModelSample::allFields(), TABLE_NAME_SAMPLE, idField == i)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+    measure("Repository::Update", rows, [&]() {
+        return repo.RunTransaction([&]() {
+            for (int i = 1; i <= rows; i++) {
+                if (!repo.Update(models[i - 1], i)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+
+    // 按主键删除，各删除一半
+    int half = rows / 2;
+    measure("Database::deleteObjects", half, [&]() {
+        return db.runTransaction([&](WCDB::Handle &) {
+            for (int i = 1; i <= half; i++) {
+                if (!db.deleteObjects(TABLE_NAME_SAMPLE, idField == i)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+    measure("Repository::Remove", rows - half, [&]() {
+        return repo.RunTransaction([&]() {
+            for (int i = half + 1; i <= rows; i++) {
+                if (!repo.Remove(i)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+}
+
+/**
+ * @brief getAllObjects 与流式游标的全表遍历对比
+ *
+ * 峰值内存只增不减，因此先跑游标再跑 getAllObjects，分别记录跑完后的峰值。
+ */
+void benchCursor(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Cursor vs getAllObjects ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+
+    resetTable(db);
+    {
+        std::vector<ModelSample> models;
+        models.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            models.push_back(makeSample(i));
+        }
+        db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    }
+
+    long baseRss = peakRssKb();
+    WCDB::Handle handle = db.getHandle();
+    int64_t ageSum = 0;
+    measure("Cursor (full scan)", rows, [&]() {
+        Storage::Cursor<ModelSample> cursor(handle, TABLE_NAME_SAMPLE);
+        while (cursor.Next()) {
+            ageSum += cursor.Current().age;
+        }
+        return !cursor.Failed() && cursor.Position() == (uint64_t) rows;
+    });
+    measure("KeysetCursor (page 1000)", rows, [&]() {
+        Storage::KeysetCursor<ModelSample> cursor(handle, TABLE_NAME_SAMPLE, idField, 1000);
+        while (cursor.Next()) {
+            ageSum += cursor.Current().age;
+        }
+        return !cursor.Failed() && cursor.Position() == (uint64_t) rows;
+    });
+    handle.invalidate();
+    long cursorRss = peakRssKb();
+
+    measure("Database::getAllObjects", rows, [&]() {
+        auto all = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE);
+        if (!all.hasValue()) {
+            return false;
+        }
+        for (const ModelSample &model : all.value()) {
+            ageSum += model.age;
+        }
+        return all.value().size() == (size_t) rows;
+    });
+    long allRss = peakRssKb();
+
+    SPDLOG_INFO("峰值内存增长: 游标 {} KB, getAllObjects {} KB (checksum {})",
+                cursorRss - baseRss, allRss - cursorRss, ageSum);
+}
+
+/**
+ * @brief 宽行表上全列读取与列投影的对比
+ *
+ * 每行的 7 个文本列各约 200 字节，只读取 id 和 name 两列。
+ */
+void benchProjection(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Projection on wide rows ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+    auto nameField = WCDB_FIELD(ModelSample::name);
+
+    resetTable(db);
+    {
+        std::string padding(200, 'x');
+        std::vector<ModelSample> models;
+        models.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            ModelSample model = makeSample(i);
+            model.email += padding;
+            model.phone += padding;
+            model.address += padding;
+            model.city += padding;
+            model.state += padding;
+            model.country += padding;
+            model.add_1 += padding;
+            models.push_back(model);
+        }
+        db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    }
+
+    size_t nameBytes = 0;
+    measure("Database::getAllObjects", rows, [&]() {
+        auto all = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE);
+        if (!all.hasValue()) {
+            return false;
+        }
+        for (const ModelSample &model : all.value()) {
+            nameBytes += model.name.size();
+        }
+        return true;
+    });
+    measure("Database::getAllObjectsWithFields", rows, [&]() {
+        auto all = db.getAllObjectsWithFields<ModelSample>(TABLE_NAME_SAMPLE, { idField, nameField });
+        if (!all.hasValue()) {
+            return false;
+        }
+        for (const ModelSample &model : all.value()) {
+            nameBytes += model.name.size();
+        }
+        return true;
+    });
+
+    WCDB::Handle handle = db.getHandle();
+    measure("Cursor (all fields)", rows, [&]() {
+        Storage::Cursor<ModelSample> cursor(handle, TABLE_NAME_SAMPLE);
+        while (cursor.Next()) {
+            nameBytes += cursor.Current().name.size();
+        }
+        return !cursor.Failed();
+    });
+    measure("Cursor (id, name)", rows, [&]() {
+        WCDB::ResultFields fields = { idField, nameField };
+        Storage::Cursor<ModelSample> cursor(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, fields), fields);
+        while (cursor.Next()) {
+            nameBytes += cursor.Current().name.size();
+        }
+        return !cursor.Failed();
+    });
+    measure("TupleCursor<int64_t, string>", rows, [&]() {
+        Storage::TupleCursor<int64_t, std::string> cursor(
+        handle, Storage::SelectFields(TABLE_NAME_SAMPLE, { idField, nameField }));
+        while (cursor.Next()) {
+            nameBytes += std::get<1>(cursor.Current()).size();
+        }
+        return !cursor.Failed();
+    });
+    handle.invalidate();
+    SPDLOG_INFO("checksum {}", nameBytes);
+}
+
+/**
+ * @brief 多线程逐条写入：每条一个事务 vs WriteBehindQueue 合并提交
+ *
+ * 逐条事务每次提交都要 fsync，行数取 rows 和 2000 中较小者，避免耗时过长。
+ */
+void benchWriteBehind(WCDB::Database &db, int rows)
+{
+    const int producers = 4;
+    int total = std::min(rows, 2000);
+    int perThread = total / producers;
+    total = perThread * producers;
+    SPDLOG_INFO("---- WriteBehindQueue vs per-row transactions ({} rows, {} threads) ----", total, producers);
+
+    auto runProducers = [&](const std::function<bool(const ModelSample &)> &write) {
+        std::atomic<bool> ok(true);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < producers; t++) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < perThread; i++) {
+                    if (!write(makeSample(t * perThread + i))) {
+                        ok = false;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        return ok.load();
+    };
+
+    resetTable(db);
+    measure("Database::insertObjects (per row txn)", total, [&]() {
+        return runProducers([&](const ModelSample &model) {
+            return db.insertObjects<ModelSample>(model, TABLE_NAME_SAMPLE);
+        });
+    });
+
+    resetTable(db);
+    std::atomic<int> durable(0);
+    Storage::WriteBehindQueue queue(db);
+    measure("WriteBehindQueue (submit + flush)", total, [&]() {
+        bool ok = runProducers([&](const ModelSample &model) {
+            return queue.InsertObject(model, TABLE_NAME_SAMPLE, [&](bool committed) {
+                if (committed) {
+                    durable++;
+                }
+            });
+        });
+        return queue.Flush() && ok;
+    });
+    Storage::WriteBehindStats stats = queue.GetStats();
+    SPDLOG_INFO("已提交 {} 条, 事务 {} 个, 队列峰值 {}, 持久化回调 {} 次",
+                stats.committed, stats.transactions, stats.maxPending, durable.load());
+}
+
+/**
+ * @brief AUTOINCREMENT 与客户端分配 ID 的批量插入对比
+ *
+ * 客户端分配 ID 的计时包含生成 ID 的时间。
+ */
+void benchClientId(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Client-generated IDs vs AUTOINCREMENT ({} rows) ----", rows);
+
+    std::vector<ModelSample> models;
+    std::vector<ModelSampleKeyed> keyedModels;
+    models.reserve(rows);
+    keyedModels.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        models.push_back(makeSample(i));
+        keyedModels.push_back(makeKeyedSample(i));
+    }
+    auto resetKeyedTable = [&]() {
+        return db.dropTable(TABLE_NAME_SAMPLE_KEYED)
+               && db.createTable<ModelSampleKeyed>(TABLE_NAME_SAMPLE_KEYED);
+    };
+
+    resetTable(db);
+    measure("insertObjects AUTOINCREMENT", rows, [&]() {
+        return db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    });
+    resetKeyedTable();
+    measure("insertObjects client id", rows, [&]() {
+        Storage::AssignIds(keyedModels, &ModelSampleKeyed::id);
+        return db.insertObjects<ModelSampleKeyed>(keyedModels, TABLE_NAME_SAMPLE_KEYED);
+    });
+
+    resetTable(db);
+    {
+        Storage::Repository<ModelSample> repo(db, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id));
+        measure("Repository::InsertBatch AUTOINCREMENT", rows, [&]() {
+            return repo.InsertBatch(models);
+        });
+    }
+    resetKeyedTable();
+    {
+        Storage::Repository<ModelSampleKeyed> repo(db, TABLE_NAME_SAMPLE_KEYED, WCDB_FIELD(ModelSampleKeyed::id));
+        measure("Repository::InsertBatch client id", rows, [&]() {
+            Storage::AssignIds(keyedModels, &ModelSampleKeyed::id);
+            return repo.InsertBatch(keyedModels);
+        });
+    }
+    db.dropTable(TABLE_NAME_SAMPLE_KEYED);
+}
+
+/**
+ * @brief ModelSample 的编译期字段列表，顺序与 ORM 声明一致
+ */
+using ModelSampleFields = Storage::StaticFieldList<
+    STORAGE_FIELD(ModelSample, id),
+    STORAGE_FIELD(ModelSample, name),
+    STORAGE_FIELD(ModelSample, age),
+    STORAGE_FIELD(ModelSample, email),
+    STORAGE_FIELD(ModelSample, phone),
+    STORAGE_FIELD(ModelSample, address),
+    STORAGE_FIELD(ModelSample, city),
+    STORAGE_FIELD(ModelSample, state),
+    STORAGE_FIELD(ModelSample, country),
+    STORAGE_FIELD(ModelSample, created_at),
+    STORAGE_FIELD(ModelSample, updated_at),
+    STORAGE_FIELD(ModelSample, add_1)>;
+
+/**
+ * @brief 通用 ORM 绑定与编译期字段绑定的对比
+ *
+ * 两者使用相同的预编译语句，差别只在每列的绑定和读取方式。
+ */
+void benchStaticBinding(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Static binding vs ORM accessors ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+
+    std::vector<ModelSample> models;
+    models.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        models.push_back(makeSample(i));
+    }
+
+    resetTable(db);
+    {
+        Storage::Repository<ModelSample> repo(db, TABLE_NAME_SAMPLE, idField);
+        measure("Repository::InsertBatch (ORM)", rows, [&]() {
+            return repo.InsertBatch(models);
+        });
+    }
+    resetTable(db);
+    Storage::Repository<ModelSample, ModelSampleFields> repo(db, TABLE_NAME_SAMPLE, idField);
+    measure("Repository::InsertBatch (static)", rows, [&]() {
+        return repo.InsertBatch(models);
+    });
+
+    measure("Repository::Update (ORM)", rows, [&]() {
+        Storage::Repository<ModelSample> ormRepo(db, TABLE_NAME_SAMPLE, idField);
+        return ormRepo.RunTransaction([&]() {
+            for (int i = 1; i <= rows; i++) {
+                if (!ormRepo.Update(models[i - 1], i)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+    measure("Repository::Update (static)", rows, [&]() {
+        return repo.RunTransaction([&]() {
+            for (int i = 1; i <= rows; i++) {
+                if (!repo.Update(models[i - 1], i)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+
+    int64_t ageSum = 0;
+    WCDB::Handle &handle = repo.GetHandle();
+    measure("Cursor full scan (ORM)", rows, [&]() {
+        Storage::Cursor<ModelSample> cursor(handle, TABLE_NAME_SAMPLE);
+        while (cursor.Next()) {
+            ageSum += cursor.Current().age;
+        }
+        return !cursor.Failed() && cursor.Position() == (uint64_t) rows;
+    });
+    measure("Cursor full scan (static)", rows, [&]() {
+        Storage::Cursor<ModelSample, ModelSampleFields> cursor(handle, TABLE_NAME_SAMPLE);
+        while (cursor.Next()) {
+            ageSum += cursor.Current().age;
+        }
+        return !cursor.Failed() && cursor.Position() == (uint64_t) rows;
+    });
+    SPDLOG_INFO("checksum {}", ageSum);
+}
+
+/**
+ * @brief 扫描聚合：物化对象与零拷贝行视图的对比
+ *
+ * 每行读取 age、city 和 address 三列，统计 age 之和、文本字节数和 city 前缀命中数，
+ * 同时记录每行的堆分配次数。文本列超过短字符串优化的长度。
+ */
+void benchRowView(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Row views vs materialized objects ({} rows) ----", rows);
+    auto ageField = WCDB_FIELD(ModelSample::age);
+    auto cityField = WCDB_FIELD(ModelSample::city);
+    auto addressField = WCDB_FIELD(ModelSample::address);
+
+    resetTable(db);
+    {
+        std::string padding(32, 'x');
+        std::vector<ModelSample> models;
+        models.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            ModelSample model = makeSample(i);
+            model.city += padding;
+            model.address += padding;
+            models.push_back(model);
+        }
+        db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    }
+
+    struct Aggregate {
+        int64_t ageSum = 0;
+        size_t textBytes = 0;
+        size_t matched = 0;
+    } aggregate;
+    const std::string prefix = "City 1";
+    auto reportAllocations = [&](const char *name, uint64_t before) {
+        SPDLOG_INFO("{:<40} {:>8.2f} allocs/row", name, (double) (g_allocations.load() - before) / rows);
+    };
+
+    WCDB::Handle handle = db.getHandle();
+    WCDB::ResultFields fields = { ageField, cityField, addressField };
+    uint64_t before = g_allocations.load();
+    measure("Cursor<ModelSample> (3 fields)", rows, [&]() {
+        Storage::Cursor<ModelSample> cursor(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, fields), fields);
+        while (cursor.Next()) {
+            const ModelSample &model = cursor.Current();
+            aggregate.ageSum += model.age;
+            aggregate.textBytes += model.city.size() + model.address.size();
+            aggregate.matched += model.city.compare(0, prefix.size(), prefix) == 0 ? 1 : 0;
+        }
+        return !cursor.Failed();
+    });
+    reportAllocations("Cursor<ModelSample> (3 fields)", before);
+
+    before = g_allocations.load();
+    measure("TupleCursor<int, string, string>", rows, [&]() {
+        Storage::TupleCursor<int, std::string, std::string> cursor(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, fields));
+        while (cursor.Next()) {
+            aggregate.ageSum += std::get<0>(cursor.Current());
+            const std::string &city = std::get<1>(cursor.Current());
+            aggregate.textBytes += city.size() + std::get<2>(cursor.Current()).size();
+            aggregate.matched += city.compare(0, prefix.size(), prefix) == 0 ? 1 : 0;
+        }
+        return !cursor.Failed();
+    });
+    reportAllocations("TupleCursor<int, string, string>", before);
+
+    before = g_allocations.load();
+    measure("RowCursor (views)", rows, [&]() {
+        Storage::RowCursor cursor(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, fields));
+        while (cursor.Next()) {
+            Storage::RowView row = cursor.Current();
+            WCDB::UnsafeStringView city = row.GetText(1);
+            aggregate.ageSum += row.GetInteger(0);
+            aggregate.textBytes += city.length() + row.GetText(2).length();
+            aggregate.matched += city.hasPrefix(prefix) ? 1 : 0;
+        }
+        return !cursor.Failed();
+    });
+    reportAllocations("RowCursor (views)", before);
+    handle.invalidate();
+
+    SPDLOG_INFO("checksum {} {} {}", aggregate.ageSum, aggregate.textBytes, aggregate.matched);
+}
+
+/**
+ * @brief 数值列聚合：行对象遍历与列式批量读取 + 向量化聚合的对比
+ *
+ * 统计 age 的 sum / min / max 以及 [18, 65] 区间内的行数。
+ * 前三项包含读取数据库的时间；后两项只计聚合本身，数据已在内存中。
+ */
+void benchColumnar(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Columnar batches + vector aggregates ({} rows, {}) ----", rows, Utility::Aggregate::Backend());
+    auto ageField = WCDB_FIELD(ModelSample::age);
+
+    resetTable(db);
+    {
+        std::vector<ModelSample> models;
+        models.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            models.push_back(makeSample(i));
+        }
+        db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    }
+
+    Utility::Aggregate::Summary<int64_t> expected;
+    size_t expectedInRange = 0;
+    auto accumulate = [](Utility::Aggregate::Summary<int64_t> &summary, int64_t age) {
+        summary.min = summary.count == 0 ? age : std::min(summary.min, age);
+        summary.max = summary.count == 0 ? age : std::max(summary.max, age);
+        summary.sum += age;
+        ++summary.count;
+    };
+    auto matches = [&](const Utility::Aggregate::Summary<int64_t> &summary, size_t inRange) {
+        return summary.sum == expected.sum && summary.min == expected.min && summary.max == expected.max
+               && summary.count == expected.count && inRange == expectedInRange;
+    };
+
+    WCDB::Handle handle = db.getHandle();
+    std::vector<ModelSample> objects;
+    measure("getAllObjects + loop", rows, [&]() {
+        auto all = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE);
+        if (!all.hasValue()) {
+            return false;
+        }
+        objects = std::move(all.value());
+        for (const ModelSample &model : objects) {
+            accumulate(expected, model.age);
+            expectedInRange += (model.age >= 18 && model.age <= 65) ? 1 : 0;
+        }
+        return true;
+    });
+    double rowSeconds = g_results.back().seconds;
+
+    measure("Cursor<ModelSample> + loop", rows, [&]() {
+        Utility::Aggregate::Summary<int64_t> summary;
+        size_t inRange = 0;
+        Storage::Cursor<ModelSample> cursor(handle, TABLE_NAME_SAMPLE);
+        while (cursor.Next()) {
+            accumulate(summary, cursor.Current().age);
+            inRange += (cursor.Current().age >= 18 && cursor.Current().age <= 65) ? 1 : 0;
+        }
+        return !cursor.Failed() && matches(summary, inRange);
+    });
+
+    measure("ColumnarCursor + Aggregate", rows, [&]() {
+        Utility::Aggregate::Summary<int64_t> summary;
+        size_t inRange = 0;
+        Storage::ColumnarCursor cursor(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, { ageField }),
+                                       { Storage::ColumnKind::Integer });
+        while (cursor.NextBatch()) {
+            const Storage::ColumnBatch &batch = cursor.Batch();
+            auto part = Utility::Aggregate::Summarize(batch.Integers(0), batch.RowCount());
+            summary.min = summary.count == 0 ? part.min : std::min(summary.min, part.min);
+            summary.max = summary.count == 0 ? part.max : std::max(summary.max, part.max);
+            summary.sum += part.sum;
+            summary.count += part.count;
+            inRange += Utility::Aggregate::CountInRange(batch.Integers(0), batch.RowCount(), 18, 65);
+        }
+        return !cursor.Failed() && matches(summary, inRange);
+    });
+    SPDLOG_INFO("列式读取相对 getAllObjects 提速 {:.2f}x", rowSeconds / g_results.back().seconds);
+
+    // 只比较聚合：对象数组逐个取字段 vs 连续 int64_t 数组
+    auto columns = Storage::ReadColumns(handle, Storage::SelectFields(TABLE_NAME_SAMPLE, { ageField }),
+                                        { Storage::ColumnKind::Integer });
+    handle.invalidate();
+    if (!columns.hasValue()) {
+        SPDLOG_ERROR("ReadColumns 失败");
+        return;
+    }
+    const int repeat = 100;
+    measure("aggregate vector<ModelSample> x100", (size_t) rows * repeat, [&]() {
+        bool ok = true;
+        for (int r = 0; r < repeat; r++) {
+            Utility::Aggregate::Summary<int64_t> summary;
+            size_t inRange = 0;
+            for (const ModelSample &model : objects) {
+                accumulate(summary, model.age);
+                inRange += (model.age >= 18 && model.age <= 65) ? 1 : 0;
+            }
+            ok = ok && matches(summary, inRange);
+        }
+        return ok;
+    });
+    double objectSeconds = g_results.back().seconds;
+    measure("aggregate int64 column x100", (size_t) rows * repeat, [&]() {
+        const Storage::ColumnBatch &batch = columns.value();
+        bool ok = true;
+        for (int r = 0; r < repeat; r++) {
+            auto summary = Utility::Aggregate::Summarize(batch.Integers(0), batch.RowCount());
+            size_t inRange = Utility::Aggregate::CountInRange(batch.Integers(0), batch.RowCount(), 18, 65);
+            ok = ok && matches(summary, inRange);
+        }
+        return ok;
+    });
+    SPDLOG_INFO("列式聚合相对对象遍历提速 {:.2f}x", objectSeconds / g_results.back().seconds);
+}
+
+/**
+ * @brief 有无索引时热点查询的对比
+ *
+ * 先按 ORM 声明的索引建表并检查执行计划，再删除索引重复同样的查询。
+ * 默认行数下差距不明显，建议用 wcdb_bench 1000000 测试接近真实规模的表。
+ */
+void benchIndexes(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Indexed vs unindexed lookups ({} rows) ----", rows);
+    auto name = WCDB_FIELD(ModelSample::name);
+    auto city = WCDB_FIELD(ModelSample::city);
+    auto createdAt = WCDB_FIELD(ModelSample::created_at);
+
+    resetTable(db);
+    {
+        std::vector<ModelSample> models;
+        models.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            ModelSample model = makeSample(i);
+            model.created_at = kSampleEpochMillis + (int64_t) i * 60000;
+            models.push_back(model);
+        }
+        db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    }
+
+    WCDB::StatementSelect byName = WCDB::StatementSelect().select(ModelSample::allFields())
+                                   .from(TABLE_NAME_SAMPLE).where(name == WCDB::BindParameter(1));
+    WCDB::StatementSelect byCity = WCDB::StatementSelect().select(ModelSample::allFields())
+                                   .from(TABLE_NAME_SAMPLE).where(city == WCDB::BindParameter(1))
+                                   .order(createdAt.asOrder(WCDB::Order::DESC)).limit(20);
+    WCDB::StatementSelect inRange = WCDB::StatementSelect().select(ModelSample::allFields())
+                                    .from(TABLE_NAME_SAMPLE)
+                                    .where(Storage::TimeRangeParameters(createdAt));
+    Storage::QueryPlanChecker checker;
+    checker.Register("by name", byName);
+    checker.Register("by city, newest 20", byCity);
+    checker.Register("created_at range", inRange);
+
+    const int lookups = std::min(rows, 1000);
+    // 每次范围查询约 60 行（1 小时）
+    const int window = 60;
+    WCDB::Handle handle = db.getHandle();
+    auto run = [&](const std::string &label) {
+        for (const Storage::PlanReport &report : checker.Check(handle)) {
+            SPDLOG_INFO("{}", report.Describe());
+        }
+        measure("lookup by name (" + label + ")", lookups, [&]() {
+            for (int i = 0; i < lookups; i++) {
+                int row = (int) ((int64_t) i * 7919 % rows);
+                Storage::Cursor<ModelSample> cursor(handle, byName);
+                cursor.Bind(makeSample(row).name, 1);
+                if (!cursor.Next()) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        measure("city newest 20 (" + label + ")", lookups, [&]() {
+            for (int i = 0; i < lookups; i++) {
+                std::string value = "City " + std::to_string(i % 50);
+                Storage::Cursor<ModelSample> cursor(handle, byCity);
+                cursor.Bind(value, 1);
+                while (cursor.Next()) {
+                }
+                if (cursor.Failed()) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        measure("created_at 1h range (" + label + ")", lookups, [&]() {
+            for (int i = 0; i < lookups; i++) {
+                int start = (int) ((int64_t) i * 7919 % rows);
+                Storage::Cursor<ModelSample> cursor(handle, inRange);
+                cursor.Bind(kSampleEpochMillis + (int64_t) start * 60000, 1);
+                cursor.Bind(kSampleEpochMillis + (int64_t) (start + window) * 60000, 2);
+                while (cursor.Next()) {
+                }
+                if (cursor.Failed()) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    };
+
+    run("indexed");
+    for (const char *suffix : { "_name_index", "_city_created_at_index", "_created_at_index" }) {
+        handle.execute(WCDB::StatementDropIndex().dropIndex(TABLE_NAME_SAMPLE + suffix).ifExists());
+    }
+    run("no index");
+    handle.invalidate();
+}
+
+/**
+ * @brief 文本时间与整数毫秒的时间范围查询对比
+ *
+ * 先按旧版本的表结构（created_at / updated_at 为 TEXT）建表并写入，测文本时间上的查询；
+ * 再用 MigrateTextTimestamps 迁移为整数毫秒，测同样的查询。两种情况下 created_at 上都有索引。
+ */
+void benchTimestamps(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- TEXT vs INTEGER timestamps ({} rows) ----", rows);
+    WCDB::Column id("id");
+    WCDB::Column name("name");
+    WCDB::Column createdAt("created_at");
+    WCDB::Column updatedAt("updated_at");
+
+    // 旧表结构
+    db.dropTable(TABLE_NAME_SAMPLE);
+    WCDB::Handle handle = db.getHandle();
+    WCDB::StatementCreateTable create;
+    create.createTable(TABLE_NAME_SAMPLE)
+    .define(WCDB::ColumnDef(id, WCDB::ColumnType::Integer).constraint(WCDB::ColumnConstraint().primaryKey().autoIncrement()))
+    .define(WCDB::ColumnDef(name, WCDB::ColumnType::Text))
+    .define(WCDB::ColumnDef(createdAt, WCDB::ColumnType::Text))
+    .define(WCDB::ColumnDef(updatedAt, WCDB::ColumnType::Text));
+    WCDB::StatementCreateIndex index;
+    index.createIndex(TABLE_NAME_SAMPLE + "_created_at_index").table(TABLE_NAME_SAMPLE).indexed(createdAt);
+    if (!handle.execute(create) || !handle.execute(index)) {
+        SPDLOG_ERROR("创建旧表结构失败");
+        handle.invalidate();
+        return;
+    }
+    handle.runTransaction([&](WCDB::Handle &) {
+        WCDB::StatementInsert insert;
+        insert.insertIntoTable(TABLE_NAME_SAMPLE).columns({ id, name, createdAt, updatedAt })
+        .values(WCDB::BindParameter::bindParameters(4));
+        auto prepared = handle.getOrCreatePreparedStatement(insert);
+        if (!prepared.hasValue()) {
+            return false;
+        }
+        WCDB::PreparedStatement &statement = prepared.value();
+        for (int i = 0; i < rows; i++) {
+            std::string text = Storage::FormatTimestamp(kSampleEpochMillis + (int64_t) i * 60000, false);
+            std::string sampleName = "John Doe " + std::to_string(i);
+            statement.reset();
+            statement.bindInteger(i + 1, 1);
+            statement.bindText(WCDB::UnsafeStringView(sampleName), 2);
+            statement.bindText(WCDB::UnsafeStringView(text), 3);
+            statement.bindText(WCDB::UnsafeStringView(text), 4);
+            if (!statement.step()) {
+                return false;
+            }
+        }
+        statement.reset();
+        return true;
+    });
+
+    // 每次范围查询约 60 行（1 小时），最新 20 条取某个时间点之前的
+    const int lookups = std::min(rows, 1000);
+    const int window = 60;
+    WCDB::StatementSelect countRange = WCDB::StatementSelect().select(id.count()).from(TABLE_NAME_SAMPLE)
+                                       .where(createdAt >= WCDB::BindParameter(1) && createdAt < WCDB::BindParameter(2));
+    WCDB::StatementSelect newestBefore = WCDB::StatementSelect().select({ id, createdAt }).from(TABLE_NAME_SAMPLE)
+                                         .where(createdAt < WCDB::BindParameter(1))
+                                         .order(createdAt.asOrder(WCDB::Order::DESC)).limit(20);
+    auto run = [&](const std::string &label, const std::function<WCDB::Value(int64_t)> &toValue) {
+        int64_t matched = 0;
+        measure("count 1h range (" + label + ")", lookups, [&]() {
+            auto prepared = handle.getOrCreatePreparedStatement(countRange);
+            if (!prepared.hasValue()) {
+                return false;
+            }
+            WCDB::PreparedStatement &statement = prepared.value();
+            for (int i = 0; i < lookups; i++) {
+                int64_t start = kSampleEpochMillis + (int64_t) i * 7919 % rows * 60000;
+                statement.reset();
+                statement.bindValue(toValue(start), 1);
+                statement.bindValue(toValue(start + window * 60000), 2);
+                if (!statement.step()) {
+                    return false;
+                }
+                matched += statement.getInteger(0);
+            }
+            statement.reset();
+            return true;
+        });
+        measure("newest 20 before (" + label + ")", lookups, [&]() {
+            auto prepared = handle.getOrCreatePreparedStatement(newestBefore);
+            if (!prepared.hasValue()) {
+                return false;
+            }
+            WCDB::PreparedStatement &statement = prepared.value();
+            for (int i = 0; i < lookups; i++) {
+                statement.reset();
+                statement.bindValue(toValue(kSampleEpochMillis + (int64_t) i * 7919 % rows * 60000), 1);
+                while (statement.step() && !statement.done()) {
+                    ++matched;
+                }
+            }
+            statement.reset();
+            return true;
+        });
+        SPDLOG_INFO("checksum {}", matched);
+    };
+
+    run("TEXT", [](int64_t millis) { return WCDB::Value(Storage::FormatTimestamp(millis, false)); });
+
+    measure("MigrateTextTimestamps", rows, [&]() {
+        return Storage::MigrateTextTimestamps<ModelSample>(handle, TABLE_NAME_SAMPLE, { "created_at", "updated_at" });
+    });
+    auto first = db.getFirstObject<ModelSample>(TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id) == 1);
+    if (!first.hasValue() || first.value().created_at != kSampleEpochMillis) {
+        SPDLOG_ERROR("迁移后的时间不正确");
+    }
+
+    run("INTEGER", [](int64_t millis) { return WCDB::Value(millis); });
+    handle.invalidate();
+}
+
+/**
+ * @brief 已使用的页数（总页数减去空闲页），用于比较写入前后的空间占用
+ */
+int64_t usedPages(WCDB::Database &db)
+{
+    auto pages = db.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::pageCount()));
+    auto freePages = db.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::freelistCount()));
+    if (!pages.hasValue() || !freePages.hasValue()) {
+        return 0;
+    }
+    return pages.value().intValue() - freePages.value().intValue();
+}
+
+/**
+ * @brief 低基数字符串列：TEXT 与字典编码的对比
+ *
+ * city / state / country 分别有 50 / 10 / 1 个取值，取值带填充以超过短字符串优化的长度。
+ * 比较写入、空间占用（表与索引的页数）和全表读取时每行的堆分配。
+ */
+void benchInterning(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Interned strings vs TEXT columns ({} rows) ----", rows);
+    const std::string padding(24, 'x');
+    Storage::StringDictionary &dictionary = Storage::StringDictionary::Shared();
+    if (!dictionary.Attach(db)) {
+        SPDLOG_ERROR("字典表附着失败");
+        return;
+    }
+
+    std::vector<ModelSample> models;
+    models.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        ModelSample model = makeSample(i);
+        model.city += padding;
+        model.state += padding;
+        model.country += padding;
+        models.push_back(model);
+    }
+
+    auto pageSize = db.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::pageSize()));
+    int64_t bytesPerPage = pageSize.hasValue() ? pageSize.value().intValue() : 4096;
+    auto reportSize = [&](const char *name, int64_t pages) {
+        SPDLOG_INFO("{:<40} {:>8} pages {:>10.1f} KB", name, pages, pages * bytesPerPage / 1024.0);
+    };
+    auto reportAllocations = [&](const char *name, uint64_t before) {
+        SPDLOG_INFO("{:<40} {:>8.2f} allocs/row", name, (double) (g_allocations.load() - before) / rows);
+    };
+
+    db.dropTable(TABLE_NAME_SAMPLE_INTERNED);
+    resetTable(db);
+    int64_t pages = usedPages(db);
+    measure("insert TEXT columns", rows, [&]() {
+        return db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    });
+    reportSize("size TEXT columns", usedPages(db) - pages);
+
+    db.createTable<ModelSampleInterned>(TABLE_NAME_SAMPLE_INTERNED);
+    pages = usedPages(db);
+    measure("intern + insert interned columns", rows, [&]() {
+        std::vector<ModelSampleInterned> interned(models.size());
+        for (size_t i = 0; i < models.size(); i++) {
+            const ModelSample &model = models[i];
+            ModelSampleInterned &target = interned[i];
+            auto city = dictionary.Intern(model.city);
+            auto state = dictionary.Intern(model.state);
+            auto country = dictionary.Intern(model.country);
+            if (!city.hasValue() || !state.hasValue() || !country.hasValue()) {
+                return false;
+            }
+            target.id = 0;
+            target.isAutoIncrement = true;
+            target.name = model.name;
+            target.age = model.age;
+            target.email = model.email;
+            target.phone = model.phone;
+            target.address = model.address;
+            target.city = city.value();
+            target.state = state.value();
+            target.country = country.value();
+            target.created_at = model.created_at;
+            target.updated_at = model.updated_at;
+            target.add_1 = model.add_1;
+        }
+        return db.insertObjects<ModelSampleInterned>(interned, TABLE_NAME_SAMPLE_INTERNED);
+    });
+    reportSize("size interned columns", usedPages(db) - pages);
+    SPDLOG_INFO("dictionary entries {}", dictionary.Size());
+
+    size_t textBytes = 0;
+    uint64_t before = g_allocations.load();
+    measure("getAllObjects<ModelSample>", rows, [&]() {
+        auto objects = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE);
+        for (const ModelSample &model : objects.value()) {
+            textBytes += model.city.size() + model.state.size() + model.country.size();
+        }
+        return objects.hasValue();
+    });
+    reportAllocations("getAllObjects<ModelSample>", before);
+
+    before = g_allocations.load();
+    measure("getAllObjects<ModelSampleInterned>", rows, [&]() {
+        auto objects = db.getAllObjects<ModelSampleInterned>(TABLE_NAME_SAMPLE_INTERNED);
+        for (const ModelSampleInterned &model : objects.value()) {
+            textBytes += model.city.Str().size() + model.state.Str().size() + model.country.Str().size();
+        }
+        return objects.hasValue();
+    });
+    reportAllocations("getAllObjects<ModelSampleInterned>", before);
+
+    auto first = db.getFirstObject<ModelSampleInterned>(TABLE_NAME_SAMPLE_INTERNED,
+                                                        WCDB_FIELD(ModelSampleInterned::id) == 1);
+    if (!first.hasValue() || first.value().city != models[0].city) {
+        SPDLOG_ERROR("驻留字段读回的值不正确");
+    }
+    SPDLOG_INFO("checksum {}", textBytes);
+}
+
+/**
+ * @brief 按时间清理：单表 DELETE 与按天分区 DROP TABLE 的对比
+ *
+ * 数据均匀分布在 30 天内，清理前 20 天的数据，再查询最后 3 天。
+ */
+void benchPartitions(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Time partitions vs DELETE retention ({} rows) ----", rows);
+    const int64_t span = 30 * Storage::Detail::kMillisPerDay;
+    const int64_t cutoff = kSampleEpochMillis + 20 * Storage::Detail::kMillisPerDay;
+    const int64_t queryFrom = kSampleEpochMillis + 27 * Storage::Detail::kMillisPerDay;
+    const int64_t queryTo = kSampleEpochMillis + span;
+    auto createdAt = WCDB_FIELD(ModelSample::created_at);
+
+    std::vector<ModelSample> models;
+    models.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        ModelSample model = makeSample(i);
+        model.created_at = kSampleEpochMillis + span * i / rows;
+        model.updated_at = model.created_at;
+        models.push_back(model);
+    }
+
+    resetTable(db);
+    db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+    measure("DELETE WHERE created_at < cutoff", rows, [&]() {
+        return db.deleteObjects(TABLE_NAME_SAMPLE, createdAt < cutoff);
+    });
+    size_t expected = 0;
+    measure("single table range query", 1, [&]() {
+        auto objects = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE,
+                                                     Storage::TimeRange(createdAt, queryFrom, queryTo));
+        expected = objects.hasValue() ? objects.value().size() : 0;
+        return objects.hasValue();
+    });
+
+    Storage::PartitionedTable<ModelSample> partitions(db, TABLE_NAME_SAMPLE, &ModelSample::created_at, createdAt,
+                                                      Storage::PartitionGranularity::Day);
+    partitions.DropBefore(INT64_MAX);
+    measure("partitioned InsertBatch", rows, [&]() {
+        return partitions.InsertBatch(models);
+    });
+    auto created = partitions.ListPartitions();
+    SPDLOG_INFO("partitions {}", created.hasValue() ? created.value().size() : 0);
+
+    WCDB::Optional<size_t> dropped;
+    measure("DropBefore(cutoff)", rows, [&]() {
+        dropped = partitions.DropBefore(cutoff);
+        return dropped.hasValue();
+    });
+    SPDLOG_INFO("dropped partitions {}", dropped.hasValue() ? dropped.value() : 0);
+
+    measure("partition fan-out range query", 1, [&]() {
+        auto objects = partitions.Query(queryFrom, queryTo);
+        if (!objects.hasValue() || objects.value().size() != expected) {
+            SPDLOG_ERROR("分区查询结果数不一致");
+            return false;
+        }
+        return true;
+    });
+
+    const std::string view = TABLE_NAME_SAMPLE + "_all";
+    measure("EnableView + view range query", 1, [&]() {
+        if (!partitions.EnableView(view)) {
+            return false;
+        }
+        auto objects = db.getAllObjects<ModelSample>(view, Storage::TimeRange(createdAt, queryFrom, queryTo));
+        return objects.hasValue() && objects.value().size() == expected;
+    });
+
+    partitions.DropBefore(INT64_MAX);
+    db.execute(WCDB::StatementDropView().dropView(view).ifExists());
+}
+
+/**
+ * @brief 每秒一点的遥测：一行一个采样与压缩块存储的对比
+ *
+ * 4 个序列，每个序列 rows * 10 个点，数值为缓慢变化的一位小数。
+ * 比较写入、空间占用（表与索引的页数）和查询一小时数据的耗时。
+ */
+void benchTimeSeries(WCDB::Database &db, int rows)
+{
+    const int seriesCount = 4;
+    const int points = rows * 10;
+    SPDLOG_INFO("---- Compressed time series vs row per sample ({} x {} points) ----", seriesCount, points);
+    const std::string rowTable = "telemetry_rows";
+    const int64_t hour = 3600 * 1000;
+    const int64_t queryFrom = kSampleEpochMillis + (int64_t) points * 1000 / 2;
+    auto seriesName = [](int s) { return "sensor." + std::to_string(s); };
+    auto valueAt = [](int s, int i) { return std::round((40 + s + 5 * std::sin(i / 300.0)) * 10) / 10; };
+
+    auto pageSize = db.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::pageSize()));
+    int64_t bytesPerPage = pageSize.hasValue() ? pageSize.value().intValue() : 4096;
+    auto reportSize = [&](const char *name, int64_t pages) {
+        SPDLOG_INFO("{:<40} {:>8} pages {:>10.1f} KB {:>8.2f} B/point", name, pages, pages * bytesPerPage / 1024.0,
+                    (double) pages * bytesPerPage / ((double) seriesCount * points));
+    };
+
+    WCDB::Column series("series");
+    WCDB::Column timestamp("timestamp");
+    WCDB::Column value("value");
+    db.execute(WCDB::StatementDropTable().dropTable(rowTable).ifExists());
+    db.execute(WCDB::StatementCreateTable().createTable(rowTable)
+               .define(WCDB::ColumnDef(series, WCDB::ColumnType::Text))
+               .define(WCDB::ColumnDef(timestamp, WCDB::ColumnType::Integer))
+               .define(WCDB::ColumnDef(value, WCDB::ColumnType::Float)));
+    db.execute(WCDB::StatementCreateIndex().createIndex(rowTable + "_series_timestamp_index").table(rowTable)
+               .indexed(series).indexed(timestamp));
+
+    int64_t pages = usedPages(db);
+    measure("row per sample insert", (size_t) seriesCount * points, [&]() {
+        return db.runTransaction([&](WCDB::Handle &handle) {
+            WCDB::StatementInsert insert;
+            insert.insertIntoTable(rowTable).columns({ series, timestamp, value }).values(WCDB::BindParameter::bindParameters(3));
+            if (!handle.prepare(insert)) {
+                return false;
+            }
+            for (int s = 0; s < seriesCount; s++) {
+                std::string name = seriesName(s);
+                for (int i = 0; i < points; i++) {
+                    handle.reset();
+                    handle.bindText(WCDB::UnsafeStringView(name), 1);
+                    handle.bindInteger(kSampleEpochMillis + (int64_t) i * 1000, 2);
+                    handle.bindDouble(valueAt(s, i), 3);
+                    if (!handle.step()) {
+                        handle.finalize();
+                        return false;
+                    }
+                }
+            }
+            handle.finalize();
+            return true;
+        });
+    });
+    reportSize("size row per sample", usedPages(db) - pages);
+
+    size_t expected = 0;
+    measure("row per sample 1h query", 1, [&]() {
+        auto rowsInRange = db.getAllRowsFromStatement(WCDB::StatementSelect().select({ timestamp, value }).from(rowTable)
+                                                      .where(series == seriesName(0) && timestamp >= queryFrom
+                                                             && timestamp < queryFrom + hour));
+        expected = rowsInRange.hasValue() ? rowsInRange.value().size() : 0;
+        return rowsInRange.hasValue();
+    });
+    db.execute(WCDB::StatementDropTable().dropTable(rowTable));
+
+    Storage::TimeSeriesOptions options;
+    options.table = "telemetry_blocks";
+    db.execute(WCDB::StatementDropTable().dropTable(options.table).ifExists());
+    pages = usedPages(db);
+    {
+        Storage::TimeSeriesStore store(db, options);
+        measure("TimeSeriesStore append + flush", (size_t) seriesCount * points, [&]() {
+            std::vector<Storage::TimeSeriesPoint> batch(points);
+            for (int s = 0; s < seriesCount; s++) {
+                for (int i = 0; i < points; i++) {
+                    batch[i].timestamp = kSampleEpochMillis + (int64_t) i * 1000;
+                    batch[i].value = valueAt(s, i);
+                }
+                if (!store.AppendBatch(seriesName(s), batch)) {
+                    return false;
+                }
+            }
+            return store.Flush();
+        });
+        reportSize("size TimeSeriesStore", usedPages(db) - pages);
+        Storage::TimeSeriesStats stats = store.GetStats();
+        SPDLOG_INFO("blocks {} encoded {} KB compressed {} KB", stats.sealedBlocks, stats.encodedBytes / 1024,
+                    stats.storedBytes / 1024);
+
+        measure("TimeSeriesStore 1h query", 1, [&]() {
+            auto result = store.Query(seriesName(0), queryFrom, queryFrom + hour);
+            if (!result.hasValue() || result.value().size() != expected) {
+                SPDLOG_ERROR("时序查询结果数不一致");
+                return false;
+            }
+            return true;
+        });
+        measure("TimeSeriesStore summarize all", 1, [&]() {
+            auto summary = store.Summarize(seriesName(0), kSampleEpochMillis, kSampleEpochMillis + (int64_t) points * 1000);
+            return summary.hasValue() && summary.value().count == (size_t) points;
+        });
+    }
+    db.execute(WCDB::StatementDropTable().dropTable(options.table));
+}
+
+/**
+ * @brief 按周看板查询：原始表 GROUP BY 与 1 小时汇总表的对比
+ *
+ * 数据均匀分布在 7 天内，按城市分组汇总 age。比较全量 Refresh、查询一周逐小时数据的耗时，
+ * 以及追加少量行后增量 Refresh 读取的行数。
+ */
+void benchRollup(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Rollup tables vs raw GROUP BY ({} rows) ----", rows);
+    const int64_t hour = 3600 * 1000;
+    const int64_t week = 7 * Storage::Detail::kMillisPerDay;
+    const std::string city = "City 0";
+    auto createdAt = WCDB_FIELD(ModelSample::created_at);
+    auto age = WCDB_FIELD(ModelSample::age);
+
+    std::vector<ModelSample> models;
+    models.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        ModelSample model = makeSample(i);
+        model.created_at = kSampleEpochMillis + week * i / rows;
+        model.updated_at = model.created_at;
+        models.push_back(model);
+    }
+
+    resetTable(db);
+    Storage::RollupSource source;
+    source.table = TABLE_NAME_SAMPLE;
+    source.timeColumn = "created_at";
+    source.valueColumn = "age";
+    source.keyColumn = "city";
+    Storage::RollupEngine rollup(db, source);
+    for (size_t level = 0; level < rollup.Levels().size(); level++) {
+        db.execute(WCDB::StatementDelete().deleteFrom(rollup.LevelTable(level)));
+    }
+
+    measure("RollupEngine::InsertObjects", rows, [&]() {
+        return rollup.InsertObjects(models, &ModelSample::created_at);
+    });
+    measure("Refresh (full)", rows, [&]() {
+        return rollup.Refresh();
+    });
+    SPDLOG_INFO("full refresh read {} rows", rollup.LastRefreshRows());
+
+    size_t expectedBuckets = 0;
+    int64_t expectedCount = 0;
+    measure("raw GROUP BY week @ 1h", 1, [&]() {
+        WCDB::Expression bucket = createdAt / hour;
+        auto result = db.getAllRowsFromStatement(WCDB::StatementSelect()
+                                                 .select({ bucket, age.count(), age.sum(), age.min(), age.max() })
+                                                 .from(TABLE_NAME_SAMPLE)
+                                                 .where(WCDB_FIELD(ModelSample::city) == city
+                                                        && Storage::TimeRange(createdAt, kSampleEpochMillis,
+                                                                              kSampleEpochMillis + week))
+                                                 .group(bucket));
+        if (!result.hasValue()) {
+            return false;
+        }
+        expectedBuckets = result.value().size();
+        for (const auto &row : result.value()) {
+            expectedCount += row[1].intValue();
+        }
+        return true;
+    });
+
+    measure("RollupEngine::Query week @ 1h", 1, [&]() {
+        auto result = rollup.Query(city, kSampleEpochMillis, kSampleEpochMillis + week, hour);
+        if (!result.hasValue()) {
+            return false;
+        }
+        int64_t count = 0;
+        for (const Storage::RollupBucket &bucket : result.value()) {
+            count += (int64_t) bucket.count;
+        }
+        if (result.value().size() != expectedBuckets || count != expectedCount) {
+            SPDLOG_ERROR("汇总查询结果与原始表不一致");
+            return false;
+        }
+        return true;
+    });
+
+    // 分辨率不是汇总级别桶宽的整数倍时逐桶对比：90 分钟不能由 1 小时桶合并，20 分钟不能由 15 分钟桶合并
+    for (int64_t resolution : { 90 * 60 * 1000LL, 20 * 60 * 1000LL }) {
+        std::string label = "RollupEngine::Query week @ " + std::to_string(resolution / 60000) + "m";
+        measure(label, 1, [&]() {
+            WCDB::Expression bucket = createdAt / resolution;
+            auto expected = db.getAllRowsFromStatement(WCDB::StatementSelect()
+                                                       .select({ bucket, age.count(), age.sum(), age.min(), age.max() })
+                                                       .from(TABLE_NAME_SAMPLE)
+                                                       .where(WCDB_FIELD(ModelSample::city) == city
+                                                              && Storage::TimeRange(createdAt, kSampleEpochMillis,
+                                                                                    kSampleEpochMillis + week))
+                                                       .group(bucket));
+            auto result = rollup.Query(city, kSampleEpochMillis, kSampleEpochMillis + week, resolution);
+            if (!expected.hasValue() || !result.hasValue()) {
+                return false;
+            }
+            std::map<int64_t, const Storage::RollupBucket *> actual;
+            for (const Storage::RollupBucket &item : result.value()) {
+                actual[item.start] = &item;
+            }
+            bool same = expected.value().size() == actual.size();
+            for (size_t i = 0; same && i < expected.value().size(); i++) {
+                const auto &row = expected.value()[i];
+                auto found = actual.find(row[0].intValue() * resolution);
+                same = found != actual.end() && (int64_t) found->second->count == row[1].intValue()
+                       && found->second->sum == row[2].floatValue() && found->second->min == row[3].floatValue()
+                       && found->second->max == row[4].floatValue();
+            }
+            if (!same) {
+                SPDLOG_ERROR("{} 分钟分辨率的汇总查询结果与原始表不一致", resolution / 60000);
+            }
+            return same;
+        });
+    }
+
+    std::vector<ModelSample> late;
+    for (int i = 0; i < std::max(rows / 100, 1); i++) {
+        ModelSample model = makeSample(i);
+        model.created_at = kSampleEpochMillis + week + i;
+        model.updated_at = model.created_at;
+        late.push_back(model);
+    }
+    rollup.InsertObjects(late, &ModelSample::created_at);
+    measure("Refresh (incremental)", late.size(), [&]() {
+        return rollup.Refresh();
+    });
+    SPDLOG_INFO("incremental refresh read {} rows", rollup.LastRefreshRows());
+
+    for (size_t level = 0; level < rollup.Levels().size(); level++) {
+        db.execute(WCDB::StatementDropTable().dropTable(rollup.LevelTable(level)).ifExists());
+    }
+}
+
+/**
+ * @brief 调优配置矩阵：每个内置配置在独立的新数据库文件上测试写入和查询
+ *
+ * 写入按每 100 行一个事务提交，使 synchronous 与检查点阈值的差异体现在提交开销上；
+ * 查询包括按主键随机读取和一次全表扫描。
+ */
+void benchProfiles(const std::string &basePath, int rows)
+{
+    SPDLOG_INFO("---- Tuning profiles ({} rows) ----", rows);
+    const int perTransaction = 100;
+    auto idField = WCDB_FIELD(ModelSample::id);
+
+    std::vector<ModelSample> models;
+    models.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        models.push_back(makeSample(i));
+    }
+
+    for (const std::string &name : Storage::ProfileNames()) {
+        WCDB::Database db(basePath + "." + name);
+        db.removeFiles();
+        if (!Storage::ApplyProfile(db, name) || !db.createTable<ModelSample>(TABLE_NAME_SAMPLE)) {
+            SPDLOG_ERROR("{} 配置应用失败", name);
+            continue;
+        }
+        WCDB::Handle handle = db.getHandle();
+        SPDLOG_INFO("{}", Storage::DescribeTuning(Storage::ReadTuning(handle)));
+        handle.invalidate();
+
+        measure(name + " insert (100 rows/txn)", rows, [&]() {
+            for (int begin = 0; begin < rows; begin += perTransaction) {
+                auto first = models.begin() + begin;
+                auto last = models.begin() + std::min(begin + perTransaction, rows);
+                if (!db.insertObjects<ModelSample>(std::vector<ModelSample>(first, last), TABLE_NAME_SAMPLE)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        measure(name + " get by id", rows, [&]() {
+            for (int i = 0; i < rows; i++) {
+                int64_t id = 1 + (int64_t) i * 7919 % rows;
+                if (!db.getFirstObject<ModelSample>(TABLE_NAME_SAMPLE, idField == id).hasValue()) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        measure(name + " full scan", rows, [&]() {
+            auto objects = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE);
+            return objects.hasValue() && objects.value().size() == (size_t) rows;
+        });
+
+        Storage::RemoveProfile(db);
+        db.close();
+        db.removeFiles();
+    }
+}
+
+/**
+ * @brief 检查点对提交延迟的影响：WCDB 自动检查点与空闲时调度的对比
+ *
+ * 写入分成 20 段，每段逐行提交后暂停 20 ms 模拟写入间隙，记录每次提交耗时的 p99 和最大值。
+ */
+void benchCheckpoint(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Checkpoint scheduling vs auto-checkpoint ({} rows) ----", rows);
+    const int bursts = 20;
+
+    auto run = [&](const std::string &name) {
+        resetTable(db);
+        db.truncateCheckpoint();
+        std::vector<double> latencies;
+        latencies.reserve(rows);
+        measure(name + " single-row commits", rows, [&]() {
+            for (int burst = 0; burst < bursts; burst++) {
+                for (int i = burst * rows / bursts; i < (burst + 1) * rows / bursts; i++) {
+                    auto start = std::chrono::steady_clock::now();
+                    if (!db.insertObjects<ModelSample>(makeSample(i), TABLE_NAME_SAMPLE)) {
+                        return false;
+                    }
+                    latencies.push_back(std::chrono::duration<double, std::micro>(
+                                        std::chrono::steady_clock::now() - start).count());
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            return true;
+        });
+        std::sort(latencies.begin(), latencies.end());
+        if (!latencies.empty()) {
+            SPDLOG_INFO("{} commit p50 {:.0f} us p99 {:.0f} us max {:.0f} us", name, latencies[latencies.size() / 2],
+                        latencies[latencies.size() * 99 / 100], latencies.back());
+        }
+    };
+
+    run("auto-checkpoint");
+
+    Storage::CheckpointOptions options;
+    options.idleMillis = 10;
+    Storage::CheckpointScheduler scheduler(db, options);
+    run("CheckpointScheduler");
+    scheduler.Stop();
+    Storage::CheckpointStats stats = scheduler.GetStats();
+    SPDLOG_INFO("passive {} truncate {} incomplete {} deferred {} frames {} avg {:.2f} ms max {:.2f} ms",
+                stats.passiveCheckpoints, stats.truncateCheckpoints, stats.incomplete, stats.budgetDeferrals,
+                stats.checkpointedFrames,
+                stats.passiveCheckpoints + stats.truncateCheckpoints > 0
+                ? stats.totalDurationMillis / (stats.passiveCheckpoints + stats.truncateCheckpoints) : 0.0,
+                stats.maxDurationMillis);
+    SPDLOG_INFO("WAL peak {} KB growth {:.1f} KB/s", stats.peakWalBytes / 1024, stats.walGrowthBytesPerSecond / 1024);
+}
+
+/**
+ * @brief 删除后的空间回收：整库 VACUUM 与空闲时分片 incremental_vacuum 的对比
+ *
+ * 两个新数据库写入相同的数据后删除 80% 的行。整库 VACUUM 的耗时即阻塞读写的时长；
+ * 分片回收关注单片的最长耗时，以及回收结束后的页数。
+ */
+void benchReclaim(const std::string &basePath, int rows)
+{
+    SPDLOG_INFO("---- Incremental reclaim vs full VACUUM ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+    std::vector<ModelSample> models;
+    models.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        models.push_back(makeSample(i));
+    }
+    auto fill = [&](WCDB::Database &target) {
+        return target.createTable<ModelSample>(TABLE_NAME_SAMPLE)
+               && target.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE)
+               && target.deleteObjects(TABLE_NAME_SAMPLE, idField % 5 != 0);
+    };
+
+    {
+        WCDB::Database full(basePath + ".vacuum");
+        full.removeFiles();
+        fill(full);
+        int64_t before = usedPages(full);
+        measure("Database::vacuum (blocking)", 1, [&]() {
+            return full.vacuum(nullptr);
+        });
+        auto pageCount = full.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::pageCount()));
+        SPDLOG_INFO("vacuum used pages {} -> file pages {}", before,
+                    pageCount.hasValue() ? pageCount.value().intValue() : 0);
+        full.close();
+        full.removeFiles();
+    }
+
+    WCDB::Database incremental(basePath + ".incremental");
+    incremental.removeFiles();
+    Storage::ReclaimOptions options;
+    options.pollIntervalMillis = 20;
+    options.idleMillis = 50;
+    options.minFreeBytes = 0;
+    Storage::SpaceReclaimer reclaimer(incremental, options);
+    fill(incremental);
+    reclaimer.Refresh();
+    Storage::ReclaimStats stats = reclaimer.GetStats();
+    SPDLOG_INFO("incremental {} pages {} free {} ({:.0f}%) reclaimable {} KB", stats.incremental, stats.pageCount,
+                stats.freelistCount, stats.freelistRatio * 100, stats.reclaimableBytes / 1024);
+
+    measure("SpaceReclaimer idle reclaim", 1, [&]() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            Storage::ReclaimStats current = reclaimer.GetStats();
+            if (current.slices > 0 && current.freelistRatio < options.minFreelistRatio) {
+                return true;
+            }
+        }
+        return false;
+    });
+    reclaimer.Stop();
+    stats = reclaimer.GetStats();
+    SPDLOG_INFO("slices {} reclaimed {} pages, file pages {}, max slice {:.2f} ms", stats.slices,
+                stats.reclaimedPages, stats.pageCount, stats.maxSliceMillis);
+    incremental.close();
+    incremental.removeFiles();
+}
+
+/**
+ * @brief SQL 追踪的开销：同一组插入和按主键查询在关闭与开启追踪时的耗时
+ */
+void benchSqlTrace(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- SQL trace overhead ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+    auto workload = [&]() {
+        resetTable(db);
+        bool inserted = db.runTransaction([&](WCDB::Handle &) {
+            for (int i = 0; i < rows; i++) {
+                if (!db.insertObjects<ModelSample>(makeSample(i), TABLE_NAME_SAMPLE)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        if (!inserted) {
+            return false;
+        }
+        for (int i = 1; i <= rows; i++) {
+            if (!db.getFirstObject<ModelSample>(TABLE_NAME_SAMPLE, idField == i).hasValue()) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    measure("workload without trace", (size_t) rows * 2, workload);
+
+    Storage::SqlTraceOptions options;
+    options.slowQueryMicros = 50 * 1000;
+    Storage::StartSqlTrace(options);
+    Storage::ResetSqlTrace();
+    measure("workload with SqlTrace", (size_t) rows * 2, workload);
+    Storage::StopSqlTrace();
+
+    Storage::SqlTraceSnapshot snapshot = Storage::GetSqlTraceSnapshot();
+    uint64_t calls = 0;
+    for (const Storage::SqlTraceEntry &entry : snapshot.entries) {
+        calls += entry.calls;
+    }
+    SPDLOG_INFO("fingerprints {} calls {} json {} bytes", snapshot.entries.size(), calls, snapshot.ToJson().size());
+    Storage::LogSqlTrace(5);
+}
+
+int main(int argc, char *argv[])
+{
+    initlog();
+
+    int rows = argc > 1 ? std::atoi(argv[1]) : 10000;
+    std::string path = argc > 2 ? argv[2] : "./bench.db";
+    if (rows <= 0) {
+        SPDLOG_ERROR("用法: wcdb_bench [rows] [db_path]");
+        return -1;
+    }
+
+    WCDB::Database db(path);
+    db.removeFiles();
+
+    benchRepository(db, rows);
+    benchCursor(db, rows);
+    benchProjection(db, rows);
+    benchWriteBehind(db, rows);
+    benchClientId(db, rows);
+    benchStaticBinding(db, rows);
+    benchRowView(db, rows);
+    benchColumnar(db, rows);
+    benchIndexes(db, rows);
+    benchTimestamps(db, rows);
+    benchInterning(db, rows);
+    benchPartitions(db, rows);
+    benchTimeSeries(db, rows);
+    benchRollup(db, rows);
+    benchCheckpoint(db, rows);
+    benchSqlTrace(db, rows);
+    benchProfiles(path, rows);
+    benchReclaim(path, rows);
+
+    db.close();
+    db.removeFiles();
+    return 0;
+}
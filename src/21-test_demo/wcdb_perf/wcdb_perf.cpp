@@ -0,0 +1,595 @@
+#include "spdlog/spdlog.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "nlohmann/json.hpp"
+#include "model/model_sample.h"
+#include <sys/utsname.h>
+#include <algorithm>
+#include <cctype>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::string appname = "wcdb_perf";
+
+// 设置spdlog参数配置
+void initlog()
+{
+    auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    console_sink->set_level(spdlog::level::info);
+
+    auto logger = std::make_shared<spdlog::logger>(appname, console_sink);
+    logger->set_level(spdlog::level::info);
+    logger->set_pattern("wcdb_perf: [%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+
+    spdlog::set_default_logger(logger);
+}
+
+using Clock = std::chrono::steady_clock;
+
+// 2026-01-01 00:00:00 UTC
+const int64_t kSampleEpochMillis = 1767225600000;
+
+// 逐行提交的用例每次都要 fsync，操作数单独设上限，避免慢盘上耗时过长
+const int kMaxCommitOps = 1000;
+
+// 插入与查询用到的列，不含自增主键
+const std::vector<std::string> kSampleColumns = { "name", "age", "email", "phone", "address", "city",
+                                                  "state", "country", "created_at", "updated_at", "add_1" };
+
+ModelSample makeSample(int i)
+{
+    ModelSample model;
+    model.id = 0;
+    model.isAutoIncrement = true;
+    model.name = "John Doe " + std::to_string(i);
+    model.age = i % 100;
+    model.email = "john.doe@example.com " + std::to_string(i);
+    model.phone = "1234567890 " + std::to_string(i);
+    model.address = "No. " + std::to_string(i) + " Example Road";
+    model.city = "City " + std::to_string(i % 50);
+    model.state = "State " + std::to_string(i % 10);
+    model.country = "Country";
+    // 每行间隔一秒，按 created_at 的范围查询可以精确控制命中行数
+    model.created_at = kSampleEpochMillis + (int64_t) i * 1000;
+    model.updated_at = model.created_at;
+    model.add_1 = "add_1_ " + std::to_string(i);
+    return model;
+}
+
+std::vector<ModelSample> makeSamples(int begin, int end)
+{
+    std::vector<ModelSample> models;
+    models.reserve(end > begin ? end - begin : 0);
+    for (int i = begin; i < end; i++) {
+        models.push_back(makeSample(i));
+    }
+    return models;
+}
+
+bool resetTable(WCDB::Database &db)
+{
+    return db.dropTable(TABLE_NAME_SAMPLE) && db.createTable<ModelSample>(TABLE_NAME_SAMPLE);
+}
+
+double microsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * @brief 单项测试结果
+ */
+struct PerfResult {
+    std::string suite;
+    std::string name;
+    nlohmann::json params = nlohmann::json::object();
+    size_t ops = 0;
+    double seconds = 0;
+    bool ok = true;
+    std::vector<double> latencies;   // 逐次记录的耗时（微秒），只测总耗时的用例为空
+
+    double OpsPerSecond() const { return seconds > 0 ? ops / seconds : 0; }
+    double NanosPerOp() const { return ops > 0 ? seconds * 1e9 / ops : 0; }
+
+    // 调用前 latencies 须已排序
+    double PercentileMicros(double percentile) const
+    {
+        if (latencies.empty()) {
+            return 0;
+        }
+        size_t index = (size_t) (percentile * (latencies.size() - 1));
+        return latencies[std::min(index, latencies.size() - 1)];
+    }
+};
+
+std::vector<PerfResult> g_results;
+
+void report(PerfResult result)
+{
+    if (!result.ok) {
+        SPDLOG_ERROR("{} / {} 执行失败", result.suite, result.name);
+    }
+    std::sort(result.latencies.begin(), result.latencies.end());
+    if (result.latencies.empty()) {
+        SPDLOG_INFO("{:<44} {:>8} ops {:>12.0f} ns/op {:>12.0f} ops/s",
+                    result.name, result.ops, result.NanosPerOp(), result.OpsPerSecond());
+    } else {
+        SPDLOG_INFO("{:<44} {:>8} ops {:>12.0f} ops/s p50 {:>8.1f} us p99 {:>8.1f} us max {:>8.1f} us",
+                    result.name, result.ops, result.OpsPerSecond(), result.PercentileMicros(0.5),
+                    result.PercentileMicros(0.99), result.latencies.back());
+    }
+    g_results.push_back(std::move(result));
+}
+
+/**
+ * @brief 计时执行 fn 并记录结果
+ * @param ops fn 内执行的操作数
+ */
+template<typename Fn>
+void measure(const std::string &suite, const std::string &name, const nlohmann::json &params, size_t ops, Fn &&fn)
+{
+    PerfResult result;
+    result.suite = suite;
+    result.name = name;
+    result.params = params;
+    result.ops = ops;
+    auto start = Clock::now();
+    result.ok = fn();
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report(std::move(result));
+}
+
+/**
+ * @brief 计时执行 ops 次 fn(i)，同时记录每次的耗时
+ */
+template<typename Fn>
+void measureEach(const std::string &suite, const std::string &name, const nlohmann::json &params, size_t ops, Fn &&fn)
+{
+    PerfResult result;
+    result.suite = suite;
+    result.name = name;
+    result.params = params;
+    result.ops = ops;
+    result.latencies.reserve(ops);
+    auto start = Clock::now();
+    for (size_t i = 0; i < ops && result.ok; i++) {
+        auto opStart = Clock::now();
+        result.ok = fn(i);
+        result.latencies.push_back(microsSince(opStart));
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report(std::move(result));
+}
+
+/**
+ * @brief 插入吞吐与每次 insertObjects 的行数（每次调用是一个隐式事务）
+ */
+void benchBatchSizes(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Insert throughput vs batch size ({} rows) ----", rows);
+    for (int batch : { 1, 10, 100, 1000 }) {
+        if (batch > rows) {
+            continue;
+        }
+        int ops = batch == 1 ? std::min(rows, kMaxCommitOps) : rows;
+        std::vector<ModelSample> models = makeSamples(0, ops);
+        resetTable(db);
+        measure("batch", "insertObjects batch=" + std::to_string(batch), { { "batch_rows", batch } }, ops, [&]() {
+            for (int begin = 0; begin < ops; begin += batch) {
+                std::vector<ModelSample> slice(models.begin() + begin, models.begin() + std::min(begin + batch, ops));
+                if (!db.insertObjects<ModelSample>(slice, TABLE_NAME_SAMPLE)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+}
+
+/**
+ * @brief 插入吞吐与事务大小、日志模式：逐行 insertObjects，每 txn 行放进一个显式事务
+ *
+ * 每种日志模式使用一个新数据库文件；非 WAL 模式通过低优先级的配置在 WCDB 的默认配置之后设置。
+ */
+void benchTransactionSizes(const std::string &dir, int rows)
+{
+    SPDLOG_INFO("---- Insert throughput vs transaction size and journal mode ({} rows) ----", rows);
+    for (const std::string mode : { "WAL", "DELETE", "TRUNCATE" }) {
+        WCDB::Database db(dir + "/wcdb_perf_journal_" + mode + ".db");
+        db.removeFiles();
+        if (mode != "WAL") {
+            db.setConfig("perf_journal_mode", [mode](WCDB::Handle &handle) {
+                return handle.execute(WCDB::StatementPragma().pragma(WCDB::Pragma::journalMode()).to(mode));
+            }, nullptr, WCDB::Database::Priority::Low);
+        }
+        if (!db.createTable<ModelSample>(TABLE_NAME_SAMPLE)) {
+            SPDLOG_ERROR("{} 建表失败", mode);
+            continue;
+        }
+        auto journal = db.getValueFromStatement(WCDB::StatementPragma().pragma(WCDB::Pragma::journalMode()));
+        std::string effective = "unknown";
+        if (journal.hasValue()) {
+            WCDB::StringView text = journal.value().textValue();
+            effective.assign(text.data(), text.length());
+            std::transform(effective.begin(), effective.end(), effective.begin(), ::toupper);
+        }
+        if (effective != mode) {
+            SPDLOG_WARN("请求的日志模式 {}，实际为 {}", mode, effective);
+        }
+
+        for (int txn : { 1, 10, 100, 1000 }) {
+            if (txn > rows) {
+                continue;
+            }
+            int ops = txn == 1 ? std::min(rows, kMaxCommitOps) : rows;
+            std::vector<ModelSample> models = makeSamples(0, ops);
+            db.deleteObjects(TABLE_NAME_SAMPLE);
+            measure("transaction", effective + " txn=" + std::to_string(txn),
+                    { { "journal_mode", effective }, { "transaction_rows", txn } }, ops, [&]() {
+                for (int begin = 0; begin < ops; begin += txn) {
+                    int end = std::min(begin + txn, ops);
+                    bool committed = db.runTransaction([&](WCDB::Handle &handle) {
+                        for (int i = begin; i < end; i++) {
+                            if (!handle.insertObjects<ModelSample>(models[i], TABLE_NAME_SAMPLE)) {
+                                return false;
+                            }
+                        }
+                        return true;
+                    });
+                    if (!committed) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        }
+        db.close();
+        db.removeFiles();
+    }
+}
+
+/**
+ * @brief 主键点查与 created_at 范围查询（每次命中 100 行）的延迟与表大小
+ */
+void benchQueryScaling(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Query latency vs table size ----");
+    auto idField = WCDB_FIELD(ModelSample::id);
+    auto createdAt = WCDB_FIELD(ModelSample::created_at);
+    const int rangeRows = 100;
+    std::mt19937 random(42);
+
+    resetTable(db);
+    int inserted = 0;
+    for (int size : { std::max(rows / 10, rangeRows), rows, rows * 10 }) {
+        if (size <= inserted) {
+            continue;
+        }
+        if (!db.insertObjects<ModelSample>(makeSamples(inserted, size), TABLE_NAME_SAMPLE)) {
+            SPDLOG_ERROR("写入 {} 行失败", size);
+            return;
+        }
+        inserted = size;
+        nlohmann::json params = { { "table_rows", size } };
+
+        std::uniform_int_distribution<int> ids(1, size);
+        measureEach("query", "point by id rows=" + std::to_string(size), params,
+                    (size_t) std::min(size, 2000), [&](size_t) {
+            return db.getFirstObject<ModelSample>(TABLE_NAME_SAMPLE, idField == ids(random)).hasValue();
+        });
+
+        std::uniform_int_distribution<int> starts(0, size - rangeRows);
+        measureEach("query", "range 100 by created_at rows=" + std::to_string(size), params,
+                    (size_t) std::min(size / rangeRows * 10, 500), [&](size_t) {
+            int64_t from = kSampleEpochMillis + (int64_t) starts(random) * 1000;
+            auto objects = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE,
+                                                         createdAt >= from && createdAt < from + rangeRows * 1000);
+            return objects.hasValue() && objects.value().size() == (size_t) rangeRows;
+        });
+    }
+}
+
+/**
+ * @brief 一个写线程逐行提交，同时 0~4 个读线程做主键点查
+ *
+ * 记录写入延迟随读线程数的变化，以及读线程的总吞吐和延迟。
+ */
+void benchConcurrency(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- Concurrent readers with one writer ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+    resetTable(db);
+    db.insertObjects<ModelSample>(makeSamples(0, rows), TABLE_NAME_SAMPLE);
+    const int writes = std::min(rows, kMaxCommitOps);
+    std::vector<ModelSample> models = makeSamples(rows, rows + writes);
+
+    for (int readers : { 0, 1, 2, 4 }) {
+        std::atomic<bool> stopping(false);
+        std::atomic<bool> readFailed(false);
+        std::vector<std::vector<double>> readLatencies(readers);
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; r++) {
+            threads.emplace_back([&, r]() {
+                std::mt19937 random(r + 1);
+                std::uniform_int_distribution<int> ids(1, rows);
+                while (!stopping.load(std::memory_order_relaxed)) {
+                    auto start = Clock::now();
+                    if (!db.getFirstObject<ModelSample>(TABLE_NAME_SAMPLE, idField == ids(random)).hasValue()) {
+                        readFailed = true;
+                    }
+                    readLatencies[r].push_back(microsSince(start));
+                }
+            });
+        }
+
+        nlohmann::json params = { { "readers", readers }, { "table_rows", rows } };
+        auto start = Clock::now();
+        measureEach("concurrency", "writer commit readers=" + std::to_string(readers), params, (size_t) writes,
+                    [&](size_t i) {
+            return db.insertObjects<ModelSample>(models[i], TABLE_NAME_SAMPLE);
+        });
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        stopping = true;
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        db.deleteObjects(TABLE_NAME_SAMPLE, idField > rows);
+
+        if (readers > 0) {
+            PerfResult result;
+            result.suite = "concurrency";
+            result.name = "reader point query readers=" + std::to_string(readers);
+            result.params = params;
+            result.seconds = seconds;
+            result.ok = !readFailed;
+            for (const std::vector<double> &latencies : readLatencies) {
+                result.latencies.insert(result.latencies.end(), latencies.begin(), latencies.end());
+            }
+            result.ops = result.latencies.size();
+            report(std::move(result));
+        }
+    }
+}
+
+/**
+ * @brief enableAutoBackup 的开销：逐行提交、批量写入和检查点（备份在检查点后进行）
+ */
+void benchAutoBackup(const std::string &dir, int rows)
+{
+    SPDLOG_INFO("---- enableAutoBackup overhead ({} rows) ----", rows);
+    const int commits = std::min(rows, kMaxCommitOps);
+    std::vector<ModelSample> models = makeSamples(0, rows);
+
+    for (bool backup : { false, true }) {
+        std::string label = backup ? "on" : "off";
+        WCDB::Database db(dir + "/wcdb_perf_backup_" + label + ".db");
+        db.removeFiles();
+        db.enableAutoBackup(backup);
+        if (!db.createTable<ModelSample>(TABLE_NAME_SAMPLE)) {
+            SPDLOG_ERROR("建表失败");
+            continue;
+        }
+        nlohmann::json params = { { "auto_backup", backup } };
+
+        measureEach("backup", "single-row commit backup=" + label, params, (size_t) commits, [&](size_t i) {
+            return db.insertObjects<ModelSample>(models[i], TABLE_NAME_SAMPLE);
+        });
+        measure("backup", "insertObjects batch backup=" + label, params, (size_t) rows, [&]() {
+            return db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
+        });
+        measure("backup", "truncateCheckpoint backup=" + label, params, 1, [&]() {
+            return db.truncateCheckpoint();
+        });
+        db.close();
+        db.removeFiles();
+    }
+}
+
+/**
+ * @brief ORM 绑定与手写语句的对比：同一事务内逐行插入、全表读取和主键点查
+ */
+void benchOrmVsRaw(WCDB::Database &db, int rows)
+{
+    SPDLOG_INFO("---- ORM binding vs raw statements ({} rows) ----", rows);
+    auto idField = WCDB_FIELD(ModelSample::id);
+    std::vector<ModelSample> models = makeSamples(0, rows);
+
+    WCDB::Columns columns;
+    WCDB::ResultColumns resultColumns;
+    resultColumns.push_back(WCDB::Column("id"));
+    for (const std::string &name : kSampleColumns) {
+        columns.push_back(WCDB::Column(name));
+        resultColumns.push_back(WCDB::Column(name));
+    }
+    auto bindSample = [](WCDB::Handle &handle, const ModelSample &model) {
+        handle.bindText(WCDB::UnsafeStringView(model.name), 1);
+        handle.bindInteger(model.age, 2);
+        handle.bindText(WCDB::UnsafeStringView(model.email), 3);
+        handle.bindText(WCDB::UnsafeStringView(model.phone), 4);
+        handle.bindText(WCDB::UnsafeStringView(model.address), 5);
+        handle.bindText(WCDB::UnsafeStringView(model.city), 6);
+        handle.bindText(WCDB::UnsafeStringView(model.state), 7);
+        handle.bindText(WCDB::UnsafeStringView(model.country), 8);
+        handle.bindInteger(model.created_at, 9);
+        handle.bindInteger(model.updated_at, 10);
+        handle.bindText(WCDB::UnsafeStringView(model.add_1), 11);
+    };
+    auto readText = [](WCDB::Handle &handle, int index) {
+        WCDB::UnsafeStringView text = handle.getText(index);
+        return std::string(text.data(), text.length());
+    };
+    auto readSample = [&](WCDB::Handle &handle) {
+        ModelSample model;
+        model.id = (int) handle.getInteger(0);
+        model.name = readText(handle, 1);
+        model.age = (int) handle.getInteger(2);
+        model.email = readText(handle, 3);
+        model.phone = readText(handle, 4);
+        model.address = readText(handle, 5);
+        model.city = readText(handle, 6);
+        model.state = readText(handle, 7);
+        model.country = readText(handle, 8);
+        model.created_at = handle.getInteger(9);
+        model.updated_at = handle.getInteger(10);
+        model.add_1 = readText(handle, 11);
+        return model;
+    };
+
+    // 插入
+    resetTable(db);
+    measure("orm", "ORM insertObjects (per row)", { { "api", "orm" } }, (size_t) rows, [&]() {
+        return db.runTransaction([&](WCDB::Handle &handle) {
+            for (const ModelSample &model : models) {
+                if (!handle.insertObjects<ModelSample>(model, TABLE_NAME_SAMPLE)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    });
+    resetTable(db);
+    measure("orm", "raw prepared insert (per row)", { { "api", "raw" } }, (size_t) rows, [&]() {
+        return db.runTransaction([&](WCDB::Handle &handle) {
+            WCDB::StatementInsert insert;
+            insert.insertIntoTable(TABLE_NAME_SAMPLE).columns(columns)
+                .values(WCDB::BindParameter::bindParameters((int) kSampleColumns.size()));
+            if (!handle.prepare(insert)) {
+                return false;
+            }
+            for (const ModelSample &model : models) {
+                handle.reset();
+                bindSample(handle, model);
+                if (!handle.step()) {
+                    handle.finalize();
+                    return false;
+                }
+            }
+            handle.finalize();
+            return true;
+        });
+    });
+
+    // 全表读取
+    measure("orm", "ORM getAllObjects", { { "api", "orm" } }, (size_t) rows, [&]() {
+        auto objects = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE);
+        return objects.hasValue() && objects.value().size() == (size_t) rows;
+    });
+    measure("orm", "raw select + step", { { "api", "raw" } }, (size_t) rows, [&]() {
+        WCDB::Handle handle = db.getHandle();
+        std::vector<ModelSample> objects;
+        objects.reserve(rows);
+        bool succeed = handle.prepare(WCDB::StatementSelect().select(resultColumns).from(TABLE_NAME_SAMPLE));
+        while (succeed && (succeed = handle.step()) && !handle.done()) {
+            objects.push_back(readSample(handle));
+        }
+        handle.finalize();
+        handle.invalidate();
+        return succeed && objects.size() == (size_t) rows;
+    });
+
+    // 主键点查
+    measureEach("orm", "ORM getFirstObject by id", { { "api", "orm" } }, (size_t) rows, [&](size_t i) {
+        return db.getFirstObject<ModelSample>(TABLE_NAME_SAMPLE, idField == (int) i + 1).hasValue();
+    });
+    {
+        WCDB::Handle handle = db.getHandle();
+        bool prepared = handle.prepare(WCDB::StatementSelect().select(resultColumns).from(TABLE_NAME_SAMPLE)
+                                       .where(WCDB::Column("id") == WCDB::BindParameter(1)));
+        measureEach("orm", "raw prepared select by id", { { "api", "raw" } }, (size_t) rows, [&](size_t i) {
+            if (!prepared) {
+                return false;
+            }
+            handle.reset();
+            handle.bindInteger((int64_t) i + 1, 1);
+            if (!handle.step() || handle.done()) {
+                return false;
+            }
+            return readSample(handle).id == (int) i + 1;
+        });
+        handle.finalize();
+        handle.invalidate();
+    }
+}
+
+/**
+ * @brief 把所有结果与运行环境写成 JSON，便于比较 arm64 与 amd64 的结果
+ */
+bool writeJson(const std::string &path, int rows)
+{
+    struct utsname system;
+    nlohmann::json root;
+    root["tool"] = appname;
+    root["schema_version"] = 1;
+    if (uname(&system) == 0) {
+        root["arch"] = system.machine;
+        root["system"] = std::string(system.sysname) + " " + system.release;
+    }
+    root["compiler"] = __VERSION__;
+    root["hardware_concurrency"] = std::thread::hardware_concurrency();
+    root["rows"] = rows;
+    root["timestamp_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count();
+
+    nlohmann::json results = nlohmann::json::array();
+    for (const PerfResult &result : g_results) {
+        nlohmann::json item;
+        item["suite"] = result.suite;
+        item["name"] = result.name;
+        item["params"] = result.params;
+        item["ok"] = result.ok;
+        item["ops"] = result.ops;
+        item["seconds"] = result.seconds;
+        item["ops_per_sec"] = result.OpsPerSecond();
+        item["ns_per_op"] = result.NanosPerOp();
+        if (!result.latencies.empty()) {
+            item["p50_us"] = result.PercentileMicros(0.5);
+            item["p90_us"] = result.PercentileMicros(0.9);
+            item["p99_us"] = result.PercentileMicros(0.99);
+            item["max_us"] = result.latencies.back();
+        }
+        results.push_back(item);
+    }
+    root["results"] = results;
+
+    std::ofstream file(path);
+    file << root.dump(2) << std::endl;
+    return file.good();
+}
+
+int main(int argc, char *argv[])
+{
+    initlog();
+
+    int rows = argc > 1 ? std::atoi(argv[1]) : 10000;
+    std::string dir = argc > 2 ? argv[2] : ".";
+    std::string jsonPath = argc > 3 ? argv[3] : "wcdb_perf.json";
+    if (rows < 100) {
+        SPDLOG_ERROR("用法: wcdb_perf [rows>=100] [work_dir] [json_path]");
+        return -1;
+    }
+
+    WCDB::Database db(dir + "/wcdb_perf.db");
+    db.removeFiles();
+
+    benchBatchSizes(db, rows);
+    benchTransactionSizes(dir, rows);
+    benchQueryScaling(db, rows);
+    benchConcurrency(db, rows);
+    benchAutoBackup(dir, rows);
+    benchOrmVsRaw(db, rows);
+
+    db.close();
+    db.removeFiles();
+
+    if (!writeJson(jsonPath, rows)) {
+        SPDLOG_ERROR("写入 {} 失败", jsonPath);
+        return -1;
+    }
+    SPDLOG_INFO("结果已写入 {}", jsonPath);
+    return 0;
+}
@@ -2,30 +2,13 @@
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/sinks/rotating_file_sink.h"
 #include "model/model_sample.h"
+#include "Storage/Storage.h"
 #include <chrono>
 #include <future>
 
 bool runTag = true;
 std::string appname = "wcdb_test";
 
-// 设置表wcdb宏
-WCDB_CPP_ORM_IMPLEMENTATION_BEGIN(ModelSample);
-WCDB_CPP_SYNTHESIZE(id);
-WCDB_CPP_SYNTHESIZE(name);
-WCDB_CPP_SYNTHESIZE(age);
-WCDB_CPP_SYNTHESIZE(email);
-WCDB_CPP_SYNTHESIZE(phone);
-WCDB_CPP_SYNTHESIZE(address);
-WCDB_CPP_SYNTHESIZE(city);
-WCDB_CPP_SYNTHESIZE(state);
-WCDB_CPP_SYNTHESIZE(country);
-WCDB_CPP_SYNTHESIZE(created_at);
-WCDB_CPP_SYNTHESIZE(updated_at);
-WCDB_CPP_SYNTHESIZE(add_1);
-
-WCDB_CPP_PRIMARY_AUTO_INCREMENT(id);
-WCDB_CPP_ORM_IMPLEMENTATION_END;
-
 // 设置spdlog参数配置
 void initlog()
 {
@@ -64,6 +47,8 @@ void insertData(WCDB::Database &db)
         model.email = "john.doe@example.com " + std::to_string(i);
         model.phone = "1234567890 " + std::to_string(i);
         model.add_1 = "add_1_ " + std::to_string(i);
+        model.created_at = Storage::NowMillis();
+        model.updated_at = model.created_at;
         models.push_back(model);
     }
     auto ret = db.insertObjects<ModelSample>(models, TABLE_NAME_SAMPLE);
@@ -77,34 +62,115 @@ void insertData(WCDB::Database &db)
 /**
  * @brief 查询数据
  * @param db 数据库对象
+ * @note 按主键分页遍历，每次只保留一行数据，内存占用与表大小无关
  */
 void queryData(WCDB::Database &db)
 {
-    auto allObjects = db.getAllObjects<ModelSample>(TABLE_NAME_SAMPLE);
     int countInterval = 100;
-    if (allObjects.hasValue()) {
-        size_t totalCount = allObjects.value().size();
-        SPDLOG_INFO("查询到数据总数: {}", totalCount);
-        
-        // 每隔 countInterval 条打印一次数据内容
-        for (size_t i = 0; i < totalCount; i++) {
+    WCDB::Handle handle = db.getHandle();
+    {
+        Storage::KeysetCursor<ModelSample> cursor(handle, TABLE_NAME_SAMPLE, WCDB_FIELD(ModelSample::id));
+        uint64_t lastPrinted = 0;
+        while (cursor.Next()) {
+            uint64_t i = cursor.Position() - 1;
+            // 每隔 countInterval 条打印一次数据内容
             if (i % countInterval == 0) {
-                const ModelSample &model = allObjects.value()[i];
+                const ModelSample &model = cursor.Current();
                 SPDLOG_INFO("第 {} 条数据: id={}, name={}, age={}, email={}, phone={}, add1={}", 
                            i + 1, model.id, model.name, model.age, model.email, model.phone, model.add_1);
+                lastPrinted = i + 1;
             }
         }
-        
-        // 打印最后一条数据（如果不是1000的倍数）
-        if (totalCount > 0 && (totalCount - 1) % countInterval != 0) {
-            const ModelSample &lastModel = allObjects.value()[totalCount - 1];
-            SPDLOG_INFO("最后一条数据 (第 {} 条): id={}, name={}, age={}, email={}, phone={}, add1={}", 
-                       totalCount, lastModel.id, lastModel.name, lastModel.age, 
-                       lastModel.email, lastModel.phone, lastModel.add_1);
+
+        if (cursor.Failed()) {
+            SPDLOG_ERROR("查询数据失败");
+        } else {
+            uint64_t totalCount = cursor.Position();
+            SPDLOG_INFO("查询到数据总数: {}", totalCount);
+
+            // 打印最后一条数据（如果还没打印过）
+            if (totalCount > 0 && lastPrinted != totalCount) {
+                const ModelSample &lastModel = cursor.Current();
+                SPDLOG_INFO("最后一条数据 (第 {} 条): id={}, name={}, age={}, email={}, phone={}, add1={}", 
+                           totalCount, lastModel.id, lastModel.name, lastModel.age, 
+                           lastModel.email, lastModel.phone, lastModel.add_1);
+            }
         }
-    } else {
-        SPDLOG_ERROR("查询数据失败");
     }
+    handle.invalidate();
+}
+
+/**
+ * @brief 增量查询数据，只返回上次轮询之后新增或修改的行
+ * @param poller 增量轮询器
+ */
+void pollData(Storage::ChangePoller<ModelSample> &poller)
+{
+    int inserted = 0;
+    int updated = 0;
+    int64_t ret = poller.Poll([&](const ModelSample &model, Storage::ChangeKind kind) {
+        if (kind == Storage::ChangeKind::Inserted) {
+            inserted++;
+        } else {
+            updated++;
+            SPDLOG_INFO("数据已修改: id={}, name={}, updated_at={}", model.id, model.name,
+                        Storage::FormatTimestamp(model.updated_at));
+        }
+        return true;
+    });
+    if (ret < 0) {
+        SPDLOG_ERROR("增量查询数据失败");
+        return;
+    }
+    if (!poller.Commit()) {
+        SPDLOG_WARN("保存轮询水位失败");
+    }
+    SPDLOG_INFO("增量查询: 新增 {} 条, 修改 {} 条, 水位 rowid={}", inserted, updated, poller.GetWatermark().maxRowid);
+}
+
+/**
+ * @brief 检查一次插入只收到一次 Inserted，之后的轮询不会再作为 Updated 收到
+ * @param db 数据库对象
+ * @return 检查通过返回 true
+ */
+bool checkPollerDelivery(WCDB::Database &db)
+{
+    WCDB::Handle handle = db.getHandle();
+    bool passed = false;
+    {
+        Storage::ChangePoller<ModelSample> poller(handle, TABLE_NAME_SAMPLE,
+                                                  WCDB_FIELD(ModelSample::updated_at), appname + "_check");
+        auto ignore = [](const ModelSample &, Storage::ChangeKind) { return true; };
+        // 先读完已有数据，不 Commit，每次运行都从头开始
+        int64_t ret = 0;
+        while (poller.IsValid() && (ret = poller.Poll(ignore)) > 0) {}
+
+        ModelSample model;
+        model.id = 0;
+        model.isAutoIncrement = true;
+        model.name = "poll check";
+        model.created_at = Storage::NowMillis();
+        model.updated_at = model.created_at;
+        if (ret < 0 || !db.insertObjects<ModelSample>(model, TABLE_NAME_SAMPLE)) {
+            SPDLOG_ERROR("增量轮询检查: 准备数据失败");
+        } else {
+            int inserted = 0;
+            int updated = 0;
+            auto count = [&](const ModelSample &, Storage::ChangeKind kind) {
+                (kind == Storage::ChangeKind::Inserted ? inserted : updated)++;
+                return true;
+            };
+            bool polled = poller.Poll(count) >= 0 && poller.Poll(count) >= 0;
+            passed = polled && inserted == 1 && updated == 0;
+            if (passed) {
+                SPDLOG_INFO("增量轮询检查通过: 一次插入只收到一次 Inserted");
+            } else {
+                SPDLOG_ERROR("增量轮询检查失败: 新增 {} 次, 修改 {} 次, 期望 1 次和 0 次", inserted, updated);
+            }
+        }
+    }
+    handle.invalidate();
+    return passed;
 }
 
 /**
@@ -167,6 +233,36 @@ void initDatabaseProtection(WCDB::Database &db)
     });
 }
 
+/**
+ * @brief 检查热点查询的执行计划，有全表扫描或临时 B 树时打印警告
+ * @param db 数据库对象
+ */
+void checkQueryPlans(WCDB::Database &db)
+{
+    auto name = WCDB_FIELD(ModelSample::name);
+    auto city = WCDB_FIELD(ModelSample::city);
+    auto createdAt = WCDB_FIELD(ModelSample::created_at);
+
+    Storage::QueryPlanChecker checker;
+    checker.Register("sample by name", WCDB::StatementSelect().select(ModelSample::allFields())
+                     .from(TABLE_NAME_SAMPLE).where(name == WCDB::BindParameter(1)));
+    checker.Register("sample by city, newest first", WCDB::StatementSelect().select(ModelSample::allFields())
+                     .from(TABLE_NAME_SAMPLE).where(city == WCDB::BindParameter(1))
+                     .order(createdAt.asOrder(WCDB::Order::DESC)).limit(20));
+    checker.Register("sample created in range", WCDB::StatementSelect().select(ModelSample::allFields())
+                     .from(TABLE_NAME_SAMPLE).where(Storage::TimeRangeParameters(createdAt)));
+
+    WCDB::Handle handle = db.getHandle();
+    std::vector<Storage::PlanReport> problems = checker.Problems(handle);
+    handle.invalidate();
+    for (const Storage::PlanReport &report : problems) {
+        SPDLOG_WARN("查询计划需要优化:\n{}", report.Describe());
+    }
+    if (problems.empty()) {
+        SPDLOG_INFO("{} 条热点查询均已命中索引", checker.Size());
+    }
+}
+
 int main() 
 {
     initlog();
@@ -190,27 +286,48 @@ int main()
     }
 #endif
 
+    // 旧版本的 created_at / updated_at 为文本列，建表前迁移为整数毫秒
+    WCDB::Handle migration = db.getHandle();
+    if (!Storage::MigrateTextTimestamps<ModelSample>(migration, TABLE_NAME_SAMPLE, { "created_at", "updated_at" })) {
+        SPDLOG_ERROR("迁移时间列失败");
+    }
+    migration.invalidate();
+
     // 创建表结构
     if (!db.createTable<ModelSample>(TABLE_NAME_SAMPLE)) {
         SPDLOG_ERROR("创建表失败");
         //return -1;
     }
+    checkQueryPlans(db);
 
     // 插入数据
     insertData(db);
 
     // 查询数据
-    int count = 0;
-    while (runTag) {
-        count++;
-        if (count % 5 == 0) {
-            //insertData(db);
+    queryData(db);
+    checkPollerDelivery(db);
+
+    // 之后只轮询新增和修改的数据
+    WCDB::Handle handle = db.getHandle();
+    {
+        Storage::ChangePoller<ModelSample> poller(handle, TABLE_NAME_SAMPLE,
+                                                  WCDB_FIELD(ModelSample::updated_at), appname);
+        if (!poller.IsValid()) {
+            SPDLOG_ERROR("初始化增量轮询失败");
+        }
+        int count = 0;
+        while (runTag) {
+            count++;
+            if (count % 5 == 0) {
+                //insertData(db);
+            }
+            SPDLOG_INFO("查询数据第{}次", count);
+            pollData(poller);
+            
+           std::this_thread::sleep_for(std::chrono::seconds(10));
         }
-        SPDLOG_INFO("查询数据第{}次", count);
-        queryData(db);
-        
-       std::this_thread::sleep_for(std::chrono::seconds(10));
     }
+    handle.invalidate();
 
     return 0;
 }
\ No newline at end of file
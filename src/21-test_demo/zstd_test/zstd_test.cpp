@@ -2,6 +2,17 @@
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/sinks/rotating_file_sink.h"
 #include "zstd/zstd.h"
+#include "Utility/Compression.h"
+#include "Utility/CompressionStats.h"
+#include "Utility/AsyncIO.h"
+#include "Utility/Recompression.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
 #include <chrono>
 #include <vector>
 #include <string>
@@ -383,6 +394,434 @@ void testDecompressWithoutOriginalSize()
     SPDLOG_INFO("========== 未知原始大小解压测试完成 ==========");
 }
 
+// ---------------- Utility 文件压缩、异步 I/O 与统计的行为检查 ----------------
+
+int failedChecks = 0;
+
+/**
+ * @brief 记录一项检查的结果，失败时计数，main 据此返回非 0
+ */
+void check(bool condition, const std::string& what)
+{
+    if (condition) {
+        SPDLOG_INFO("通过: {}", what);
+    } else {
+        failedChecks++;
+        SPDLOG_ERROR("失败: {}", what);
+    }
+}
+
+bool writeFile(const std::string& path, const std::vector<char>& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return file.good();
+}
+
+std::vector<char> readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// 目录中 AtomicOutputFile 遗留的临时文件数
+int countTempFiles(const std::string& dir)
+{
+    int count = 0;
+    DIR* handle = opendir(dir.c_str());
+    if (handle == nullptr) {
+        return -1;
+    }
+    while (dirent* entry = readdir(handle)) {
+        if (std::string(entry->d_name).find(".tmp.") != std::string::npos) {
+            count++;
+        }
+    }
+    closedir(handle);
+    return count;
+}
+
+/**
+ * @brief 生成可压缩但不平凡的测试数据，避免整文件被压成几个字节
+ */
+std::vector<char> makeFileData(size_t size)
+{
+    std::vector<char> data(size);
+    uint32_t state = 12345;
+    for (size_t i = 0; i < size; i++) {
+        state = state * 1103515245 + 12345;
+        data[i] = (i % 64 < 48) ? static_cast<char>('a' + (i / 64) % 26) : static_cast<char>(state >> 24);
+    }
+    return data;
+}
+
+/**
+ * @brief CompressFile/DecompressFile 往返、进度、取消和原子替换
+ * @param engine 异步写出引擎，nullptr 表示同步写出
+ */
+void testFileRoundTrip(const std::string& dir, const std::string& label, Utility::AsyncIO::Engine* engine)
+{
+    namespace Compression = Utility::Compression;
+    SPDLOG_INFO("========== 文件压缩往返测试 ({}) ==========", label);
+
+    const std::string src = dir + "/roundtrip_" + label + ".bin";
+    const std::string packed = src + ".zst";
+    const std::string restored = src + ".out";
+    std::vector<char> original = makeFileData(3 * 1024 * 1024 + 123);
+    if (!writeFile(src, original)) {
+        check(false, label + ": 写入源文件");
+        return;
+    }
+
+    // 64KB 缓冲区让输出跨越多个暂存缓冲区，覆盖异步写出的轮转和最后一次写入 + fsync
+    Compression::FileOptions options;
+    options.bufferSize = 64 * 1024;
+    options.syncOutput = true;
+    options.ioEngine = engine;
+    uint64_t lastProcessed = 0;
+    uint64_t lastTotal = 0;
+    bool monotonic = true;
+    options.onProgress = [&](uint64_t processed, uint64_t total) {
+        monotonic = monotonic && processed >= lastProcessed;
+        lastProcessed = processed;
+        lastTotal = total;
+    };
+
+    check(Compression::CompressFile(src, packed, Compression::Algorithm::Zstd, options), label + ": CompressFile 成功");
+    check(monotonic && lastProcessed == original.size() && lastTotal == original.size(),
+          label + ": 压缩进度单调递增并以源文件大小结束");
+
+    lastProcessed = 0;
+    check(Compression::DecompressFile(packed, restored, Compression::Algorithm::Zstd, options),
+          label + ": DecompressFile 成功");
+    check(readFile(restored) == original, label + ": 解压结果与原文件一致");
+    check(lastProcessed == readFile(packed).size(), label + ": 解压进度以压缩文件大小结束");
+
+    // 第 3 个缓冲区之前取消：返回 false，已存在的目标文件不变，临时文件被删除
+    const std::vector<char> previous = {'o', 'l', 'd'};
+    writeFile(packed, previous);
+    int polls = 0;
+    options.onProgress = nullptr;
+    options.shouldCancel = [&polls]() { return ++polls > 2; };
+    check(!Compression::CompressFile(src, packed, Compression::Algorithm::Zstd, options), label + ": 取消时返回 false");
+    check(readFile(packed) == previous, label + ": 取消后目标文件保持不变");
+    check(countTempFiles(dir) == 0, label + ": 取消后没有遗留临时文件");
+
+    unlink(src.c_str());
+    unlink(packed.c_str());
+    unlink(restored.c_str());
+}
+
+/**
+ * @brief rename 失败（目标是目录）时返回 false 并删除临时文件
+ */
+void testRenameFailureCleanup(const std::string& dir, Utility::AsyncIO::Engine* engine)
+{
+    namespace Compression = Utility::Compression;
+    SPDLOG_INFO("========== 原子替换失败清理测试 ==========");
+
+    const std::string src = dir + "/rename_src.bin";
+    const std::string target = dir + "/rename_target";
+    writeFile(src, makeFileData(256 * 1024));
+    mkdir(target.c_str(), 0755);
+
+    Compression::FileOptions options;
+    options.ioEngine = engine;
+    check(!Compression::CompressFile(src, target, Compression::Algorithm::Zstd, options), "目标为目录时 CompressFile 返回 false");
+    struct stat st;
+    check(stat(target.c_str(), &st) == 0 && S_ISDIR(st.st_mode), "rename 失败后目标目录保持不变");
+    check(countTempFiles(dir) == 0, "rename 失败后没有遗留临时文件");
+
+    rmdir(target.c_str());
+    unlink(src.c_str());
+}
+
+/**
+ * @brief 前缀解压在得到所需字节后停止读取和解码
+ */
+void testPrefixEarlyStop(const std::string& dir)
+{
+    namespace Compression = Utility::Compression;
+    SPDLOG_INFO("========== 前缀解压提前停止测试 ==========");
+
+    std::vector<char> original = makeFileData(8 * 1024 * 1024);
+    std::vector<char> compressed = Compression::Compress(original, Compression::Algorithm::Zstd, 1);
+    const std::string packed = dir + "/prefix.zst";
+    writeFile(packed, compressed);
+    const size_t prefixSize = 4096;
+
+    Compression::ResetStats();
+    std::vector<char> prefix;
+    check(Compression::DecompressFilePrefix(packed, prefixSize, prefix), "DecompressFilePrefix 成功");
+    check(prefix.size() == prefixSize && std::equal(prefix.begin(), prefix.end(), original.begin()),
+          "文件前缀与原始数据的前 4096 字节一致");
+    Compression::StatsSnapshot snapshot = Compression::GetStatsSnapshot();
+    uint64_t bytesRead = 0;
+    for (const auto& entry : snapshot.entries) {
+        if (entry.operation == Compression::StatsOperation::DecompressFile) {
+            bytesRead += entry.bytesIn;
+        }
+    }
+    SPDLOG_INFO("压缩文件 {} bytes，前缀解压读取 {} bytes", compressed.size(), bytesRead);
+    check(bytesRead > 0 && bytesRead < compressed.size() / 4, "前缀解压只读取压缩文件的开头部分");
+
+    std::vector<char> memoryPrefix = Compression::DecompressPrefix(compressed, prefixSize);
+    check(memoryPrefix == prefix, "DecompressPrefix 与 DecompressFilePrefix 结果一致");
+
+    size_t chunks = 0;
+    size_t received = 0;
+    bool streamed = Compression::DecompressStream(compressed, [&](const char*, size_t size) {
+        chunks++;
+        received += size;
+        return false;
+    });
+    check(streamed && chunks == 1 && received < original.size(), "DecompressStream 在回调返回 false 后停止");
+
+    // 截断的文件在达到 maxBytes 之前结束时必须失败
+    writeFile(packed, std::vector<char>(compressed.begin(), compressed.begin() + compressed.size() / 2));
+    check(!Compression::DecompressFilePrefix(packed, original.size(), prefix), "截断文件的完整前缀解压返回 false");
+    unlink(packed.c_str());
+}
+
+/**
+ * @brief 已知工作负载后的统计计数
+ */
+void testStatsCounters()
+{
+    namespace Compression = Utility::Compression;
+    SPDLOG_INFO("========== 压缩统计计数测试 ==========");
+
+    std::vector<char> data = makeFileData(100 * 1000);
+    Compression::ResetStats();
+    uint64_t compressedBytes = 0;
+    std::vector<char> compressed;
+    for (int i = 0; i < 3; i++) {
+        compressed = Compression::Compress(data, Compression::Algorithm::Zstd, 5);
+        compressedBytes += compressed.size();
+    }
+    Compression::Decompress(compressed, data.size());
+    std::vector<char> garbage(64, 'x');
+    Compression::DecompressAuto(garbage);
+
+    const Compression::StatsEntry* compress = nullptr;
+    const Compression::StatsEntry* decompress = nullptr;
+    Compression::StatsSnapshot snapshot = Compression::GetStatsSnapshot();
+    for (const auto& entry : snapshot.entries) {
+        if (entry.operation == Compression::StatsOperation::Compress && entry.level == 5) {
+            compress = &entry;
+        } else if (entry.operation == Compression::StatsOperation::Decompress) {
+            decompress = &entry;
+        }
+    }
+    check(snapshot.entries.size() == 2, "快照只包含有调用的两个组合");
+    check(compress != nullptr && compress->calls == 3 && compress->failures == 0
+          && compress->bytesIn == 3 * data.size() && compress->bytesOut == compressedBytes,
+          "Compress 计数: 3 次调用、输入输出字节数");
+    check(decompress != nullptr && decompress->calls == 2 && decompress->failures == 1
+          && decompress->bytesIn == compressed.size() && decompress->bytesOut == data.size(),
+          "Decompress 计数: 2 次调用、1 次失败、只计成功调用的字节数");
+    check(compress != nullptr && compress->LatencyPercentileMicros(0.99) > 0, "延迟直方图有数据");
+
+    // 其他线程的计数在线程退出后仍计入快照
+    std::thread([&data]() { Compression::Compress(data, Compression::Algorithm::Zstd, 5); }).join();
+    snapshot = Compression::GetStatsSnapshot();
+    uint64_t calls = 0;
+    for (const auto& entry : snapshot.entries) {
+        if (entry.operation == Compression::StatsOperation::Compress && entry.level == 5) {
+            calls = entry.calls;
+        }
+    }
+    check(calls == 4, "已退出线程的计数保留在快照中");
+
+    Compression::ResetStats();
+    check(Compression::GetStatsSnapshot().entries.empty(), "ResetStats 之后快照为空");
+}
+
+/**
+ * @brief 异步写出时大量暂存缓冲区同时在途，Commit 后文件内容必须完整
+ *
+ * 4KB 缓冲区加 4 个工作线程，最后一次写入 + fsync 提交时之前的写入通常仍在执行
+ */
+void testAsyncSyncOrdering(const std::string& dir, Utility::AsyncIO::Backend backend)
+{
+    namespace Compression = Utility::Compression;
+    Utility::AsyncIO::Options engineOptions;
+    engineOptions.backend = backend;
+    engineOptions.workerThreads = 4;
+    Utility::AsyncIO::Engine engine(engineOptions);
+    if (!engine.IsValid()) {
+        return;
+    }
+    SPDLOG_INFO("========== 异步写出 fsync 顺序测试 ({}) ==========",
+                backend == Utility::AsyncIO::Backend::IoUring ? "io_uring" : "thread_pool");
+
+    const std::string src = dir + "/ordering.bin";
+    const std::string packed = src + ".zst";
+    std::vector<char> original = makeFileData(2 * 1024 * 1024);
+    writeFile(src, original);
+
+    Compression::FileOptions options;
+    options.bufferSize = 4096;
+    options.syncOutput = true;
+    options.dropPageCache = false;
+    options.ioEngine = &engine;
+    bool intact = true;
+    for (int round = 0; round < 5 && intact; round++) {
+        intact = Compression::CompressFile(src, packed, Compression::Algorithm::Zstd, options)
+                 && Compression::DecompressAuto(readFile(packed)) == original;
+    }
+    check(intact && engine.InFlight() == 0, "多缓冲区异步写出 + fsync 后压缩文件完整，且没有在途请求");
+
+    unlink(src.c_str());
+    unlink(packed.c_str());
+}
+
+/**
+ * @brief 多个线程共享一个引擎并发压缩，各自的回调可能在其他线程的 Reap 中执行
+ */
+void testSharedEngine(const std::string& dir, Utility::AsyncIO::Engine* engine, const std::string& label)
+{
+    namespace Compression = Utility::Compression;
+    SPDLOG_INFO("========== 共享引擎并发压缩测试 ({}) ==========", label);
+
+    const int threadCount = 3;
+    std::vector<char> original = makeFileData(1024 * 1024);
+    std::vector<std::thread> threads;
+    std::vector<int> intact(threadCount, 0);
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            const std::string src = dir + "/shared_" + std::to_string(t) + ".bin";
+            const std::string packed = src + ".zst";
+            writeFile(src, original);
+            Compression::FileOptions options;
+            options.bufferSize = 16 * 1024;
+            options.ioEngine = engine;
+            intact[t] = Compression::CompressFile(src, packed, Compression::Algorithm::Zstd, options)
+                        && Compression::DecompressAuto(readFile(packed)) == original;
+            unlink(src.c_str());
+            unlink(packed.c_str());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    check(std::count(intact.begin(), intact.end(), 1) == threadCount && engine->InFlight() == 0,
+          label + ": 共享引擎的并发压缩全部完成且结果正确");
+}
+
+/**
+ * @brief 内存对象存储，前 conflicts 次 Replace 返回冲突，模拟持续被改写的对象
+ */
+class FlakyObjectStore : public Utility::Compression::ObjectStore {
+public:
+    std::map<std::string, std::vector<char>> objects;
+    int conflicts = 0;
+
+    bool Load(const std::string& key, std::vector<char>& data, uint64_t& version) override
+    {
+        auto it = objects.find(key);
+        if (it == objects.end()) {
+            return false;
+        }
+        data = it->second;
+        version = 1;
+        return true;
+    }
+
+    Utility::Compression::ReplaceResult Replace(const std::string& key, const std::vector<char>& data, uint64_t) override
+    {
+        if (conflicts > 0) {
+            conflicts--;
+            return Utility::Compression::ReplaceResult::Conflict;
+        }
+        objects[key] = data;
+        return Utility::Compression::ReplaceResult::Replaced;
+    }
+};
+
+/**
+ * @brief 替换冲突的对象退避后重新排队，超过重试次数后放弃并列出
+ */
+void testRecompressionRetry()
+{
+    namespace Compression = Utility::Compression;
+    SPDLOG_INFO("========== 重压缩冲突重试测试 ==========");
+
+    auto store = std::make_shared<FlakyObjectStore>();
+    std::vector<char> raw;
+    std::string line = "recompression retry test line with some repeated words words words\n";
+    for (int i = 0; i < 20000; i++) {
+        raw.insert(raw.end(), line.begin(), line.end());
+    }
+    store->objects["busy"] = Compression::Compress(raw, Compression::Algorithm::Zstd, -5);
+    store->objects["missing-later"] = store->objects["busy"];
+    store->conflicts = 2;
+
+    Compression::RecompressionOptions options;
+    options.targetLevel = 9;
+    options.ioBytesPerSecond = 0;
+    options.maxCpuShare = 1;
+    options.retryBackoffMillis = 10;
+    options.maxRetries = 2;
+    Compression::RecompressionScheduler scheduler(store, options);
+    scheduler.Track("busy", -5);
+
+    for (int i = 0; i < 50 && scheduler.GetStats().recompressed == 0; i++) {
+        scheduler.RunSlice();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    Compression::RecompressionStats stats = scheduler.GetStats();
+    check(stats.conflicts == 2 && stats.retries == 2 && stats.recompressed == 1 && stats.pending == 0,
+          "两次冲突后重新排队并最终完成重压缩");
+    check(Compression::DecompressAuto(store->objects["busy"]) == raw, "重压缩后的数据可以正确解压");
+
+    // 对象被删除：Load 连续失败，超过 maxRetries 后放弃并在统计中列出
+    store->objects.erase("missing-later");
+    scheduler.Track("missing-later", -5);
+    for (int i = 0; i < 50 && scheduler.GetStats().abandonedKeys.empty(); i++) {
+        scheduler.RunSlice();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    stats = scheduler.GetStats();
+    check(stats.abandonedKeys == std::vector<std::string>{"missing-later"} && stats.pending == 0,
+          "超过重试次数的对象被放弃并列在 abandonedKeys 中");
+}
+
+/**
+ * @brief 依次在同步写出、线程池和 io_uring 后端上运行文件测试
+ */
+void testUtilityFileCompression()
+{
+    char templ[] = "/tmp/zstd_test.XXXXXX";
+    if (mkdtemp(templ) == nullptr) {
+        check(false, "创建临时目录");
+        return;
+    }
+    const std::string dir = templ;
+
+    testFileRoundTrip(dir, "sync", nullptr);
+    for (auto backend : { Utility::AsyncIO::Backend::ThreadPool, Utility::AsyncIO::Backend::IoUring }) {
+        Utility::AsyncIO::Options options;
+        options.backend = backend;
+        Utility::AsyncIO::Engine engine(options);
+        const std::string label = backend == Utility::AsyncIO::Backend::IoUring ? "io_uring" : "thread_pool";
+        if (!engine.IsValid()) {
+            SPDLOG_WARN("{} 后端不可用（内核不支持或被禁用），跳过", label);
+            continue;
+        }
+        testFileRoundTrip(dir, label, &engine);
+        testRenameFailureCleanup(dir, &engine);
+        testAsyncSyncOrdering(dir, backend);
+        testSharedEngine(dir, &engine, label);
+    }
+    testRenameFailureCleanup(dir, nullptr);
+    testPrefixEarlyStop(dir);
+    testStatsCounters();
+    testRecompressionRetry();
+
+    rmdir(dir.c_str());
+}
+
 /**
  * @brief 显示 zstd 版本信息
  */
@@ -410,6 +849,7 @@ int main()
     testTextCompression();
     testLargeDataCompression();
     testDecompressWithoutOriginalSize();  // 测试未知原始大小的解压
+    testUtilityFileCompression();         // 测试 Utility 文件压缩、异步 I/O 与统计
     
     // 循环测试
     int count = 0;
@@ -429,7 +869,11 @@ int main()
     }
     
     SPDLOG_INFO("========== ZSTD 测试程序结束 ==========");
-    
+
+    if (failedChecks > 0) {
+        SPDLOG_ERROR("{} 项检查失败", failedChecks);
+        return 1;
+    }
     return 0;
 }
 